@@ -38,6 +38,7 @@
 #include "plinearform.hpp"
 #include "pbilinearform.hpp"
 #include "pnonlinearform.hpp"
+#include "ppointlocator.hpp"
 #endif
 
 #ifdef MFEM_USE_SIDRE
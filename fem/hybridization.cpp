@@ -581,6 +581,31 @@ void Hybridization::ComputeH()
    SparseMatrix *V = pC ? new SparseMatrix(Ct->Height(), Ct->Width()) : NULL;
 #endif
 
+   // Factor the A_ii blocks, compute the Schur complements of the A_bb blocks
+   // and factor them; both factorizations are batched over the elements with
+   // blocks of equal size
+   Array<int> i_sizes(NE), b_sizes(NE), offsets(NE), ipiv_offsets(NE);
+   for (int el = 0; el < NE; el++)
+   {
+      GetBDofs(el, i_sizes[el], b_dofs);
+      b_sizes[el] = b_dofs.Size();
+      offsets[el] = Af_offsets[el];
+      ipiv_offsets[el] = Af_f_offsets[el];
+   }
+   BatchLUFactor(i_sizes, offsets, Af_data, ipiv_offsets, Af_ipiv);
+   for (int el = 0; el < NE; el++)
+   {
+      const int i_size = i_sizes[el], b_size = b_sizes[el];
+      LUFactors LU_ii(Af_data + Af_offsets[el], Af_ipiv + Af_f_offsets[el]);
+      double *A_ib_data = LU_ii.data + i_size*i_size;
+      double *A_bi_data = A_ib_data + i_size*b_size;
+      double *A_bb_data = A_bi_data + i_size*b_size;
+      LU_ii.BlockFactor(i_size, b_size, A_ib_data, A_bi_data, A_bb_data);
+      offsets[el] = int(A_bb_data - Af_data);
+      ipiv_offsets[el] += i_size;
+   }
+   BatchLUFactor(b_sizes, offsets, Af_data, ipiv_offsets, Af_ipiv);
+
    c_dof_marker = -1;
    int c_mark_start = 0;
    for (int el = 0; el < NE; el++)
@@ -588,16 +613,7 @@ void Hybridization::ComputeH()
       int i_dofs_size;
       GetBDofs(el, i_dofs_size, b_dofs);
 
-      LUFactors LU_ii(Af_data + Af_offsets[el], Af_ipiv + Af_f_offsets[el]);
-      double *A_ib_data = LU_ii.data + i_dofs_size*i_dofs_size;
-      double *A_bi_data = A_ib_data + i_dofs_size*b_dofs.Size();
-      LUFactors LU_bb(A_bi_data + i_dofs_size*b_dofs.Size(),
-                      LU_ii.ipiv + i_dofs_size);
-
-      LU_ii.Factor(i_dofs_size);
-      LU_ii.BlockFactor(i_dofs_size, b_dofs.Size(),
-                        A_ib_data, A_bi_data, LU_bb.data);
-      LU_bb.Factor(b_dofs.Size());
+      LUFactors LU_bb(Af_data + offsets[el], Af_ipiv + ipiv_offsets[el]);
 
       // Extract Cb_t from Ct, define c_dofs
       c_dofs.SetSize(0);
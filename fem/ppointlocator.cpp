@@ -0,0 +1,312 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include "ppointlocator.hpp"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace mfem
+{
+
+ParPointLocator::ParPointLocator(ParMesh &pm, int max_rank_boxes)
+   : pmesh(&pm), comm(pm.GetComm()), nranks(pm.GetNRanks()),
+     myrank(pm.GetMyRank()), sdim(pm.SpaceDimension()),
+     max_boxes(max_rank_boxes), npts(0)
+{
+   Setup();
+}
+
+void ParPointLocator::Setup()
+{
+   const int bs = 2*sdim;
+
+   // gather the coarse boxes of all ranks, padding with empty boxes
+   Vector my_boxes;
+   pmesh->GetElementBVH().GetCoarseBoxes(max_boxes, my_boxes);
+   const int nb = my_boxes.Size()/bs;
+   const double big = std::numeric_limits<double>::max();
+   Vector send_boxes(bs*max_boxes);
+   for (int j = 0; j < max_boxes; j++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         const int lo = bs*j + d, hi = lo + sdim;
+         send_boxes(lo) = (j < nb) ? my_boxes(lo) : big;
+         send_boxes(hi) = (j < nb) ? my_boxes(hi) : -big;
+      }
+   }
+   rank_boxes.SetSize(bs*max_boxes*nranks);
+   MPI_Allgather(send_boxes.GetData(), bs*max_boxes, MPI_DOUBLE,
+                 rank_boxes.GetData(), bs*max_boxes, MPI_DOUBLE, comm);
+
+   // bin the non-empty boxes in a uniform grid with about as many cells as
+   // there are boxes
+   const int total = max_boxes*nranks;
+   int num_boxes = 0;
+   for (int d = 0; d < 3; d++)
+   {
+      grid_min[d] = 0.0;
+      grid_h[d] = 1.0;
+      grid_n[d] = 1;
+   }
+   double grid_max[3];
+   for (int d = 0; d < sdim; d++) { grid_min[d] = big; grid_max[d] = -big; }
+   for (int g = 0; g < total; g++)
+   {
+      const double *box = rank_boxes.GetData() + bs*g;
+      if (box[0] > box[sdim]) { continue; }
+      num_boxes++;
+      for (int d = 0; d < sdim; d++)
+      {
+         grid_min[d] = std::min(grid_min[d], box[d]);
+         grid_max[d] = std::max(grid_max[d], box[sdim+d]);
+      }
+   }
+   cell_I.SetSize(2);
+   cell_I = 0;
+   cell_boxes.SetSize(0);
+   if (num_boxes == 0) { return; }
+
+   const int n = std::max(1, int(std::pow(double(num_boxes), 1.0/sdim)));
+   int num_cells = 1;
+   for (int d = 0; d < sdim; d++)
+   {
+      grid_n[d] = n;
+      grid_h[d] = std::max((grid_max[d] - grid_min[d])/n,
+                           std::numeric_limits<double>::min());
+      num_cells *= n;
+   }
+
+   // two passes: count the boxes of each cell, then fill the cells
+   cell_I.SetSize(num_cells+1);
+   cell_I = 0;
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int g = 0; g < total; g++)
+      {
+         const double *box = rank_boxes.GetData() + bs*g;
+         if (box[0] > box[sdim]) { continue; }
+         int lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+         for (int d = 0; d < sdim; d++)
+         {
+            // clamp before the conversion to int, which is undefined for
+            // values out of its range
+            const double cmax = grid_n[d] - 1.0;
+            const double l = (box[d] - grid_min[d])/grid_h[d];
+            const double h = (box[sdim+d] - grid_min[d])/grid_h[d];
+            lo[d] = int(std::min(std::max(l, 0.0), cmax));
+            hi[d] = int(std::min(std::max(h, 0.0), cmax));
+         }
+         for (int k = lo[2]; k <= hi[2]; k++)
+         {
+            for (int j = lo[1]; j <= hi[1]; j++)
+            {
+               for (int i = lo[0]; i <= hi[0]; i++)
+               {
+                  const int c = i + grid_n[0]*(j + grid_n[1]*k);
+                  if (pass == 0) { cell_I[c+1]++; }
+                  else { cell_boxes[cell_I[c]++] = g; }
+               }
+            }
+         }
+      }
+      if (pass == 0)
+      {
+         cell_I.PartialSum();
+         cell_boxes.SetSize(cell_I[num_cells]);
+      }
+      else
+      {
+         for (int c = num_cells; c > 0; c--) { cell_I[c] = cell_I[c-1]; }
+         cell_I[0] = 0;
+      }
+   }
+}
+
+void ParPointLocator::FindRanks(const double *x, Array<int> &ranks) const
+{
+   const int bs = 2*sdim;
+   int c = 0;
+   for (int d = sdim-1; d >= 0; d--)
+   {
+      // check the range before the conversion to int, which is undefined for
+      // values out of its range; this also rejects NaN coordinates
+      const double t = std::floor((x[d] - grid_min[d])/grid_h[d]);
+      if (!(t >= 0.0 && t <= grid_n[d])) { return; }
+      // points on the upper boundary of the grid belong to the last cell
+      c = c*grid_n[d] + std::min(int(t), grid_n[d]-1);
+   }
+   // the boxes of a cell are sorted by rank
+   for (int j = cell_I[c]; j < cell_I[c+1]; j++)
+   {
+      const int g = cell_boxes[j], r = g/max_boxes;
+      if (ranks.Size() && ranks.Last() == r) { continue; }
+      const double *box = rank_boxes.GetData() + bs*g;
+      bool inside = true;
+      for (int d = 0; d < sdim; d++)
+      {
+         if (x[d] < box[d] || x[d] > box[sdim+d]) { inside = false; break; }
+      }
+      if (inside) { ranks.Append(r); }
+   }
+}
+
+int ParPointLocator::FindPoints(const DenseMatrix &point_mat)
+{
+   npts = point_mat.Width();
+   MFEM_VERIFY(npts == 0 || point_mat.Height() == sdim,
+               "invalid points matrix");
+   const double *pts = point_mat.Data();
+
+   // send each point to the ranks with a coarse box containing it
+   send_I.SetSize(nranks+1);
+   send_I = 0;
+   Array<int> ranks;
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int k = 0; k < npts; k++)
+      {
+         ranks.SetSize(0);
+         FindRanks(pts + sdim*k, ranks);
+         for (int i = 0; i < ranks.Size(); i++)
+         {
+            if (pass == 0) { send_I[ranks[i]+1]++; }
+            else { send_pts[send_I[ranks[i]]++] = k; }
+         }
+      }
+      if (pass == 0)
+      {
+         send_I.PartialSum();
+         send_pts.SetSize(send_I[nranks]);
+      }
+      else
+      {
+         for (int r = nranks; r > 0; r--) { send_I[r] = send_I[r-1]; }
+         send_I[0] = 0;
+      }
+   }
+   const int nsend = send_I[nranks];
+
+   Array<int> send_cnt(nranks), recv_cnt(nranks);
+   for (int r = 0; r < nranks; r++) { send_cnt[r] = send_I[r+1] - send_I[r]; }
+   MPI_Alltoall(send_cnt.GetData(), 1, MPI_INT, recv_cnt.GetData(), 1, MPI_INT,
+                comm);
+   recv_I.SetSize(nranks+1);
+   recv_I[0] = 0;
+   for (int r = 0; r < nranks; r++) { recv_I[r+1] = recv_I[r] + recv_cnt[r]; }
+   const int nrecv = recv_I[nranks];
+
+   // exchange the coordinates
+   Vector send_coords(sdim*nsend), recv_coords(sdim*nrecv);
+   for (int j = 0; j < nsend; j++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         send_coords(sdim*j + d) = pts[sdim*send_pts[j] + d];
+      }
+   }
+   Array<int> scnt(nranks), sdsp(nranks), rcnt(nranks), rdsp(nranks);
+   for (int r = 0; r < nranks; r++)
+   {
+      scnt[r] = sdim*send_cnt[r];  sdsp[r] = sdim*send_I[r];
+      rcnt[r] = sdim*recv_cnt[r];  rdsp[r] = sdim*recv_I[r];
+   }
+   MPI_Alltoallv(send_coords.GetData(), scnt.GetData(), sdsp.GetData(),
+                 MPI_DOUBLE, recv_coords.GetData(), rcnt.GetData(),
+                 rdsp.GetData(), MPI_DOUBLE, comm);
+
+   // locate the received points in the local mesh
+   recv_elem.SetSize(nrecv);
+   recv_ips.SetSize(nrecv);
+   recv_elem = -1;
+   if (nrecv > 0)
+   {
+      DenseMatrix recv_mat(recv_coords.GetData(), sdim, nrecv);
+      pmesh->Mesh::FindPoints(recv_mat, recv_elem, recv_ips, false);
+   }
+
+   // return the results and assign each point to the lowest rank which
+   // found it
+   Array<int> recv_found(nrecv), send_found(nsend);
+   for (int j = 0; j < nrecv; j++) { recv_found[j] = (recv_elem[j] >= 0); }
+   MPI_Alltoallv(recv_found.GetData(), recv_cnt.GetData(), recv_I.GetData(),
+                 MPI_INT, send_found.GetData(), send_cnt.GetData(),
+                 send_I.GetData(), MPI_INT, comm);
+
+   point_rank.SetSize(npts);
+   point_slot.SetSize(npts);
+   point_rank = -1;
+   point_slot = -1;
+   int pts_found = 0;
+   for (int r = 0; r < nranks; r++)
+   {
+      for (int j = send_I[r]; j < send_I[r+1]; j++)
+      {
+         const int k = send_pts[j];
+         if (send_found[j] && point_rank[k] < 0)
+         {
+            point_rank[k] = r;
+            point_slot[k] = j;
+            pts_found++;
+         }
+      }
+   }
+   return pts_found;
+}
+
+void ParPointLocator::Interpolate(const ParGridFunction &gf,
+                                  Vector &vals) const
+{
+   MFEM_VERIFY(gf.ParFESpace()->GetParMesh() == pmesh,
+               "the ParGridFunction is not defined on the mesh of the locator");
+   const int vdim = gf.VectorDim();
+   const int nrecv = recv_I[nranks], nsend = send_I[nranks];
+
+   // evaluate at the received points found in the local mesh
+   Vector recv_vals(vdim*nrecv), send_vals(vdim*nsend), val;
+   recv_vals = 0.0;
+   for (int j = 0; j < nrecv; j++)
+   {
+      if (recv_elem[j] < 0) { continue; }
+      val.SetDataAndSize(recv_vals.GetData() + vdim*j, vdim);
+      gf.GetVectorValue(recv_elem[j], recv_ips[j], val);
+   }
+
+   Array<int> scnt(nranks), sdsp(nranks), rcnt(nranks), rdsp(nranks);
+   for (int r = 0; r < nranks; r++)
+   {
+      scnt[r] = vdim*(recv_I[r+1] - recv_I[r]);  sdsp[r] = vdim*recv_I[r];
+      rcnt[r] = vdim*(send_I[r+1] - send_I[r]);  rdsp[r] = vdim*send_I[r];
+   }
+   MPI_Alltoallv(recv_vals.GetData(), scnt.GetData(), sdsp.GetData(),
+                 MPI_DOUBLE, send_vals.GetData(), rcnt.GetData(),
+                 rdsp.GetData(), MPI_DOUBLE, comm);
+
+   vals.SetSize(vdim*npts);
+   vals = 0.0;
+   for (int k = 0; k < npts; k++)
+   {
+      if (point_rank[k] < 0) { continue; }
+      for (int d = 0; d < vdim; d++)
+      {
+         vals(vdim*k + d) = send_vals(vdim*point_slot[k] + d);
+      }
+   }
+}
+
+}
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,107 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_PPOINTLOCATOR
+#define MFEM_PPOINTLOCATOR
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include "../mesh/pmesh.hpp"
+#include "pgridfunc.hpp"
+
+namespace mfem
+{
+
+/** @brief Distributed location of points in a ParMesh and interpolation of
+    ParGridFunction%s at these points. */
+/** Unlike ParMesh::FindPoints(), which requires the same points on all ranks,
+    each rank gives its own set of query points, and no rank needs the whole
+    mesh or all points.
+
+    Setup() gathers on all ranks a coarse map of the mesh: a few bounding boxes
+    per rank, taken from the top levels of the local ElementBVH, binned in a
+    uniform grid. FindPoints() sends each query point to the ranks with a box
+    containing it, which locate it in their local meshes with
+    Mesh::FindPoints(). The point is assigned to the lowest rank which found
+    it. Interpolate() evaluates a ParGridFunction at the located points on the
+    ranks which found them and returns the values to the ranks which own the
+    query points, with a single all-to-all exchange.
+
+    The coarse map is reused by all calls to FindPoints(), and the result of
+    FindPoints() is reused by all calls to Interpolate(), e.g. for several
+    fields or time steps. Setup() must be called again after the mesh is
+    modified, e.g. when its nodes move. All methods are collective. */
+class ParPointLocator
+{
+protected:
+   ParMesh *pmesh;
+   MPI_Comm comm;
+   int nranks, myrank, sdim;
+   int max_boxes;
+
+   /** The coarse boxes of rank r are the boxes r*max_boxes ... (r+1)*max_boxes
+       - 1 in #rank_boxes (min and max coordinates, 2*sdim each); unused boxes
+       are empty. */
+   Vector rank_boxes;
+   /// Uniform grid over the bounding box of the mesh: origin, cell size.
+   double grid_min[3], grid_h[3];
+   int grid_n[3];
+   /// The boxes intersecting cell c are cell_boxes[cell_I[c] ... ].
+   Array<int> cell_I, cell_boxes;
+
+   /// Number of local query points in the last call to FindPoints().
+   int npts;
+   /** The local points sent to rank r are send_pts[send_I[r] ...
+       send_I[r+1]-1]. */
+   Array<int> send_I, send_pts;
+   /// The points received from rank r are recv_I[r] ... recv_I[r+1]-1.
+   Array<int> recv_I;
+   /// Local element (-1 if not found) and reference point of received points.
+   Array<int> recv_elem;
+   Array<IntegrationPoint> recv_ips;
+   /** For each local point: the rank which owns it (-1 if not found) and the
+       index of the point in #send_pts for that rank. */
+   Array<int> point_rank, point_slot;
+
+   /// Append to @a ranks the ranks with a coarse box containing @a x.
+   void FindRanks(const double *x, Array<int> &ranks) const;
+
+public:
+   /** @brief Create a locator for @a pm, using at most @a max_rank_boxes
+       bounding boxes per rank in the coarse map, and call Setup(). */
+   ParPointLocator(ParMesh &pm, int max_rank_boxes = 32);
+
+   /// Compute the coarse map of the mesh, e.g. after the mesh nodes move.
+   void Setup();
+
+   /** @brief Locate the local query points, given by the columns of
+       @a point_mat. */
+   /** @returns The number of local points which were found on some rank. */
+   int FindPoints(const DenseMatrix &point_mat);
+
+   /** @brief Interpolate @a gf, defined on the mesh of the locator, at the
+       points given to the last call to FindPoints(). */
+   /** The values for point k are vals(k*vdim ... (k+1)*vdim-1), where vdim is
+       gf.VectorDim(). The values for points which were not found are 0. */
+   void Interpolate(const ParGridFunction &gf, Vector &vals) const;
+
+   /** @brief Return the rank which found each local query point, or -1 for
+       points which were not found. */
+   const Array<int> &GetPointRanks() const { return point_rank; }
+};
+
+}
+
+#endif // MFEM_USE_MPI
+
+#endif
@@ -149,6 +149,7 @@ void StaticCondensation::Init(bool symmetric, bool block_diagonal)
    }
    A_data = new double[A_offsets[NE]];
    A_ipiv = new int[A_ipiv_offsets[NE]];
+   A_pending.SetSize(0);
    const int nedofs = tr_fes->GetVSize();
    if (fes->GetVDim() == 1)
    {
@@ -195,10 +196,10 @@ void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
    const int nved = rvdofs.Size();
    DenseMatrix A_pp(A_data + A_offsets[el], nvpd, nvpd);
    DenseMatrix A_pe(A_pp.Data() + nvpd*nvpd, nvpd, nved);
-   DenseMatrix A_ep;
+   DenseMatrix &A_ep = A_ep_tmp, &A_ee = A_ee_tmp;
    if (symm) { A_ep.SetSize(nved, nvpd); }
-   else      { A_ep.UseExternalData(A_pe.Data() + nvpd*nved, nved, nvpd); }
-   DenseMatrix A_ee(nved, nved);
+   else { A_ep.Reset(A_pe.Data() + nvpd*nved, nved, nvpd); }
+   A_ee.SetSize(nved, nved);
 
    const int npd = nvpd/vdim;
    const int ned = nved/vdim;
@@ -214,14 +215,50 @@ void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
          A_ee.CopyMN(elmat, ned, ned, i*nd,     j*nd,     i*ned, j*ned);
       }
    }
-   // Compute the Schur complement
-   LUFactors lu(A_pp.Data(), A_ipiv + A_ipiv_offsets[el]);
-   lu.Factor(nvpd);
-   lu.BlockFactor(nvpd, nved, A_pe.Data(), A_ep.Data(), A_ee.Data());
-
-   // Assemble the Schur complement
+   // Assemble the A_ee part of the Schur complement; the rest is added by
+   // FactorBlocks(), after the batched factorization of the A_pp blocks
    const int skip_zeros = 0;
    S->AddSubMatrix(rvdofs, rvdofs, A_ee, skip_zeros);
+   A_pending.Append(el);
+}
+
+void StaticCondensation::FactorBlocks()
+{
+   const int num = A_pending.Size();
+   if (num == 0) { return; }
+
+   Array<int> sizes(num), offsets(num), ipiv_offsets(num);
+   for (int k = 0; k < num; k++)
+   {
+      const int el = A_pending[k];
+      sizes[k] = elem_pdof.RowSize(el);
+      offsets[k] = A_offsets[el];
+      ipiv_offsets[k] = A_ipiv_offsets[el];
+   }
+   BatchLUFactor(sizes, offsets, A_data, ipiv_offsets, A_ipiv);
+
+   // Compute and assemble the rest of the Schur complement
+   Array<int> rvdofs;
+   DenseMatrix A_pe, &A_ep = A_ep_tmp, &A_ee = A_ee_tmp;
+   const int skip_zeros = 0;
+   for (int k = 0; k < num; k++)
+   {
+      const int el = A_pending[k];
+      tr_fes->GetElementVDofs(el, rvdofs);
+      const int nvpd = sizes[k];
+      const int nved = rvdofs.Size();
+      A_pe.UseExternalData(A_data + A_offsets[el] + nvpd*nvpd, nvpd, nved);
+      if (symm) { A_ep.Transpose(A_pe); }
+      else { A_ep.Reset(A_pe.Data() + nvpd*nved, nved, nvpd); }
+      A_ee.SetSize(nved, nved);
+      A_ee = 0.0;
+
+      LUFactors lu(A_data + A_offsets[el], A_ipiv + A_ipiv_offsets[el]);
+      lu.BlockFactor(nvpd, nved, A_pe.Data(), A_ep.Data(), A_ee.Data());
+      S->AddSubMatrix(rvdofs, rvdofs, A_ee, skip_zeros);
+   }
+   A_pe.ClearExternalData();
+   A_pending.SetSize(0);
 }
 
 void StaticCondensation::AssembleBdrMatrix(int el, const DenseMatrix &elmat)
@@ -234,6 +271,8 @@ void StaticCondensation::AssembleBdrMatrix(int el, const DenseMatrix &elmat)
 
 void StaticCondensation::Finalize()
 {
+   FactorBlocks();
+
    const int skip_zeros = 0;
    if (!Parallel())
    {
@@ -313,6 +352,7 @@ void StaticCondensation::ReduceRHS(const Vector &b, Vector &sc_b) const
    // sc_b = b_e - A_ep A_pp_inv b_p
 
    MFEM_ASSERT(b.Size() == fes->GetVSize(), "'b' has incorrect size");
+   MFEM_ASSERT(A_pending.Size() == 0, "call Finalize() first");
 
    const int NE = fes->GetNE();
    const int nedofs = tr_fes->GetVSize();
@@ -481,6 +521,7 @@ void StaticCondensation::ComputeSolution(
    // sol_p = A_pp_inv (b_p - A_pe sc_sol)
 
    MFEM_ASSERT(b.Size() == fes->GetVSize(), "'b' has incorrect size");
+   MFEM_ASSERT(A_pending.Size() == 0, "call Finalize() first");
 
    const int nedofs = tr_fes->GetVSize();
    Vector sol_r;
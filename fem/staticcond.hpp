@@ -84,6 +84,16 @@ class StaticCondensation
    Array<int> A_offsets, A_ipiv_offsets;
    double *A_data;
    int *A_ipiv;
+   // Work matrices for the exposed blocks, reused across elements to avoid an
+   // allocation per element.
+   DenseMatrix A_ep_tmp, A_ee_tmp;
+   // Elements assembled since the last factorization of the A_pp blocks. The
+   // blocks are factored in batches of equal size by FactorBlocks().
+   Array<int> A_pending;
+
+   /** Factor the A_pp blocks of the elements in A_pending and add their
+       contributions -A_ep (A_pp)^{-1} A_pe to the Schur complement. */
+   void FactorBlocks();
 
    Array<int> ess_rtdof_list;
 
@@ -114,14 +124,16 @@ public:
 #endif
    /** Assemble the contribution to the Schur complement from the given
        element matrix 'elmat'; save the other blocks internally: A_pp_inv, A_pe,
-       and A_ep. */
+       and A_ep. The A_pp blocks of all elements are factored in Finalize(),
+       in batches of equal size (see BatchLUFactor()). */
    void AssembleMatrix(int el, const DenseMatrix &elmat);
 
    /** Assemble the contribution to the Schur complement from the given boundary
        element matrix 'elmat'. */
    void AssembleBdrMatrix(int el, const DenseMatrix &elmat);
 
-   /// Finalize the construction of the Schur complement matrix.
+   /** Factor the A_pp blocks and finalize the construction of the Schur
+       complement matrix. */
    void Finalize();
 
    /// Determine and save internally essential reduced true dofs.
@@ -465,6 +465,10 @@ public:
 
    void Swap(BlockArray<T> &other);
 
+   /** @brief Destroy the items with indices >= @a new_size and release the
+       blocks that are no longer used. */
+   void Truncate(int new_size);
+
    long MemoryUsage() const;
 
 protected:
@@ -990,6 +994,23 @@ void BlockArray<T>::Swap(BlockArray<T> &other)
    std::swap(mask, other.mask);
 }
 
+template<typename T>
+void BlockArray<T>::Truncate(int new_size)
+{
+   MFEM_ASSERT(new_size >= 0 && new_size <= size, "invalid size " << new_size);
+   for (int i = new_size; i < size; i++)
+   {
+      At(i).~T();
+   }
+   int num_blocks = (new_size + mask) >> shift;
+   for (int i = num_blocks; i < blocks.Size(); i++)
+   {
+      delete [] (char*) blocks[i];
+   }
+   blocks.SetSize(num_blocks);
+   size = new_size;
+}
+
 template<typename T>
 long BlockArray<T>::MemoryUsage() const
 {
@@ -20,6 +20,7 @@
 #include "device.hpp"
 #include "mem_manager.hpp"
 #include "../linalg/dtensor.hpp"
+#include <cmath>
 
 #ifdef MFEM_USE_RAJA
 #include "RAJA/RAJA.hpp"
@@ -66,6 +67,39 @@ const int MAX_Q1D = 16;
                  [=] MFEM_DEVICE (int i) {__VA_ARGS__},  \
                  [&]             (int i) {__VA_ARGS__})
 
+// The MFEM_FORALL reduction wrapper: combines the values returned by the body
+// for i = 0..N-1 using the reduction operation OP, which is one of Sum, Max or
+// Min, and returns the result to the host. As with MFEM_FORALL_SWITCH, the
+// basic CPU backend is used when use_dev is false. Example:
+//    double dot = MFEM_FORALL_REDUCE(use_dev, Sum, i, N, return x[i]*y[i];);
+#define MFEM_FORALL_REDUCE(use_dev,OP,i,N,...)                       \
+   ForallReduce<OP##Reducer>(use_dev,N,                              \
+                 [=] MFEM_DEVICE (int i) -> double {__VA_ARGS__},    \
+                 [&]             (int i) -> double {__VA_ARGS__})
+
+
+/// Reduction operations used by MFEM_FORALL_REDUCE.
+struct SumReducer
+{
+   MFEM_HOST_DEVICE static inline double Init() { return 0.0; }
+   MFEM_HOST_DEVICE static inline void Join(double &a, const double b)
+   { a += b; }
+};
+
+struct MaxReducer
+{
+   MFEM_HOST_DEVICE static inline double Init() { return -HUGE_VAL; }
+   MFEM_HOST_DEVICE static inline void Join(double &a, const double b)
+   { a = (b > a) ? b : a; }
+};
+
+struct MinReducer
+{
+   MFEM_HOST_DEVICE static inline double Init() { return HUGE_VAL; }
+   MFEM_HOST_DEVICE static inline void Join(double &a, const double b)
+   { a = (b < a) ? b : a; }
+};
+
 
 /// OpenMP backend
 template <typename HBODY>
@@ -82,6 +116,53 @@ void OmpWrap(const int N, HBODY &&h_body)
 #endif
 }
 
+/// OpenMP reduction backend
+template <typename REDUCER, typename HBODY>
+double OmpReduce(const int N, HBODY &&h_body)
+{
+   double res = REDUCER::Init();
+#if defined(MFEM_USE_OPENMP) || defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel
+   {
+      double t_res = REDUCER::Init();
+      #pragma omp for nowait
+      for (int k = 0; k < N; k++)
+      {
+         REDUCER::Join(t_res, h_body(k));
+      }
+      #pragma omp critical
+      REDUCER::Join(res, t_res);
+   }
+#else
+   MFEM_ABORT("OpenMP requested for MFEM but OpenMP is not enabled!");
+#endif
+   return res;
+}
+
+/** @brief Return a host/device buffer for the partial results of the device
+    reductions with at least @a n entries. */
+inline Memory<double> &ForallReduceBuffer(const int n)
+{
+   // Zero-initialized, i.e. empty, static object.
+   static Memory<double> buf;
+   if (buf.Capacity() < n)
+   {
+      buf.Delete();
+      buf.New(n, Device::GetMemoryType());
+   }
+   return buf;
+}
+
+/// Combine the @a n partial results in @a buf on the host.
+template <typename REDUCER>
+double ForallReduceFinish(Memory<double> &buf, const int n)
+{
+   const double *h_buf = buf.Read(MemoryClass::HOST, n);
+   double res = REDUCER::Init();
+   for (int k = 0; k < n; k++) { REDUCER::Join(res, h_buf[k]); }
+   return res;
+}
+
 
 /// RAJA Cuda backend
 #if defined(MFEM_USE_RAJA) && defined(RAJA_ENABLE_CUDA)
@@ -250,6 +331,42 @@ void CuWrap3D(const int N, DBODY &&d_body,
    MFEM_GPU_CHECK(cudaGetLastError());
 }
 
+// Each block reduces a grid-stride range of the N values into one partial
+// result; the partial results are combined on the host.
+template <typename REDUCER, typename BODY> __global__ static
+void CuReduceKernel(const int N, BODY body, double *partial)
+{
+   __shared__ double s_res[MFEM_CUDA_BLOCKS];
+   const int tid = threadIdx.x;
+   double res = REDUCER::Init();
+   for (int k = blockIdx.x*blockDim.x + tid; k < N; k += blockDim.x*gridDim.x)
+   {
+      REDUCER::Join(res, body(k));
+   }
+   s_res[tid] = res;
+   for (int workers = blockDim.x>>1; workers > 0; workers >>= 1)
+   {
+      __syncthreads();
+      if (tid < workers) { REDUCER::Join(s_res[tid], s_res[tid + workers]); }
+   }
+   if (tid == 0) { partial[blockIdx.x] = s_res[0]; }
+}
+
+template <typename REDUCER, typename DBODY>
+double CuReduce(const int N, DBODY &&d_body)
+{
+   if (N==0) { return REDUCER::Init(); }
+   const int BLCK = MFEM_CUDA_BLOCKS;
+   const int MAX_GRID = 1024;
+   const int NB = (N+BLCK-1)/BLCK;
+   const int GRID = (NB < MAX_GRID) ? NB : MAX_GRID;
+   Memory<double> &buf = ForallReduceBuffer(GRID);
+   double *d_buf = buf.Write(MemoryClass::CUDA, GRID);
+   CuReduceKernel<REDUCER><<<GRID,BLCK>>>(N, d_body, d_buf);
+   MFEM_GPU_CHECK(cudaGetLastError());
+   return ForallReduceFinish<REDUCER>(buf, GRID);
+}
+
 #endif // MFEM_USE_CUDA
 
 
@@ -311,6 +428,41 @@ void HipWrap3D(const int N, DBODY &&d_body,
    MFEM_GPU_CHECK(hipGetLastError());
 }
 
+template <typename REDUCER, typename BODY> __global__ static
+void HipReduceKernel(const int N, BODY body, double *partial)
+{
+   __shared__ double s_res[MFEM_HIP_BLOCKS];
+   const int tid = hipThreadIdx_x;
+   double res = REDUCER::Init();
+   for (int k = hipBlockIdx_x*hipBlockDim_x + tid; k < N;
+        k += hipBlockDim_x*hipGridDim_x)
+   {
+      REDUCER::Join(res, body(k));
+   }
+   s_res[tid] = res;
+   for (int workers = hipBlockDim_x>>1; workers > 0; workers >>= 1)
+   {
+      __syncthreads();
+      if (tid < workers) { REDUCER::Join(s_res[tid], s_res[tid + workers]); }
+   }
+   if (tid == 0) { partial[hipBlockIdx_x] = s_res[0]; }
+}
+
+template <typename REDUCER, typename DBODY>
+double HipReduce(const int N, DBODY &&d_body)
+{
+   if (N==0) { return REDUCER::Init(); }
+   const int BLCK = MFEM_HIP_BLOCKS;
+   const int MAX_GRID = 1024;
+   const int NB = (N+BLCK-1)/BLCK;
+   const int GRID = (NB < MAX_GRID) ? NB : MAX_GRID;
+   Memory<double> &buf = ForallReduceBuffer(GRID);
+   double *d_buf = buf.Write(Device::GetMemoryClass(), GRID);
+   hipLaunchKernelGGL(HipReduceKernel<REDUCER>,GRID,BLCK,0,0,N,d_body,d_buf);
+   MFEM_GPU_CHECK(hipGetLastError());
+   return ForallReduceFinish<REDUCER>(buf, GRID);
+}
+
 #endif // MFEM_USE_HIP
 
 
@@ -388,6 +540,42 @@ backend_cpu:
    for (int k = 0; k < N; k++) { h_body(k); }
 }
 
+
+/// The forall reduction body wrapper, see MFEM_FORALL_REDUCE.
+template <typename REDUCER, typename DBODY, typename HBODY>
+inline double ForallReduce(const bool use_dev, const int N,
+                           DBODY &&d_body, HBODY &&h_body)
+{
+   if (!use_dev) { goto reduce_cpu; }
+
+#ifdef MFEM_USE_CUDA
+   // Handle all allowed CUDA backends
+   if (Device::Allows(Backend::CUDA_MASK))
+   { return CuReduce<REDUCER>(N, d_body); }
+#endif
+
+#ifdef MFEM_USE_HIP
+   // Handle all allowed HIP backends
+   if (Device::Allows(Backend::HIP_MASK))
+   { return HipReduce<REDUCER>(N, d_body); }
+#endif
+
+#ifdef MFEM_USE_OPENMP
+   // Handle all allowed OpenMP backends
+   if (Device::Allows(Backend::OMP_MASK))
+   { return OmpReduce<REDUCER>(N, h_body); }
+#endif
+
+reduce_cpu:
+#ifdef MFEM_USE_LEGACY_OPENMP
+   return OmpReduce<REDUCER>(N, h_body);
+#else
+   double res = REDUCER::Init();
+   for (int k = 0; k < N; k++) { REDUCER::Join(res, h_body(k)); }
+   return res;
+#endif
+}
+
 } // namespace mfem
 
 #endif // MFEM_FORALL_HPP
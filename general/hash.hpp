@@ -25,7 +25,7 @@ namespace mfem
 struct Hashed2
 {
    int p1, p2;
-   int next;
+   int next; // -2 marks an unused item, see HashTable::IdExists()
 };
 
 /** A concept for items that should be used in HashTable and be accessible by
@@ -34,7 +34,7 @@ struct Hashed2
 struct Hashed4
 {
    int p1, p2, p3; // NOTE: p4 is neither hashed nor stored
-   int next;
+   int next; // -2 marks an unused item, see HashTable::IdExists()
 };
 
 
@@ -65,6 +65,13 @@ struct Hashed4
  *
  *  All items in the container can also be accessed sequentially using the
  *  provided iterator.
+ *
+ *  The items are stored in a BlockArray, so their IDs and addresses never
+ *  change. The index is a separate open-addressing table of (ID, hash) slots
+ *  with linear probing and Robin Hood insertion: a lookup reads a few
+ *  consecutive slots and only touches the items whose full hash matches,
+ *  typically just the one it is looking for. Deletion shifts the following
+ *  slots back, so no tombstones are left behind.
  */
 template<typename T>
 class HashTable : public BlockArray<T>
@@ -117,6 +124,20 @@ public:
    void Reparent(int id, int new_p1, int new_p2);
    void Reparent(int id, int new_p1, int new_p2, int new_p3, int new_p4);
 
+   /** @brief Return in @a new_ids the ids that the items will have after
+       Compact(): the number of used ids lower than their current id. Unused
+       ids are mapped to -1. */
+   void GetCompactIds(Array<int> &new_ids) const;
+
+   /** @brief Remove the unused ids: renumber the items so that their ids are
+       0 ... Size()-1, keeping their order, and release the memory of the
+       unused items and of the unneeded part of the index. */
+   /** The parent ids p1, p2, ... of each item are replaced by
+       @a parent_map[p1], @a parent_map[p2], ... The map must be increasing on
+       the parents in use, so that the parents stay sorted. If the parents are
+       ids of this table, the map should be the one given by GetCompactIds(). */
+   void Compact(const Array<int> &parent_map);
+
    /// Return total size of allocated memory (tables plus items), in bytes.
    long MemoryUsage() const;
 
@@ -169,29 +190,59 @@ public:
    const_iterator cend() const { return const_iterator(); }
 
 protected:
-   int* table;
-   int mask;
+   /// A slot of the index: the item id (-1 if empty) and its full hash.
+   struct Slot
+   {
+      int id;
+      unsigned hash;
+   };
+
+   Slot* table;
+   unsigned mask;
    Array<int> unused;
 
-   // hash functions (NOTE: the constants are arbitrary)
-   inline int Hash(int p1, int p2) const
-   { return (984120265*p1 + 125965121*p2) & mask; }
+   // hash functions (NOTE: the constants are arbitrary); the final mixing
+   // spreads the keys over all bits, which linear probing relies on
+   static inline unsigned Mix(unsigned h)
+   {
+      h ^= h >> 16; h *= 0x85ebca6bu;
+      h ^= h >> 13; h *= 0xc2b2ae35u;
+      return h ^ (h >> 16);
+   }
+
+   inline unsigned Hash(int p1, int p2) const
+   { return Mix(984120265u*p1 + 125965121u*p2); }
 
-   inline int Hash(int p1, int p2, int p3) const
-   { return (984120265*p1 + 125965121*p2 + 495698413*p3) & mask; }
+   inline unsigned Hash(int p1, int p2, int p3) const
+   { return Mix(984120265u*p1 + 125965121u*p2 + 495698413u*p3); }
 
    // Delete() and Reparent() use one of these:
-   inline int Hash(const Hashed2& item) const
+   inline unsigned Hash(const Hashed2& item) const
    { return Hash(item.p1, item.p2); }
 
-   inline int Hash(const Hashed4& item) const
+   inline unsigned Hash(const Hashed4& item) const
    { return Hash(item.p1, item.p2, item.p3); }
 
-   int SearchList(int id, int p1, int p2) const;
-   int SearchList(int id, int p1, int p2, int p3) const;
+   // Compact() uses one of these:
+   static inline void RemapParents(Hashed2& item, const Array<int> &map)
+   { item.p1 = map[item.p1]; item.p2 = map[item.p2]; }
+   static inline void RemapParents(Hashed4& item, const Array<int> &map)
+   { item.p1 = map[item.p1]; item.p2 = map[item.p2]; item.p3 = map[item.p3]; }
+
+   /// Probe distance of a slot at position @a idx from its home position.
+   inline unsigned Distance(unsigned idx, const Slot &slot) const
+   { return (idx - slot.hash) & mask; }
+
+   int Search(unsigned hash, int p1, int p2) const;
+   int Search(unsigned hash, int p1, int p2, int p3) const;
+
+   /// Return an unused id or a new one for an item with the given hash.
+   int NewId(unsigned hash);
 
-   inline void Insert(int idx, int id, T &item);
-   void Unlink(int idx, int id);
+   /// Insert an id into the index (it must not be there already).
+   void Insert(int id, unsigned hash);
+   /// Remove an id from the index.
+   void Unlink(int id, unsigned hash);
 
    /// Check table load factor and resize if necessary
    inline void CheckRehash();
@@ -208,8 +259,8 @@ HashTable<T>::HashTable(int block_size, int init_hash_size)
    mask = init_hash_size-1;
    MFEM_VERIFY(!(init_hash_size & mask), "init_size must be a power of two.");
 
-   table = new int[init_hash_size];
-   for (int i = 0; i < init_hash_size; i++) { table[i] = -1; }
+   table = new Slot[init_hash_size];
+   for (int i = 0; i < init_hash_size; i++) { table[i].id = -1; }
 }
 
 template<typename T>
@@ -217,8 +268,8 @@ HashTable<T>::HashTable(const HashTable& other)
    : Base(other), mask(other.mask)
 {
    int size = mask+1;
-   table = new int[size];
-   memcpy(table, other.table, size*sizeof(int));
+   table = new Slot[size];
+   memcpy(table, other.table, size*sizeof(Slot));
    other.unused.Copy(unused);
 }
 
@@ -265,29 +316,15 @@ int HashTable<T>::GetId(int p1, int p2)
 {
    // search for the item in the hashtable
    if (p1 > p2) { std::swap(p1, p2); }
-   int idx = Hash(p1, p2);
-   int id = SearchList(table[idx], p1, p2);
+   unsigned hash = Hash(p1, p2);
+   int id = Search(hash, p1, p2);
    if (id >= 0) { return id; }
 
    // not found - use an unused item or create a new one
-   int new_id;
-   if (unused.Size())
-   {
-      new_id = unused.Last();
-      unused.DeleteLast();
-   }
-   else
-   {
-      new_id = Base::Append();
-   }
+   int new_id = NewId(hash);
    T& item = Base::At(new_id);
    item.p1 = p1;
    item.p2 = p2;
-
-   // insert into hashtable
-   Insert(idx, new_id, item);
-   CheckRehash();
-
    return new_id;
 }
 
@@ -296,30 +333,16 @@ int HashTable<T>::GetId(int p1, int p2, int p3, int p4)
 {
    // search for the item in the hashtable
    internal::sort4(p1, p2, p3, p4);
-   int idx = Hash(p1, p2, p3);
-   int id = SearchList(table[idx], p1, p2, p3);
+   unsigned hash = Hash(p1, p2, p3);
+   int id = Search(hash, p1, p2, p3);
    if (id >= 0) { return id; }
 
    // not found - use an unused item or create a new one
-   int new_id;
-   if (unused.Size())
-   {
-      new_id = unused.Last();
-      unused.DeleteLast();
-   }
-   else
-   {
-      new_id = Base::Append();
-   }
+   int new_id = NewId(hash);
    T& item = Base::At(new_id);
    item.p1 = p1;
    item.p2 = p2;
    item.p3 = p3;
-
-   // insert into hashtable
-   Insert(idx, new_id, item);
-   CheckRehash();
-
    return new_id;
 }
 
@@ -355,47 +378,77 @@ template<typename T>
 int HashTable<T>::FindId(int p1, int p2) const
 {
    if (p1 > p2) { std::swap(p1, p2); }
-   return SearchList(table[Hash(p1, p2)], p1, p2);
+   return Search(Hash(p1, p2), p1, p2);
 }
 
 template<typename T>
 int HashTable<T>::FindId(int p1, int p2, int p3, int p4) const
 {
    internal::sort4(p1, p2, p3, p4);
-   return SearchList(table[Hash(p1, p2, p3)], p1, p2, p3);
+   return Search(Hash(p1, p2, p3), p1, p2, p3);
 }
 
 template<typename T>
-int HashTable<T>::SearchList(int id, int p1, int p2) const
+int HashTable<T>::Search(unsigned hash, int p1, int p2) const
 {
-   while (id >= 0)
+   // stop at an empty slot or at a slot closer to its home position than the
+   // item would be: Robin Hood insertion would have placed the item there
+   for (unsigned idx = hash & mask, dist = 0; ; idx = (idx+1) & mask, dist++)
    {
-      const T& item = Base::At(id);
-      if (item.p1 == p1 && item.p2 == p2) { return id; }
-      id = item.next;
+      const Slot &slot = table[idx];
+      if (slot.id < 0 || Distance(idx, slot) < dist) { return -1; }
+      if (slot.hash == hash)
+      {
+         const T& item = Base::At(slot.id);
+         if (item.p1 == p1 && item.p2 == p2) { return slot.id; }
+      }
    }
-   return -1;
 }
 
 template<typename T>
-int HashTable<T>::SearchList(int id, int p1, int p2, int p3) const
+int HashTable<T>::Search(unsigned hash, int p1, int p2, int p3) const
 {
-   while (id >= 0)
+   for (unsigned idx = hash & mask, dist = 0; ; idx = (idx+1) & mask, dist++)
    {
-      const T& item = Base::At(id);
-      if (item.p1 == p1 && item.p2 == p2 && item.p3 == p3) { return id; }
-      id = item.next;
+      const Slot &slot = table[idx];
+      if (slot.id < 0 || Distance(idx, slot) < dist) { return -1; }
+      if (slot.hash == hash)
+      {
+         const T& item = Base::At(slot.id);
+         if (item.p1 == p1 && item.p2 == p2 && item.p3 == p3)
+         {
+            return slot.id;
+         }
+      }
    }
-   return -1;
 }
 
 template<typename T>
-inline void HashTable<T>::CheckRehash()
+int HashTable<T>::NewId(unsigned hash)
 {
-   const int fill_factor = 2;
+   int new_id;
+   if (unused.Size())
+   {
+      new_id = unused.Last();
+      unused.DeleteLast();
+   }
+   else
+   {
+      new_id = Base::Append();
+   }
+   Base::At(new_id).next = -1; // mark item as used
+
+   // insert into hashtable
+   CheckRehash();
+   Insert(new_id, hash);
+   return new_id;
+}
 
-   // is the table overfull?
-   if (Base::Size() > (mask+1) * fill_factor)
+template<typename T>
+inline void HashTable<T>::CheckRehash()
+{
+   // keep the load factor of the index below 3/4
+   if (4*(long) Size() > 3*((long) mask+1))
    {
       DoRehash();
    }
@@ -404,12 +457,13 @@ inline void HashTable<T>::CheckRehash()
 template<typename T>
 void HashTable<T>::DoRehash()
 {
-   delete [] table;
+   Slot* old_table = table;
+   unsigned old_size = mask+1;
 
    // double the table size
-   int new_table_size = 2*(mask+1);
-   table = new int[new_table_size];
-   for (int i = 0; i < new_table_size; i++) { table[i] = -1; }
+   unsigned new_table_size = 2*old_size;
+   table = new Slot[new_table_size];
+   for (unsigned i = 0; i < new_table_size; i++) { table[i].id = -1; }
    mask = new_table_size-1;
 
 #if defined(MFEM_DEBUG) && !defined(MFEM_USE_MPI)
@@ -417,44 +471,61 @@ void HashTable<T>::DoRehash()
              << std::endl;
 #endif
 
-   // reinsert all items
-   for (iterator it = begin(); it != end(); ++it)
+   // reinsert all ids, the slots keep the hashes so the items are not read
+   for (unsigned i = 0; i < old_size; i++)
    {
-      Insert(Hash(*it), it.index(), *it);
+      if (old_table[i].id >= 0) { Insert(old_table[i].id, old_table[i].hash); }
    }
+   delete [] old_table;
 }
 
 template<typename T>
-inline void HashTable<T>::Insert(int idx, int id, T &item)
+void HashTable<T>::Insert(int id, unsigned hash)
 {
-   // add item at the beginning of the linked list
-   item.next = table[idx];
-   table[idx] = id;
+   Slot ins = { id, hash };
+   for (unsigned idx = hash & mask, dist = 0; ; idx = (idx+1) & mask, dist++)
+   {
+      Slot &slot = table[idx];
+      if (slot.id < 0) { slot = ins; return; }
+
+      // Robin Hood: take the slot of an item closer to its home position and
+      // continue with inserting that item
+      unsigned slot_dist = Distance(idx, slot);
+      if (slot_dist < dist)
+      {
+         std::swap(slot, ins);
+         dist = slot_dist;
+      }
+   }
 }
 
 template<typename T>
-void HashTable<T>::Unlink(int idx, int id)
+void HashTable<T>::Unlink(int id, unsigned hash)
 {
-   // remove item from the linked list
-   int* p_id = table + idx;
-   while (*p_id >= 0)
+   unsigned idx = hash & mask;
+   while (table[idx].id != id)
    {
-      T& item = Base::At(*p_id);
-      if (*p_id == id)
-      {
-         *p_id = item.next;
-         return;
-      }
-      p_id = &(item.next);
+      MFEM_VERIFY(table[idx].id >= 0, "HashTable<>::Unlink: item not found!");
+      idx = (idx+1) & mask;
    }
-   MFEM_ABORT("HashTable<>::Unlink: item not found!");
+
+   // shift the following slots back until an empty slot or a slot at its
+   // home position
+   for (unsigned next = (idx+1) & mask; ; next = (next+1) & mask)
+   {
+      const Slot &slot = table[next];
+      if (slot.id < 0 || Distance(next, slot) == 0) { break; }
+      table[idx] = slot;
+      idx = next;
+   }
+   table[idx].id = -1;
 }
 
 template<typename T>
 void HashTable<T>::Delete(int id)
 {
    T& item = Base::At(id);
-   Unlink(Hash(item), id);
+   Unlink(id, Hash(item));
    item.next = -2;    // mark item as unused
    unused.Append(id); // add its id to the unused ids
 }
@@ -463,15 +534,14 @@ template<typename T>
 void HashTable<T>::Reparent(int id, int new_p1, int new_p2)
 {
    T& item = Base::At(id);
-   Unlink(Hash(item), id);
+   Unlink(id, Hash(item));
 
    if (new_p1 > new_p2) { std::swap(new_p1, new_p2); }
    item.p1 = new_p1;
    item.p2 = new_p2;
 
    // reinsert under new parent IDs
-   int new_idx = Hash(new_p1, new_p2);
-   Insert(new_idx, id, item);
+   Insert(id, Hash(new_p1, new_p2));
 }
 
 template<typename T>
@@ -479,7 +549,7 @@ void HashTable<T>::Reparent(int id,
                             int new_p1, int new_p2, int new_p3, int new_p4)
 {
    T& item = Base::At(id);
-   Unlink(Hash(item), id);
+   Unlink(id, Hash(item));
 
    internal::sort4(new_p1, new_p2, new_p3, new_p4);
    item.p1 = new_p1;
@@ -487,20 +557,67 @@ void HashTable<T>::Reparent(int id,
    item.p3 = new_p3;
 
    // reinsert under new parent IDs
-   int new_idx = Hash(new_p1, new_p2, new_p3);
-   Insert(new_idx, id, item);
+   Insert(id, Hash(new_p1, new_p2, new_p3));
+}
+
+template<typename T>
+void HashTable<T>::GetCompactIds(Array<int> &new_ids) const
+{
+   new_ids.SetSize(Base::Size());
+   for (int id = 0, new_id = 0; id < new_ids.Size(); id++)
+   {
+      new_ids[id] = IdExists(id) ? new_id++ : -1;
+   }
+}
+
+template<typename T>
+void HashTable<T>::Compact(const Array<int> &parent_map)
+{
+   // move the used items to the front, keeping their order
+   int size = 0;
+   for (int id = 0; id < Base::Size(); id++)
+   {
+      T& item = Base::At(id);
+      if (item.next == -2) { continue; }
+      if (size < id)
+      {
+         Base::At(size) = item;
+         item = T(); // reset the old copy, it is destroyed by Truncate()
+      }
+      RemapParents(Base::At(size), parent_map);
+      size++;
+   }
+   Base::Truncate(size);
+   unused.DeleteAll();
+
+   // shrink the index to the smallest size with load factor at most 3/8, so
+   // that the following insertions do not cause a rehash right away
+   unsigned table_size = mask+1;
+   while (table_size > 16 && 16*(long) size <= 3*(long) table_size)
+   {
+      table_size /= 2;
+   }
+   delete [] table;
+   table = new Slot[table_size];
+   for (unsigned i = 0; i < table_size; i++) { table[i].id = -1; }
+   mask = table_size-1;
+
+   for (int id = 0; id < size; id++)
+   {
+      Insert(id, Hash(Base::At(id)));
+   }
 }
 
 template<typename T>
 long HashTable<T>::MemoryUsage() const
 {
-   return (mask+1) * sizeof(int) + Base::MemoryUsage() + unused.MemoryUsage();
+   return (mask+1) * sizeof(Slot) + Base::MemoryUsage() + unused.MemoryUsage();
 }
 
 template<typename T>
 void HashTable<T>::PrintMemoryDetail() const
 {
-   mfem::out << Base::MemoryUsage() << " + " << (mask+1) * sizeof(int)
+   mfem::out << Base::MemoryUsage() << " + " << (mask+1) * sizeof(Slot)
              << " + " << unused.MemoryUsage();
 }
 
@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include <algorithm>
+#include <vector>
 
 namespace mfem
 {
@@ -83,6 +84,67 @@ void SortTriple (Triple<A, B, C> *triples, int size)
    std::sort(triples, triples + size);
 }
 
+/** @brief Stable radix sort of an array of Pairs with respect to the lowest
+    @a bits bits of their first element, an unsigned integer key. */
+/** The sort makes (bits+7)/8 passes over the array, each moving the pairs to
+    a workspace of the same size. With MFEM_USE_LEGACY_OPENMP, the array is
+    split into chunks which are counted and scattered by different threads;
+    the result does not depend on the number of threads. */
+template <class B>
+void RadixSortPairs(Pair<unsigned long long, B> *pairs, int size, int bits)
+{
+   typedef Pair<unsigned long long, B> pair_t;
+   const int radix = 256;
+   // chunks of at least 4096 pairs, processed in parallel with OpenMP
+   const int nchunks = std::max(1, std::min(64, size/4096));
+   std::vector<pair_t> work(size);
+   std::vector<int> count(nchunks*radix);
+   pair_t *src = pairs, *dst = work.data();
+   for (int shift = 0; shift < bits; shift += 8)
+   {
+      std::fill(count.begin(), count.end(), 0);
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int c = 0; c < nchunks; c++)
+      {
+         int *cnt = count.data() + c*radix;
+         const int begin = int((long long)size*c/nchunks);
+         const int end = int((long long)size*(c+1)/nchunks);
+         for (int i = begin; i < end; i++)
+         {
+            cnt[(src[i].one >> shift) & (radix-1)]++;
+         }
+      }
+      // offsets: by digit, then by chunk, which keeps the sort stable
+      int sum = 0;
+      for (int d = 0; d < radix; d++)
+      {
+         for (int c = 0; c < nchunks; c++)
+         {
+            const int n = count[c*radix + d];
+            count[c*radix + d] = sum;
+            sum += n;
+         }
+      }
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int c = 0; c < nchunks; c++)
+      {
+         int *offset = count.data() + c*radix;
+         const int begin = int((long long)size*c/nchunks);
+         const int end = int((long long)size*(c+1)/nchunks);
+         for (int i = begin; i < end; i++)
+         {
+            dst[offset[(src[i].one >> shift) & (radix-1)]++] = src[i];
+         }
+      }
+      std::swap(src, dst);
+   }
+   if (src != pairs) { std::copy(src, src + size, pairs); }
+}
+
 }
 
 #endif
@@ -18,6 +18,8 @@
 #include "densemat.hpp"
 #include "../general/table.hpp"
 #include "../general/globals.hpp"
+#include "../general/forall.hpp"
+#include "../general/sort_pairs.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -3061,6 +3063,201 @@ void Add(double alpha, const DenseMatrix &A,
 }
 
 
+namespace internal
+{
+
+// Dense matrix-matrix products C = alpha op(A) op(B) + beta C, with op(X) = X
+// or X^T, for column-major matrices with leading dimensions lda, ldb and ldc.
+// This is the fallback used when MFEM is built without LAPACK. Products with
+// small dimensions use simple loops ordered for unit-stride access in the
+// innermost loop, while larger products use a cache-blocked algorithm which
+// packs blocks of op(A) and op(B) into contiguous panels and updates C with a
+// fixed-size register-blocked micro-kernel that the compiler can vectorize.
+
+// Register block of the micro-kernel (gemm_mr x gemm_nr) and cache blocks of
+// op(A) (gemm_mc x gemm_kc) and op(B) (gemm_kc x gemm_nc).
+static const int gemm_mr = 8, gemm_nr = 4;
+static const int gemm_mc = 128, gemm_kc = 256, gemm_nc = 2048;
+
+// Use the blocked algorithm when all dimensions are at least this large.
+static const int gemm_blocked_min_size = 48;
+
+// Pack the (mc x kc) block of alpha op(A) starting at (ic,pc) into row panels
+// of height gemm_mr, padded with zeros.
+static void GemmPackA(bool tA, int mc, int kc, double alpha, const double *A,
+                      int lda, int ic, int pc, double *Ap)
+{
+   for (int ir = 0; ir < mc; ir += gemm_mr)
+   {
+      const int mr = std::min(gemm_mr, mc - ir);
+      for (int p = 0; p < kc; p++)
+      {
+         for (int i = 0; i < mr; i++)
+         {
+            const int row = ic + ir + i, col = pc + p;
+            Ap[i] = alpha * (tA ? A[col + row*lda] : A[row + col*lda]);
+         }
+         for (int i = mr; i < gemm_mr; i++) { Ap[i] = 0.0; }
+         Ap += gemm_mr;
+      }
+   }
+}
+
+// Pack the (kc x nc) block of op(B) starting at (pc,jc) into column panels of
+// width gemm_nr, padded with zeros.
+static void GemmPackB(bool tB, int kc, int nc, const double *B, int ldb,
+                      int pc, int jc, double *Bp)
+{
+   for (int jr = 0; jr < nc; jr += gemm_nr)
+   {
+      const int nr = std::min(gemm_nr, nc - jr);
+      for (int p = 0; p < kc; p++)
+      {
+         for (int j = 0; j < nr; j++)
+         {
+            const int row = pc + p, col = jc + jr + j;
+            Bp[j] = tB ? B[col + row*ldb] : B[row + col*ldb];
+         }
+         for (int j = nr; j < gemm_nr; j++) { Bp[j] = 0.0; }
+         Bp += gemm_nr;
+      }
+   }
+}
+
+// C(0:mr,0:nr) += Ap Bp, where Ap and Bp are packed panels of length kc.
+static inline void GemmMicroKernel(int kc, const double *Ap, const double *Bp,
+                                   double *C, int ldc, int mr, int nr)
+{
+   double c[gemm_mr*gemm_nr];
+   for (int i = 0; i < gemm_mr*gemm_nr; i++) { c[i] = 0.0; }
+   for (int p = 0; p < kc; p++)
+   {
+      for (int j = 0; j < gemm_nr; j++)
+      {
+         const double b = Bp[j];
+         for (int i = 0; i < gemm_mr; i++)
+         {
+            c[i+j*gemm_mr] += Ap[i] * b;
+         }
+      }
+      Ap += gemm_mr;
+      Bp += gemm_nr;
+   }
+   for (int j = 0; j < nr; j++)
+   {
+      for (int i = 0; i < mr; i++)
+      {
+         C[i+j*ldc] += c[i+j*gemm_mr];
+      }
+   }
+}
+
+static void GemmBlocked(bool tA, bool tB, int m, int n, int k, double alpha,
+                        const double *A, int lda, const double *B, int ldb,
+                        double *C, int ldc)
+{
+   const int mc_max = std::min(gemm_mc, m), kc_max = std::min(gemm_kc, k);
+   const int nc_max = std::min(gemm_nc, n);
+   Array<double> Apack(((mc_max + gemm_mr - 1)/gemm_mr)*gemm_mr*kc_max);
+   Array<double> Bpack(((nc_max + gemm_nr - 1)/gemm_nr)*gemm_nr*kc_max);
+   for (int jc = 0; jc < n; jc += gemm_nc)
+   {
+      const int nc = std::min(gemm_nc, n - jc);
+      for (int pc = 0; pc < k; pc += gemm_kc)
+      {
+         const int kc = std::min(gemm_kc, k - pc);
+         GemmPackB(tB, kc, nc, B, ldb, pc, jc, Bpack);
+         for (int ic = 0; ic < m; ic += gemm_mc)
+         {
+            const int mc = std::min(gemm_mc, m - ic);
+            GemmPackA(tA, mc, kc, alpha, A, lda, ic, pc, Apack);
+            for (int jr = 0; jr < nc; jr += gemm_nr)
+            {
+               const int nr = std::min(gemm_nr, nc - jr);
+               for (int ir = 0; ir < mc; ir += gemm_mr)
+               {
+                  const int mr = std::min(gemm_mr, mc - ir);
+                  GemmMicroKernel(kc, Apack + ir*kc, Bpack + jr*kc,
+                                  C + (ic + ir) + (jc + jr)*ldc, ldc, mr, nr);
+               }
+            }
+         }
+      }
+   }
+}
+
+static void GemmSmall(bool tA, bool tB, int m, int n, int k, double alpha,
+                      const double *A, int lda, const double *B, int ldb,
+                      double *C, int ldc)
+{
+   if (!tA)
+   {
+      // C(:,j) += sum_p A(:,p) (alpha op(B)(p,j))
+      for (int j = 0; j < n; j++)
+      {
+         double *c = C + j*ldc;
+         for (int p = 0; p < k; p++)
+         {
+            const double b = alpha * (tB ? B[j + p*ldb] : B[p + j*ldb]);
+            const double *a = A + p*lda;
+            for (int i = 0; i < m; i++)
+            {
+               c[i] += a[i] * b;
+            }
+         }
+      }
+   }
+   else
+   {
+      // C(i,j) += alpha A(:,i) . op(B)(:,j)
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < m; i++)
+         {
+            const double *a = A + i*lda;
+            double d = 0.0;
+            if (!tB)
+            {
+               const double *b = B + j*ldb;
+               for (int p = 0; p < k; p++) { d += a[p] * b[p]; }
+            }
+            else
+            {
+               for (int p = 0; p < k; p++) { d += a[p] * B[j + p*ldb]; }
+            }
+            C[i+j*ldc] += alpha * d;
+         }
+      }
+   }
+}
+
+static void Gemm(bool tA, bool tB, int m, int n, int k, double alpha,
+                 const double *A, int lda, const double *B, int ldb,
+                 double beta, double *C, int ldc)
+{
+   if (beta != 1.0)
+   {
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < m; i++)
+         {
+            C[i+j*ldc] = (beta == 0.0) ? 0.0 : beta * C[i+j*ldc];
+         }
+      }
+   }
+   if (m == 0 || n == 0 || k == 0 || alpha == 0.0) { return; }
+   if (std::min(std::min(m, n), k) >= gemm_blocked_min_size)
+   {
+      GemmBlocked(tA, tB, m, n, k, alpha, A, lda, B, ldb, C, ldc);
+   }
+   else
+   {
+      GemmSmall(tA, tB, m, n, k, alpha, A, lda, B, ldb, C, ldc);
+   }
+}
+
+} // namespace internal
+
 void Mult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
 {
    MFEM_ASSERT(a.Height() == b.Height() && a.Width() == c.Width() &&
@@ -3074,26 +3271,9 @@ void Mult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, b.Data(), &m,
           c.Data(), &k, &beta, a.Data(), &m);
 #else
-   const int ah = a.Height();
-   const int aw = a.Width();
-   const int bw = b.Width();
-   double *ad = a.Data();
-   const double *bd = b.Data();
-   const double *cd = c.Data();
-   for (int i = 0; i < ah*aw; i++)
-   {
-      ad[i] = 0.0;
-   }
-   for (int j = 0; j < aw; j++)
-   {
-      for (int k = 0; k < bw; k++)
-      {
-         for (int i = 0; i < ah; i++)
-         {
-            ad[i+j*ah] += bd[i+k*ah] * cd[k+j*bw];
-         }
-      }
-   }
+   const int m = b.Height(), n = c.Width(), k = b.Width();
+   internal::Gemm(false, false, m, n, k, 1.0, b.Data(), m, c.Data(), k,
+                  0.0, a.Data(), m);
 #endif
 }
 
@@ -3110,22 +3290,9 @@ void AddMult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, b.Data(), &m,
           c.Data(), &k, &beta, a.Data(), &m);
 #else
-   const int ah = a.Height();
-   const int aw = a.Width();
-   const int bw = b.Width();
-   double *ad = a.Data();
-   const double *bd = b.Data();
-   const double *cd = c.Data();
-   for (int j = 0; j < aw; j++)
-   {
-      for (int k = 0; k < bw; k++)
-      {
-         for (int i = 0; i < ah; i++)
-         {
-            ad[i+j*ah] += bd[i+k*ah] * cd[k+j*bw];
-         }
-      }
-   }
+   const int m = b.Height(), n = c.Width(), k = b.Width();
+   internal::Gemm(false, false, m, n, k, 1.0, b.Data(), m, c.Data(), k,
+                  1.0, a.Data(), m);
 #endif
 }
 
@@ -3465,32 +3632,9 @@ void MultABt(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &ABt)
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, A.Data(), &m,
           B.Data(), &n, &beta, ABt.Data(), &m);
 #elif 1
-   const int ah = A.Height();
-   const int bh = B.Height();
-   const int aw = A.Width();
-   const double *ad = A.Data();
-   const double *bd = B.Data();
-   double *cd = ABt.Data();
-
-   for (int i = 0, s = ah*bh; i < s; i++)
-   {
-      cd[i] = 0.0;
-   }
-   for (int k = 0; k < aw; k++)
-   {
-      double *cp = cd;
-      for (int j = 0; j < bh; j++)
-      {
-         const double bjk = bd[j];
-         for (int i = 0; i < ah; i++)
-         {
-            cp[i] += ad[i] * bjk;
-         }
-         cp += ah;
-      }
-      ad += ah;
-      bd += bh;
-   }
+   const int m = A.Height(), n = B.Height(), k = A.Width();
+   internal::Gemm(false, true, m, n, k, 1.0, A.Data(), m, B.Data(), n,
+                  0.0, ABt.Data(), m);
 #elif 1
    const int ah = A.Height();
    const int bh = B.Height();
@@ -3588,28 +3732,9 @@ void AddMultABt(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &ABt)
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, A.Data(), &m,
           B.Data(), &n, &beta, ABt.Data(), &m);
 #elif 1
-   const int ah = A.Height();
-   const int bh = B.Height();
-   const int aw = A.Width();
-   const double *ad = A.Data();
-   const double *bd = B.Data();
-   double *cd = ABt.Data();
-
-   for (int k = 0; k < aw; k++)
-   {
-      double *cp = cd;
-      for (int j = 0; j < bh; j++)
-      {
-         const double bjk = bd[j];
-         for (int i = 0; i < ah; i++)
-         {
-            cp[i] += ad[i] * bjk;
-         }
-         cp += ah;
-      }
-      ad += ah;
-      bd += bh;
-   }
+   const int m = A.Height(), n = B.Height(), k = A.Width();
+   internal::Gemm(false, true, m, n, k, 1.0, A.Data(), m, B.Data(), n,
+                  1.0, ABt.Data(), m);
 #else
    int i, j, k;
    double d;
@@ -3683,28 +3808,9 @@ void AddMult_a_ABt(double a, const DenseMatrix &A, const DenseMatrix &B,
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, A.Data(), &m,
           B.Data(), &n, &beta, ABt.Data(), &m);
 #elif 1
-   const int ah = A.Height();
-   const int bh = B.Height();
-   const int aw = A.Width();
-   const double *ad = A.Data();
-   const double *bd = B.Data();
-   double *cd = ABt.Data();
-
-   for (int k = 0; k < aw; k++)
-   {
-      double *cp = cd;
-      for (int j = 0; j < bh; j++)
-      {
-         const double bjk = a * bd[j];
-         for (int i = 0; i < ah; i++)
-         {
-            cp[i] += ad[i] * bjk;
-         }
-         cp += ah;
-      }
-      ad += ah;
-      bd += bh;
-   }
+   const int m = A.Height(), n = B.Height(), k = A.Width();
+   internal::Gemm(false, true, m, n, k, a, A.Data(), m, B.Data(), n,
+                  1.0, ABt.Data(), m);
 #else
    int i, j, k;
    double d;
@@ -3740,28 +3846,9 @@ void MultAtB(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &AtB)
    dgemm_(&transa, &transb, &m, &n, &k, &alpha, A.Data(), &k,
           B.Data(), &k, &beta, AtB.Data(), &m);
 #elif 1
-   const int ah = A.Height();
-   const int aw = A.Width();
-   const int bw = B.Width();
-   const double *ad = A.Data();
-   const double *bd = B.Data();
-   double *cd = AtB.Data();
-
-   for (int j = 0; j < bw; j++)
-   {
-      const double *ap = ad;
-      for (int i = 0; i < aw; i++)
-      {
-         double d = 0.0;
-         for (int k = 0; k < ah; k++)
-         {
-            d += ap[k] * bd[k];
-         }
-         *(cd++) = d;
-         ap += ah;
-      }
-      bd += ah;
-   }
+   const int m = A.Width(), n = B.Width(), k = A.Height();
+   internal::Gemm(true, false, m, n, k, 1.0, A.Data(), k, B.Data(), k,
+                  0.0, AtB.Data(), m);
 #else
    int i, j, k;
    double d;
@@ -3779,28 +3866,64 @@ void MultAtB(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &AtB)
 #endif
 }
 
-void AddMult_a_AAt(double a, const DenseMatrix &A, DenseMatrix &AAt)
+// AAt += a * A * A^t for a matrix A of size h x T_W, with a compile-time width.
+template <int T_W>
+static void AddMult_a_AAt(double a, int h, const double *ad, double *cd)
 {
-   double d;
-
-   for (int i = 0; i < A.Height(); i++)
+   for (int j = 0; j < h; j++)
    {
-      for (int j = 0; j < i; j++)
+      double a_j[T_W];
+      for (int k = 0; k < T_W; k++) { a_j[k] = ad[j + k*h]; }
+      double *c_j = cd + j*h;
+      for (int i = 0; i < h; i++)
       {
-         d = 0.;
-         for (int k = 0; k < A.Width(); k++)
+         double d = 0.0;
+         for (int k = 0; k < T_W; k++)
          {
-            d += A(i,k) * A(j,k);
+            d += ad[i + k*h] * a_j[k];
          }
-         AAt(i, j) += (d *= a);
-         AAt(j, i) += d;
+         c_j[i] += a * d;
       }
-      d = 0.;
-      for (int k = 0; k < A.Width(); k++)
+   }
+}
+
+void AddMult_a_AAt(double a, const DenseMatrix &A, DenseMatrix &AAt)
+{
+   // Compute the columns of A A^t with unit stride access to A and AAt. Both
+   // (i,j) and (j,i) are computed with the same sequence of operations, so the
+   // update is exactly symmetric.
+   const int h = A.Height(), w = A.Width();
+   const double *ad = A.Data();
+   double *cd = AAt.Data();
+   switch (w)
+   {
+      case 1: AddMult_a_AAt<1>(a, h, ad, cd); return;
+      case 2: AddMult_a_AAt<2>(a, h, ad, cd); return;
+      case 3: AddMult_a_AAt<3>(a, h, ad, cd); return;
+   }
+   const int bs = 64;
+   double d[bs];
+   for (int j = 0; j < h; j++)
+   {
+      for (int i0 = 0; i0 < h; i0 += bs)
       {
-         d += A(i,k) * A(i,k);
+         const int nb = std::min(bs, h - i0);
+         for (int i = 0; i < nb; i++) { d[i] = 0.0; }
+         for (int k = 0; k < w; k++)
+         {
+            const double *a_k = ad + i0 + k*h;
+            const double a_jk = ad[j + k*h];
+            for (int i = 0; i < nb; i++)
+            {
+               d[i] += a_k[i] * a_jk;
+            }
+         }
+         double *c_j = cd + i0 + j*h;
+         for (int i = 0; i < nb; i++)
+         {
+            c_j[i] += a * d[i];
+         }
       }
-      AAt(i, i) += a * d;
    }
 }
 
@@ -3937,24 +4060,91 @@ void AddMult_a_VVt(const double a, const Vector &v, DenseMatrix &VVt)
 }
 
 
-void LUFactors::Factor(int m)
+namespace internal
 {
-#ifdef MFEM_USE_LAPACK
-   int info = 0;
-   if (m) { dgetrf_(&m, &m, data, &m, ipiv, &info); }
-   MFEM_VERIFY(!info, "LAPACK: error in DGETRF");
-#else
-   // compiling without LAPACK
-   double *data = this->data;
-   for (int i = 0; i < m; i++)
+
+// LU factorization with partial pivoting of the (n x n) matrix A stored in
+// column-major order, with 0-based pivot indices. When T_N > 0, n = T_N is a
+// compile-time constant and the matrix is factored in a local array. Returns
+// false if a zero pivot is found.
+template <int T_N>
+MFEM_HOST_DEVICE inline bool LUFactor(const int d_n, double *A, int *ipiv)
+{
+   const int n = T_N ? T_N : d_n;
+   double loc[T_N ? T_N*T_N : 1];
+   double *data = T_N ? loc : A;
+   if (T_N) { for (int i = 0; i < n*n; i++) { loc[i] = A[i]; } }
+   bool ok = true;
+   for (int i = 0; i < n; i++)
    {
       // pivoting
+      int piv = i;
+      double a = fabs(data[piv+i*n]);
+      for (int j = i+1; j < n; j++)
+      {
+         const double b = fabs(data[j+i*n]);
+         if (b > a)
+         {
+            a = b;
+            piv = j;
+         }
+      }
+      ipiv[i] = piv;
+      if (piv != i)
+      {
+         // swap rows i and piv in both L and U parts
+         for (int j = 0; j < n; j++)
+         {
+            const double tmp = data[i+j*n];
+            data[i+j*n] = data[piv+j*n];
+            data[piv+j*n] = tmp;
+         }
+      }
+      if (data[i+i*n] == 0.0) { ok = false; continue; }
+      const double a_ii_inv = 1.0/data[i+i*n];
+      for (int j = i+1; j < n; j++)
+      {
+         data[j+i*n] *= a_ii_inv;
+      }
+      for (int k = i+1; k < n; k++)
+      {
+         const double a_ik = data[i+k*n];
+         for (int j = i+1; j < n; j++)
+         {
+            data[j+k*n] -= a_ik * data[j+i*n];
+         }
+      }
+   }
+   if (T_N) { for (int i = 0; i < n*n; i++) { A[i] = loc[i]; } }
+   return ok;
+}
+
+// Blocked LU factorization with partial pivoting for the larger matrices, in
+// the format of LUFactor(). The columns are factored in panels of 4; the
+// trailing matrix is then updated with one rank-4 update per panel, two columns
+// at a time with their entries of U kept in registers, instead of with four
+// rank-1 updates. The operations are done in the same order as in LUFactor(),
+// so the factors of nonsingular matrices are the same. When T_N > 0, n = T_N
+// is a compile-time constant. Returns false if a zero pivot is found.
+template <int T_N>
+MFEM_HOST_DEVICE inline bool BlockLUFactor(const int d_n, double *data,
+                                           int *ipiv)
+{
+   const int n = T_N ? T_N : d_n;
+   const int nb = 4;
+   bool ok = true;
+   for (int k0 = 0; k0 < n; k0 += nb)
+   {
+      const int k1 = (k0 + nb < n) ? k0 + nb : n;
+
+      // factor the panel, columns k0 to k1-1, as in LUFactor()
+      for (int i = k0; i < k1; i++)
       {
          int piv = i;
-         double a = std::abs(data[piv+i*m]);
-         for (int j = i+1; j < m; j++)
+         double a = fabs(data[piv+i*n]);
+         for (int j = i+1; j < n; j++)
          {
-            const double b = std::abs(data[j+i*m]);
+            const double b = fabs(data[j+i*n]);
             if (b > a)
             {
                a = b;
@@ -3965,27 +4155,246 @@ void LUFactors::Factor(int m)
          if (piv != i)
          {
             // swap rows i and piv in both L and U parts
-            for (int j = 0; j < m; j++)
+            for (int j = 0; j < n; j++)
+            {
+               const double tmp = data[i+j*n];
+               data[i+j*n] = data[piv+j*n];
+               data[piv+j*n] = tmp;
+            }
+         }
+         if (data[i+i*n] == 0.0)
+         {
+            // zero the column of L, so that the updates below skip it
+            ok = false;
+            for (int j = i+1; j < n; j++) { data[j+i*n] = 0.0; }
+            continue;
+         }
+         const double a_ii_inv = 1.0/data[i+i*n];
+         for (int j = i+1; j < n; j++)
+         {
+            data[j+i*n] *= a_ii_inv;
+         }
+         for (int k = i+1; k < k1; k++)
+         {
+            const double a_ik = data[i+k*n];
+            for (int j = i+1; j < n; j++)
             {
-               Swap<double>(data[i+j*m], data[piv+j*m]);
+               data[j+k*n] -= a_ik * data[j+i*n];
             }
          }
       }
-      MFEM_ASSERT(data[i+i*m] != 0.0, "division by zero");
-      const double a_ii_inv = 1.0/data[i+i*m];
-      for (int j = i+1; j < m; j++)
+
+      // U12 = L11^{-1} A12: the rows of the panel right of it
+      for (int k = k1; k < n; k++)
       {
-         data[j+i*m] *= a_ii_inv;
+         for (int i = k0; i < k1; i++)
+         {
+            const double a_ik = data[i+k*n];
+            for (int j = i+1; j < k1; j++)
+            {
+               data[j+k*n] -= data[j+i*n] * a_ik;
+            }
+         }
       }
-      for (int k = i+1; k < m; k++)
+
+      // A22 -= L21 U12
+      const double *L = data + k0*n;
+      if (k1 - k0 < nb)
       {
-         const double a_ik = data[i+k*m];
-         for (int j = i+1; j < m; j++)
+         for (int k = k1; k < n; k++)
+         {
+            for (int i = k0; i < k1; i++)
+            {
+               const double a_ik = data[i+k*n];
+               for (int j = k1; j < n; j++)
+               {
+                  data[j+k*n] -= L[j+(i-k0)*n] * a_ik;
+               }
+            }
+         }
+         continue;
+      }
+      int k = k1;
+      for ( ; k+1 < n; k += 2)
+      {
+         const double *u = data + k0 + k*n;
+         const double u00 = u[0], u01 = u[1], u02 = u[2], u03 = u[3];
+         const double u10 = u[n], u11 = u[n+1], u12 = u[n+2], u13 = u[n+3];
+         double *c0 = data + k*n, *c1 = c0 + n;
+         for (int j = k1; j < n; j++)
+         {
+            const double l0 = L[j], l1 = L[j+n], l2 = L[j+2*n], l3 = L[j+3*n];
+            c0[j] = c0[j] - l0*u00 - l1*u01 - l2*u02 - l3*u03;
+            c1[j] = c1[j] - l0*u10 - l1*u11 - l2*u12 - l3*u13;
+         }
+      }
+      if (k < n)
+      {
+         const double *u = data + k0 + k*n;
+         const double u00 = u[0], u01 = u[1], u02 = u[2], u03 = u[3];
+         double *c0 = data + k*n;
+         for (int j = k1; j < n; j++)
+         {
+            c0[j] = c0[j] - L[j]*u00 - L[j+n]*u01 - L[j+2*n]*u02 -
+                    L[j+3*n]*u03;
+         }
+      }
+   }
+   return ok;
+}
+
+// Solve A x = b in-place in x using the factors computed by LUFactor().
+template <int T_N>
+MFEM_HOST_DEVICE inline void LUSolve(const int d_n, const double *data,
+                                     const int *ipiv, double *X)
+{
+   const int n = T_N ? T_N : d_n;
+   double loc[T_N ? T_N : 1];
+   double *x = T_N ? loc : X;
+   if (T_N) { for (int i = 0; i < n; i++) { loc[i] = X[i]; } }
+   // X <- P X
+   for (int i = 0; i < n; i++)
+   {
+      const double tmp = x[i];
+      x[i] = x[ipiv[i]];
+      x[ipiv[i]] = tmp;
+   }
+   // X <- L^{-1} X
+   for (int j = 0; j < n; j++)
+   {
+      const double x_j = x[j];
+      for (int i = j+1; i < n; i++)
+      {
+         x[i] -= data[i+j*n] * x_j;
+      }
+   }
+   // X <- U^{-1} X
+   for (int j = n-1; j >= 0; j--)
+   {
+      const double x_j = ( x[j] /= data[j+j*n] );
+      for (int i = 0; i < j; i++)
+      {
+         x[i] -= data[i+j*n] * x_j;
+      }
+   }
+   if (T_N) { for (int i = 0; i < n; i++) { X[i] = loc[i]; } }
+}
+
+// Cholesky factorization A = L L^T of the symmetric positive definite (n x n)
+// matrix A stored in column-major order. The lower triangle of A is
+// overwritten with L; the strict upper triangle is not referenced. When
+// T_N > 0, the matrix is factored in a local array, as in LUFactor(). Returns
+// false if A is not (numerically) positive definite.
+template <int T_N>
+MFEM_HOST_DEVICE inline bool CholeskyFactor(const int d_n, double *A)
+{
+   const int n = T_N ? T_N : d_n;
+   double loc[T_N ? T_N*T_N : 1];
+   double *data = T_N ? loc : A;
+   if (T_N) { for (int i = 0; i < n*n; i++) { loc[i] = A[i]; } }
+   bool ok = true;
+   for (int j = 0; j < n; j++)
+   {
+      double a_jj = data[j+j*n];
+      for (int k = 0; k < j; k++)
+      {
+         a_jj -= data[j+k*n] * data[j+k*n];
+      }
+      if (!(a_jj > 0.0)) { ok = false; a_jj = 1.0; }
+      a_jj = sqrt(a_jj);
+      data[j+j*n] = a_jj;
+      const double a_jj_inv = 1.0/a_jj;
+      for (int i = j+1; i < n; i++)
+      {
+         double a_ij = data[i+j*n];
+         for (int k = 0; k < j; k++)
          {
-            data[j+k*m] -= a_ik * data[j+i*m];
+            a_ij -= data[i+k*n] * data[j+k*n];
          }
+         data[i+j*n] = a_ij * a_jj_inv;
+      }
+   }
+   if (T_N)
+   {
+      // copy back only the lower triangle
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = j; i < n; i++) { A[i+j*n] = loc[i+j*n]; }
+      }
+   }
+   return ok;
+}
+
+// Solve A x = b in-place in x using the factor L computed by CholeskyFactor().
+template <int T_N>
+MFEM_HOST_DEVICE inline void CholeskySolve(const int d_n, const double *data,
+                                           double *X)
+{
+   const int n = T_N ? T_N : d_n;
+   double loc[T_N ? T_N : 1];
+   double *x = T_N ? loc : X;
+   if (T_N) { for (int i = 0; i < n; i++) { loc[i] = X[i]; } }
+   // X <- L^{-1} X
+   for (int j = 0; j < n; j++)
+   {
+      const double x_j = ( x[j] /= data[j+j*n] );
+      for (int i = j+1; i < n; i++)
+      {
+         x[i] -= data[i+j*n] * x_j;
+      }
+   }
+   // X <- L^{-T} X
+   for (int i = n-1; i >= 0; i--)
+   {
+      double x_i = x[i];
+      for (int j = i+1; j < n; j++)
+      {
+         x_i -= data[j+i*n] * x[j];
       }
+      x[i] = x_i / data[i+i*n];
    }
+   if (T_N) { for (int i = 0; i < n; i++) { X[i] = loc[i]; } }
+}
+
+// Factor the matrix A of size n on the host, using a fixed-size kernel when
+// possible: the unblocked one for n <= 8, and the blocked one for the sizes of
+// the interior blocks of quads and hexes, (p-1)^2 and (p-1)^3, up to 64.
+static bool LUFactor(const int n, double *A, int *ipiv)
+{
+   switch (n)
+   {
+      case 1: return LUFactor<1>(n, A, ipiv);
+      case 2: return LUFactor<2>(n, A, ipiv);
+      case 3: return LUFactor<3>(n, A, ipiv);
+      case 4: return LUFactor<4>(n, A, ipiv);
+      case 5: return LUFactor<5>(n, A, ipiv);
+      case 6: return LUFactor<6>(n, A, ipiv);
+      case 7: return LUFactor<7>(n, A, ipiv);
+      case 8: return LUFactor<8>(n, A, ipiv);
+      case 9: return BlockLUFactor<9>(n, A, ipiv);
+      case 16: return BlockLUFactor<16>(n, A, ipiv);
+      case 25: return BlockLUFactor<25>(n, A, ipiv);
+      case 27: return BlockLUFactor<27>(n, A, ipiv);
+      case 36: return BlockLUFactor<36>(n, A, ipiv);
+      case 49: return BlockLUFactor<49>(n, A, ipiv);
+      case 64: return BlockLUFactor<64>(n, A, ipiv);
+      default: return BlockLUFactor<0>(n, A, ipiv);
+   }
+}
+
+} // namespace internal
+
+void LUFactors::Factor(int m)
+{
+#ifdef MFEM_USE_LAPACK
+   int info = 0;
+   if (m) { dgetrf_(&m, &m, data, &m, ipiv, &info); }
+   MFEM_VERIFY(!info, "LAPACK: error in DGETRF");
+#else
+   // compiling without LAPACK
+   const bool ok = internal::LUFactor(m, data, ipiv);
+   MFEM_ASSERT(ok, "division by zero");
+   MFEM_CONTRACT_VAR(ok);
 #endif
 }
 
@@ -4514,4 +4923,189 @@ DenseTensor &DenseTensor::operator=(double c)
    return *this;
 }
 
+template <int T_N>
+static void BatchLUFactor(const int n, const int NE, double *A, int *P)
+{
+   MFEM_FORALL(e, NE,
+   {
+      internal::LUFactor<T_N>(n, A + e*n*n, P + e*n);
+   });
+}
+
+template <int T_N>
+static void BatchBlockLUFactor(const int n, const int NE, double *A, int *P)
+{
+   MFEM_FORALL(e, NE,
+   {
+      internal::BlockLUFactor<T_N>(n, A + e*n*n, P + e*n);
+   });
+}
+
+void BatchLUFactor(DenseTensor &Mlu, Array<int> &P)
+{
+   const int n = Mlu.SizeI();
+   const int NE = Mlu.SizeK();
+   MFEM_VERIFY(Mlu.SizeJ() == n, "the matrices must be square");
+   P.SetSize(n*NE);
+   double *A = mfem::ReadWrite(Mlu.GetMemory(), Mlu.TotalSize());
+   int *piv = P.Write();
+   switch (n)
+   {
+      case 1: BatchLUFactor<1>(n, NE, A, piv); break;
+      case 2: BatchLUFactor<2>(n, NE, A, piv); break;
+      case 3: BatchLUFactor<3>(n, NE, A, piv); break;
+      case 4: BatchLUFactor<4>(n, NE, A, piv); break;
+      case 5: BatchLUFactor<5>(n, NE, A, piv); break;
+      case 6: BatchLUFactor<6>(n, NE, A, piv); break;
+      case 7: BatchLUFactor<7>(n, NE, A, piv); break;
+      case 8: BatchLUFactor<8>(n, NE, A, piv); break;
+      case 9: BatchBlockLUFactor<9>(n, NE, A, piv); break;
+      case 16: BatchBlockLUFactor<16>(n, NE, A, piv); break;
+      case 25: BatchBlockLUFactor<25>(n, NE, A, piv); break;
+      case 27: BatchBlockLUFactor<27>(n, NE, A, piv); break;
+      case 36: BatchBlockLUFactor<36>(n, NE, A, piv); break;
+      case 49: BatchBlockLUFactor<49>(n, NE, A, piv); break;
+      case 64: BatchBlockLUFactor<64>(n, NE, A, piv); break;
+      default: BatchBlockLUFactor<0>(n, NE, A, piv); break;
+   }
+}
+
+template <int T_N>
+static void BatchLUSolve(const int n, const int NE, const double *A,
+                         const int *P, double *X)
+{
+   MFEM_FORALL(e, NE,
+   {
+      internal::LUSolve<T_N>(n, A + e*n*n, P + e*n, X + e*n);
+   });
+}
+
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, Vector &X)
+{
+   const int n = Mlu.SizeI();
+   const int NE = Mlu.SizeK();
+   MFEM_VERIFY(P.Size() == n*NE && X.Size() == n*NE, "invalid sizes");
+   const double *A = mfem::Read(Mlu.GetMemory(), Mlu.TotalSize());
+   const int *piv = P.Read();
+   double *x = X.ReadWrite();
+   switch (n)
+   {
+      case 1: BatchLUSolve<1>(n, NE, A, piv, x); break;
+      case 2: BatchLUSolve<2>(n, NE, A, piv, x); break;
+      case 3: BatchLUSolve<3>(n, NE, A, piv, x); break;
+      case 4: BatchLUSolve<4>(n, NE, A, piv, x); break;
+      case 5: BatchLUSolve<5>(n, NE, A, piv, x); break;
+      case 6: BatchLUSolve<6>(n, NE, A, piv, x); break;
+      case 7: BatchLUSolve<7>(n, NE, A, piv, x); break;
+      case 8: BatchLUSolve<8>(n, NE, A, piv, x); break;
+      default: BatchLUSolve<0>(n, NE, A, piv, x); break;
+   }
+}
+
+void BatchLUFactor(const Array<int> &sizes, const Array<int> &offsets,
+                   double *data, const Array<int> &ipiv_offsets, int *ipiv)
+{
+   const int num = sizes.Size();
+   MFEM_VERIFY(offsets.Size() == num && ipiv_offsets.Size() == num,
+               "invalid sizes");
+
+   // group the matrices by size
+   Array<Pair<int,int> > by_size(num);
+   for (int k = 0; k < num; k++)
+   {
+      by_size[k] = Pair<int,int>(sizes[k], k);
+   }
+   SortPairs<int,int>(by_size, num);
+
+   DenseTensor batch;
+   Array<int> P;
+   for (int s = 0, t; s < num; s = t)
+   {
+      const int n = by_size[s].one;
+      for (t = s+1; t < num && by_size[t].one == n; t++) { }
+      if (n == 0) { continue; }
+
+      const int nb = t - s;
+      batch.SetSize(n, n, nb);
+      double *b_data = mfem::Write(batch.GetMemory(), n*n*nb, false);
+      for (int j = 0; j < nb; j++)
+      {
+         const double *A = data + offsets[by_size[s+j].two];
+         std::copy(A, A + n*n, b_data + j*n*n);
+      }
+      BatchLUFactor(batch, P);
+      b_data = mfem::ReadWrite(batch.GetMemory(), n*n*nb, false);
+      const int *b_ipiv = P.HostRead();
+      for (int j = 0; j < nb; j++)
+      {
+         const int k = by_size[s+j].two;
+         std::copy(b_data + j*n*n, b_data + (j+1)*n*n, data + offsets[k]);
+         for (int i = 0; i < n; i++)
+         {
+            ipiv[ipiv_offsets[k] + i] = b_ipiv[j*n + i] + LUFactors::ipiv_base;
+         }
+      }
+   }
+}
+
+template <int T_N>
+static void BatchCholeskyFactor(const int n, const int NE, double *A)
+{
+   MFEM_FORALL(e, NE,
+   {
+      internal::CholeskyFactor<T_N>(n, A + e*n*n);
+   });
+}
+
+void BatchCholeskyFactor(DenseTensor &Mchol)
+{
+   const int n = Mchol.SizeI();
+   const int NE = Mchol.SizeK();
+   MFEM_VERIFY(Mchol.SizeJ() == n, "the matrices must be square");
+   double *A = mfem::ReadWrite(Mchol.GetMemory(), Mchol.TotalSize());
+   switch (n)
+   {
+      case 1: BatchCholeskyFactor<1>(n, NE, A); break;
+      case 2: BatchCholeskyFactor<2>(n, NE, A); break;
+      case 3: BatchCholeskyFactor<3>(n, NE, A); break;
+      case 4: BatchCholeskyFactor<4>(n, NE, A); break;
+      case 5: BatchCholeskyFactor<5>(n, NE, A); break;
+      case 6: BatchCholeskyFactor<6>(n, NE, A); break;
+      case 7: BatchCholeskyFactor<7>(n, NE, A); break;
+      case 8: BatchCholeskyFactor<8>(n, NE, A); break;
+      default: BatchCholeskyFactor<0>(n, NE, A); break;
+   }
+}
+
+template <int T_N>
+static void BatchCholeskySolve(const int n, const int NE, const double *A,
+                               double *X)
+{
+   MFEM_FORALL(e, NE,
+   {
+      internal::CholeskySolve<T_N>(n, A + e*n*n, X + e*n);
+   });
+}
+
+void BatchCholeskySolve(const DenseTensor &Mchol, Vector &X)
+{
+   const int n = Mchol.SizeI();
+   const int NE = Mchol.SizeK();
+   MFEM_VERIFY(X.Size() == n*NE, "invalid sizes");
+   const double *A = mfem::Read(Mchol.GetMemory(), Mchol.TotalSize());
+   double *x = X.ReadWrite();
+   switch (n)
+   {
+      case 1: BatchCholeskySolve<1>(n, NE, A, x); break;
+      case 2: BatchCholeskySolve<2>(n, NE, A, x); break;
+      case 3: BatchCholeskySolve<3>(n, NE, A, x); break;
+      case 4: BatchCholeskySolve<4>(n, NE, A, x); break;
+      case 5: BatchCholeskySolve<5>(n, NE, A, x); break;
+      case 6: BatchCholeskySolve<6>(n, NE, A, x); break;
+      case 7: BatchCholeskySolve<7>(n, NE, A, x); break;
+      case 8: BatchCholeskySolve<8>(n, NE, A, x); break;
+      default: BatchCholeskySolve<0>(n, NE, A, x); break;
+   }
+}
+
 }
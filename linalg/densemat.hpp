@@ -746,6 +746,48 @@ public:
    ~DenseTensor() { tdata.Delete(); }
 };
 
+/** @brief Compute the LU factorizations of all matrices of the DenseTensor
+    @a Mlu, of size (n x n x NE), overwriting them with their LU factors. */
+/** The factorizations use partial pivoting, L.U = P.A, in the same format as
+    LUFactors without LAPACK; the 0-based pivot indices of all matrices are
+    returned in @a P, of size n*NE. The matrices are factored in parallel with
+    MFEM_FORALL; for small sizes, n <= 8, each matrix is factored in local
+    memory with a fixed-size kernel. Larger matrices are factored in panels
+    of 4 columns, with the trailing updates unrolled, and with fixed-size
+    kernels for the sizes of the interior blocks of quads and hexes up to 64
+    (9, 16, 25, 27, 36, 49 and 64). The matrices must be nonsingular. */
+void BatchLUFactor(DenseTensor &Mlu, Array<int> &P);
+
+/** @brief Solve the systems A_e X_e = B_e for all matrices A_e factored by
+    BatchLUFactor() in @a Mlu and @a P. */
+/** The vector @a X, of size n*NE, holds the right-hand sides B_e on input and
+    the solutions X_e on output. */
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, Vector &X);
+
+/** @brief Compute the LU factorizations of matrices of different sizes, stored
+    in place in @a data, grouping the matrices of equal size into batches
+    factored by BatchLUFactor(DenseTensor&, Array<int>&). */
+/** Matrix k has size sizes[k] and is stored at data + offsets[k]; its pivots
+    are returned at ipiv + ipiv_offsets[k]. The factors and pivots are in the
+    format of LUFactors, so they can be used with LUFactors::Solve() etc.,
+    with or without LAPACK. */
+void BatchLUFactor(const Array<int> &sizes, const Array<int> &offsets,
+                   double *data, const Array<int> &ipiv_offsets, int *ipiv);
+
+/** @brief Compute the Cholesky factorizations L.L^T of all symmetric positive
+    definite matrices of the DenseTensor @a Mchol, of size (n x n x NE). */
+/** The lower triangle of each matrix is overwritten with L; the strict upper
+    triangle is not referenced. As in BatchLUFactor(), the matrices are
+    factored in parallel with MFEM_FORALL, and with fixed-size kernels for
+    n <= 8. */
+void BatchCholeskyFactor(DenseTensor &Mchol);
+
+/** @brief Solve the systems A_e X_e = B_e for all matrices A_e factored by
+    BatchCholeskyFactor() in @a Mchol. */
+/** The vector @a X, of size n*NE, holds the right-hand sides B_e on input and
+    the solutions X_e on output. */
+void BatchCholeskySolve(const DenseTensor &Mchol, Vector &X);
+
 
 // Inline methods
 
@@ -26,6 +26,8 @@
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "sparsechol.hpp"
+#include "mixedprec.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
@@ -0,0 +1,268 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the mixed precision solvers
+
+#include "mixedprec.hpp"
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+namespace mfem
+{
+
+FloatSparseMatrix::FloatSparseMatrix(const SparseMatrix &mat)
+   : Operator(mat.Height(), mat.Width())
+{
+   MFEM_VERIFY(mat.Finalized(), "the SparseMatrix must be finalized");
+   I = mat.HostReadI();
+   J = mat.HostReadJ();
+   diag.SetSize(height);
+   for (int i = 0; i < height; i++)
+   {
+      diag[i] = -1;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { diag[i] = k; break; }
+      }
+   }
+   Update(mat);
+}
+
+void FloatSparseMatrix::Update(const SparseMatrix &mat)
+{
+   MFEM_VERIFY(mat.Height() == height && mat.HostReadI() == I &&
+               mat.HostReadJ() == J, "the sparsity pattern has changed");
+   const int nnz = I[height];
+   const double *data = mat.HostReadData();
+   A.resize(nnz);
+   for (int k = 0; k < nnz; k++) { A[k] = float(data[k]); }
+
+   // find the first row with a missing or zero diagonal, once here instead of
+   // in every Gauss-Seidel sweep
+   zero_diag_row = -1;
+   for (int i = 0; i < height; i++)
+   {
+      if (diag[i] < 0 || A[diag[i]] == 0.0f) { zero_diag_row = i; break; }
+   }
+}
+
+void FloatSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height, "invalid sizes");
+   const double *xp = x.HostRead();
+   double *yp = y.HostWrite();
+   for (int i = 0; i < height; i++)
+   {
+      double sum = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++) { sum += A[k]*xp[J[k]]; }
+      yp[i] = sum;
+   }
+}
+
+void FloatSparseMatrix::Mult(const float *x, float *y) const
+{
+   for (int i = 0; i < height; i++)
+   {
+      float sum = 0.0f;
+      for (int k = I[i]; k < I[i+1]; k++) { sum += A[k]*x[J[k]]; }
+      y[i] = sum;
+   }
+}
+
+void FloatSparseMatrix::GaussSeidelForward(const float *b, float *x) const
+{
+   MFEM_ASSERT(zero_diag_row < 0,
+               "zero diagonal entry in row " << zero_diag_row);
+   for (int i = 0; i < height; i++)
+   {
+      const int d = diag[i];
+      float sum = b[i];
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (k != d) { sum -= A[k]*x[J[k]]; }
+      }
+      x[i] = sum/A[d];
+   }
+}
+
+void FloatSparseMatrix::GaussSeidelBackward(const float *b, float *x) const
+{
+   MFEM_ASSERT(zero_diag_row < 0,
+               "zero diagonal entry in row " << zero_diag_row);
+   for (int i = height-1; i >= 0; i--)
+   {
+      const int d = diag[i];
+      float sum = b[i];
+      for (int k = I[i+1]-1; k >= I[i]; k--)
+      {
+         if (k != d) { sum -= A[k]*x[J[k]]; }
+      }
+      x[i] = sum/A[d];
+   }
+}
+
+
+FloatGSSmoother::FloatGSSmoother(const SparseMatrix &a, int t, int it)
+   : fmat(NULL), type(t), iterations(it)
+{
+   SetOperator(a);
+}
+
+void FloatGSSmoother::SetOperator(const Operator &op)
+{
+   const SparseMatrix *mat = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(mat, "FloatGSSmoother::SetOperator : not a SparseMatrix!");
+   height = mat->Height();
+   width = mat->Width();
+   delete fmat;
+   fmat = new FloatSparseMatrix(*mat);
+   MFEM_VERIFY(fmat->ZeroDiagonalRow() < 0,
+               "zero diagonal entry in row " << fmat->ZeroDiagonalRow());
+}
+
+void FloatGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(fmat, "the operator is not set");
+   fx.resize(height);
+   fy.resize(height);
+   const double *xp = x.HostRead();
+   double *yp = iterative_mode ? y.HostReadWrite() : y.HostWrite();
+   for (int i = 0; i < height; i++) { fx[i] = float(xp[i]); }
+   if (iterative_mode)
+   {
+      for (int i = 0; i < height; i++) { fy[i] = float(yp[i]); }
+   }
+   else
+   {
+      std::fill(fy.begin(), fy.end(), 0.0f);
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         fmat->GaussSeidelForward(fx.data(), fy.data());
+      }
+      if (type != 1)
+      {
+         fmat->GaussSeidelBackward(fx.data(), fy.data());
+      }
+   }
+   for (int i = 0; i < height; i++) { yp[i] = fy[i]; }
+}
+
+
+void MixedPrecisionSolver::SetOperator(const Operator &op)
+{
+   IterativeSolver::SetOperator(op);
+
+   delete fgmres;
+   fgmres =
+#ifdef MFEM_USE_MPI
+      dot_prod_type ? new FGMRESSolver(comm) :
+#endif
+      new FGMRESSolver;
+   // Set the operator before the preconditioner, so that the inner solver is
+   // not set up again.
+   fgmres->SetOperator(op);
+   if (prec) { fgmres->SetPreconditioner(*prec); }
+}
+
+void MixedPrecisionSolver::SetPreconditioner(Solver &pr)
+{
+   IterativeSolver::SetPreconditioner(pr);
+   if (fgmres) { fgmres->SetPreconditioner(pr); }
+}
+
+void MixedPrecisionSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(oper, "the operator is not set");
+
+   if (outer == FGMRES)
+   {
+      fgmres->SetKDim(kdim);
+      fgmres->SetRelTol(rel_tol);
+      fgmres->SetAbsTol(abs_tol);
+      fgmres->SetMaxIter(max_iter);
+      fgmres->SetPrintLevel(print_level);
+      fgmres->iterative_mode = iterative_mode;
+      fgmres->Mult(b, x);
+      final_iter = fgmres->GetNumIterations();
+      final_norm = fgmres->GetFinalNorm();
+      converged = fgmres->GetConverged();
+      return;
+   }
+
+   MFEM_VERIFY(prec, "the inner solver is not set");
+   r.SetSize(height);
+   c.SetSize(width);
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   double beta = Norm(r);
+   const double beta0 = beta;
+   const double tol = std::max(rel_tol*beta, abs_tol);
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; )
+   {
+      if (print_level == 1)
+      {
+         mfem::out << "   Pass : " << std::setw(2) << i
+                   << "   ||r|| = " << beta << '\n';
+      }
+      if (beta <= tol)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (++i > max_iter) { break; }
+
+      // solve A c = r with the inner solver, using the normalized residual
+      r /= beta;
+      prec->Mult(r, c);
+      add(x, beta, c, x); // x = x + B (b - A x)
+
+      oper->Mult(x, r);
+      subtract(b, r, r);
+      beta = Norm(r);
+   }
+   final_norm = beta;
+
+   if (print_level == 2)
+   {
+      mfem::out << "Mixed precision IR: Number of iterations: "
+                << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "||r_0|| = " << beta0 << '\n'
+                << "||r_N|| = " << beta << '\n'
+                << "Mixed precision IR: Number of iterations: "
+                << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Mixed precision IR: No convergence!\n";
+   }
+}
+
+}
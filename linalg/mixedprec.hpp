@@ -0,0 +1,173 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MIXEDPREC
+#define MFEM_MIXEDPREC
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+#include <vector>
+
+namespace mfem
+{
+
+/** @brief Single precision copy of the values of a finalized SparseMatrix,
+    sharing the sparsity pattern of the original matrix. */
+/** The sparsity pattern (the I and J arrays) is not copied, so the original
+    SparseMatrix must outlive this object and must not change its pattern. The
+    values are copied by the constructor and by Update(). */
+class FloatSparseMatrix : public Operator
+{
+protected:
+   const int *I, *J;
+   std::vector<float> A;
+   /// Index of the diagonal entry of each row in #A, or -1.
+   Array<int> diag;
+   /// First row with a missing or zero diagonal entry, or -1.
+   int zero_diag_row;
+
+public:
+   /// Create a single precision copy of the finalized matrix @a mat.
+   FloatSparseMatrix(const SparseMatrix &mat);
+
+   /** @brief Copy the values of @a mat, which must have the same sparsity
+       pattern as the matrix given to the constructor. */
+   void Update(const SparseMatrix &mat);
+
+   /// Return the number of stored entries.
+   int NumNonZeroElems() const { return (int)A.size(); }
+
+   /** @brief Return the first row with a missing or zero diagonal entry, or
+       -1 if there is none. The Gauss-Seidel sweeps require -1. */
+   int ZeroDiagonalRow() const { return zero_diag_row; }
+
+   /// Return the single precision values.
+   const float *GetData() const { return A.data(); }
+
+   /** @brief Matrix vector multiplication y = A x, with the values of A in
+       single precision and the vectors and the accumulation in double
+       precision. */
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Matrix vector multiplication y = A x in single precision.
+   void Mult(const float *x, float *y) const;
+
+   /// One forward Gauss-Seidel sweep for A x = b in single precision.
+   void GaussSeidelForward(const float *b, float *x) const;
+
+   /// One backward Gauss-Seidel sweep for A x = b in single precision.
+   void GaussSeidelBackward(const float *b, float *x) const;
+};
+
+/** @brief Gauss-Seidel smoother for a SparseMatrix, performing the sweeps in
+    single precision. */
+/** Apart from the precision of the matrix values and the sweeps, this is the
+    same as GSSmoother. The input and output vectors are converted to and from
+    single precision in each call to Mult(). */
+class FloatGSSmoother : public Solver
+{
+protected:
+   FloatSparseMatrix *fmat;
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+   mutable std::vector<float> fx, fy;
+
+public:
+   /// Create FloatGSSmoother.
+   FloatGSSmoother(int t = 0, int it = 1)
+      : fmat(NULL), type(t), iterations(it) { }
+
+   /// Create FloatGSSmoother.
+   FloatGSSmoother(const SparseMatrix &a, int t = 0, int it = 1);
+
+   /// The Operator @a op must be a finalized SparseMatrix.
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply the Gauss-Seidel sweeps in single precision.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual ~FloatGSSmoother() { delete fmat; }
+};
+
+/** @brief Mixed precision solver: an outer iteration in double precision
+    around an inner solver which works in lower (single) precision. */
+/** The inner solver is the preconditioner of this IterativeSolver, set with
+    SetPreconditioner(). It is usually a solver computing in single precision,
+    e.g. FloatGSSmoother or SparseCholeskySolver with SetSinglePrecision(), and
+    the outer iteration recovers the double precision accuracy of the solution
+    using residuals computed in double precision with the outer operator.
+
+    Two outer iterations are supported:
+    - ITERATIVE_REFINEMENT: x <- x + B (b - A x), where B is the inner solver.
+      This converges quickly when B is an accurate solver, e.g. a single
+      precision direct solver;
+    - FGMRES: flexible GMRES preconditioned with the inner solver, which is
+      more robust for approximate inner solvers.
+
+    In the ITERATIVE_REFINEMENT mode, the residual is normalized before it is
+    passed to the inner solver, to avoid underflow in single precision.
+
+    As with other IterativeSolver%s, SetOperator() calls SetOperator() of the
+    inner solver, unless SetPreconditioner() is called after SetOperator(). The
+    latter allows the use of an inner solver which is set up separately, e.g.
+    when the outer operator is a partially assembled operator and the inner
+    solver uses an assembled approximation of it. */
+class MixedPrecisionSolver : public IterativeSolver
+{
+public:
+   /// Type of the outer iteration.
+   enum OuterType
+   {
+      ITERATIVE_REFINEMENT, ///< Iterative refinement, x <- x + B (b - A x)
+      FGMRES                ///< Flexible GMRES, see FGMRESSolver
+   };
+
+protected:
+   OuterType outer;
+   int kdim;
+   /// The FGMRES outer iteration, created by SetOperator().
+   FGMRESSolver *fgmres;
+
+   mutable Vector r, c;
+
+public:
+   MixedPrecisionSolver(OuterType type = ITERATIVE_REFINEMENT)
+      : outer(type), kdim(50), fgmres(NULL) { }
+
+#ifdef MFEM_USE_MPI
+   MixedPrecisionSolver(MPI_Comm _comm, OuterType type = ITERATIVE_REFINEMENT)
+      : IterativeSolver(_comm), outer(type), kdim(50), fgmres(NULL) { }
+#endif
+
+   void SetOuterType(OuterType type) { outer = type; }
+   OuterType GetOuterType() const { return outer; }
+
+   /// Set the restart parameter of the FGMRES outer iteration.
+   void SetKDim(int dim) { kdim = dim; }
+
+   /// Set the outer operator and the operator of the inner solver, if set.
+   virtual void SetOperator(const Operator &op);
+
+   /// Set the inner solver.
+   virtual void SetPreconditioner(Solver &pr);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~MixedPrecisionSolver() { delete fgmres; }
+};
+
+}
+
+#endif
@@ -11,6 +11,10 @@
 
 #include "operator.hpp"
 #include "ode.hpp"
+#include "../general/forall.hpp"
+
+#include <cmath>
+#include <algorithm>
 
 namespace mfem
 {
@@ -344,6 +348,344 @@ const double RK8Solver::c[] =
 };
 
 
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   dq.SetSize(n, mem_type);
+   k.SetSize(n, mem_type);
+   dq = 0.0;
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->ScaleAddMult(A[i], dt, x, dq, k);
+      x.Add(B[i], dq);
+   }
+   t += dt;
+}
+
+const double LSRK3Solver::A[] = { 0., -5./9, -153./128 };
+const double LSRK3Solver::B[] = { 1./3, 15./16, 8./15 };
+const double LSRK3Solver::c[] = { 0., 1./3, 3./4 };
+
+const double LSRK4Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087,
+   -2404267990393./2016746695238,
+   -3550918686646./2091501179385,
+   -1275806237668./842570457699
+};
+const double LSRK4Solver::B[] =
+{
+   1432997174477./9575080441755,
+   5161836677717./13612068292357,
+   1720146321549./2090206949498,
+   3134564353537./4481467310338,
+   2277821191437./14882151754819
+};
+const double LSRK4Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755,
+   2526269341429./6820363962896,
+   2006345519317./3224310063776,
+   2802321613138./2924317926251
+};
+
+
+LowStorageSSPRKSolver::LowStorageSSPRKSolver(int _s, int _order)
+   : s(_s), order(_order)
+{
+   if (order == 2)
+   {
+      MFEM_VERIFY(s >= 2, "LowStorageSSPRKSolver: order 2 requires s >= 2");
+   }
+   else if (order == 3)
+   {
+      const int n = (int) std::floor(std::sqrt((double) s) + 0.5);
+      MFEM_VERIFY(n >= 2 && n*n == s, "LowStorageSSPRKSolver: order 3 "
+                  "requires s = n^2 >= 4 stages");
+   }
+   else
+   {
+      MFEM_ABORT("LowStorageSSPRKSolver: unsupported order " << order);
+   }
+}
+
+void LowStorageSSPRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   q.SetSize(n, mem_type);
+   k.SetSize(n, mem_type);
+}
+
+void LowStorageSSPRKSolver::EulerStage(Vector &x, double &t, double dt_s)
+{
+   f->SetTime(t);
+   f->Mult(x, k);
+   x.Add(dt_s, k);
+   t += dt_s;
+}
+
+void LowStorageSSPRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   // The stages are forward Euler steps of size dt/r combined with a single
+   // convex combination; tx and tq are the times associated with x and q.
+   double tx = t;
+   if (order == 2)
+   {
+      const double r = s - 1;
+      q = x;
+      for (int i = 1; i < s; i++) { EulerStage(x, tx, dt/r); }
+      EulerStage(x, tx, dt/r);
+      add(1./s, q, (s - 1.)/s, x, x);
+   }
+   else
+   {
+      const int n = (int) std::floor(std::sqrt((double) s) + 0.5);
+      const double r = n*n - n;
+      const int s1 = (n - 1)*(n - 2)/2, s2 = n*(n + 1)/2;
+      int i = 1;
+      for ( ; i <= s1; i++) { EulerStage(x, tx, dt/r); }
+      q = x;
+      const double tq = tx;
+      for ( ; i < s2; i++) { EulerStage(x, tx, dt/r); }
+      EulerStage(x, tx, dt/r);
+      const double wq = n/(2.*n - 1.), wx = (n - 1.)/(2.*n - 1.);
+      add(wq, q, wx, x, x);
+      tx = wq*tq + wx*tx;
+      for (i = s2 + 1; i <= s; i++) { EulerStage(x, tx, dt/r); }
+   }
+   t += dt;
+}
+
+
+WeightedRMSErrorNorm::WeightedRMSErrorNorm(double rtol, double atol)
+   : rel_tol(rtol), abs_tol(atol)
+{
+#ifdef MFEM_USE_MPI
+   parallel = false;
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+WeightedRMSErrorNorm::WeightedRMSErrorNorm(MPI_Comm _comm, double rtol,
+                                           double atol)
+   : rel_tol(rtol), abs_tol(atol), parallel(true), comm(_comm) { }
+#endif
+
+double WeightedRMSErrorNorm::Eval(const Vector &err, const Vector &x0,
+                                  const Vector &x1) const
+{
+   const bool use_dev = err.UseDevice() || x0.UseDevice() || x1.UseDevice();
+   const int N = err.Size();
+   const double rtol = rel_tol, atol = abs_tol;
+   auto e = err.Read(use_dev);
+   auto u0 = x0.Read(use_dev);
+   auto u1 = x1.Read(use_dev);
+   double loc[2];
+   loc[0] = MFEM_FORALL_REDUCE(use_dev, Sum, i, N,
+   {
+      const double w = atol + rtol*fmax(fabs(u0[i]), fabs(u1[i]));
+      const double r = e[i]/w;
+      return r*r;
+   });
+   loc[1] = N;
+#ifdef MFEM_USE_MPI
+   if (parallel)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, loc, 2, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+   return (loc[1] > 0.0) ? std::sqrt(loc[0]/loc[1]) : 0.0;
+}
+
+
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, int _order, const double *_a,
+                                   const double *_b, const double *_bh,
+                                   const double *_c, bool _fsal)
+   : s(_s), order(_order), a(_a), b(_b), bh(_bh), c(_c), fsal(_fsal),
+     k0_valid(false), norm(&default_norm)
+{
+   k = new Vector[s];
+   SetControllerParameters(0.9, 0.7/(order+1), 0.4/(order+1));
+   dt_min = 0.0;
+   dt_max = infinity();
+   max_rejects = 50;
+   err_old = 1.0;
+   dt_last = 0.0;
+   num_accepted = num_rejected = 0;
+}
+
+void EmbeddedRKSolver::SetControllerParameters(double _safety, double _alpha,
+                                               double _beta,
+                                               double _min_factor,
+                                               double _max_factor)
+{
+   safety = _safety;
+   alpha = _alpha;
+   beta = _beta;
+   min_factor = _min_factor;
+   max_factor = _max_factor;
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n, mem_type);
+   err.SetSize(n, mem_type);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n, mem_type);
+   }
+   k0_valid = false;
+   err_old = 1.0;
+   dt_last = 0.0;
+   num_accepted = num_rejected = 0;
+}
+
+void EmbeddedRKSolver::ComputeStages(const Vector &x, double t, double dt)
+{
+   for (int l = 0, i = 1; i < s; i++)
+   {
+      add(x, a[l++]*dt, k[0], y);
+      for (int j = 1; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+
+      f->SetTime(t + c[i-1]*dt);
+      f->Mult(y, k[i]);
+   }
+   // With FSAL, the last stage is evaluated at the new solution, i.e. y.
+   if (!fsal)
+   {
+      add(x, b[0]*dt, k[0], y);
+      for (int i = 1; i < s; i++)
+      {
+         y.Add(b[i]*dt, k[i]);
+      }
+   }
+   err.Set((b[0] - bh[0])*dt, k[0]);
+   for (int i = 1; i < s; i++)
+   {
+      if (b[i] != bh[i]) { err.Add((b[i] - bh[i])*dt, k[i]); }
+   }
+}
+
+void EmbeddedRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   if (!fsal || !k0_valid)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+   }
+   dt = std::min(dt, dt_max);
+
+   for (int rejects = 0; true; rejects++)
+   {
+      ComputeStages(x, t, dt);
+      const double e = norm->Eval(err, x, y);
+
+      if (e <= 1.0)
+      {
+         double factor = max_factor;
+         if (e > 0.0)
+         {
+            factor = safety*std::pow(e, -alpha)*std::pow(err_old, beta);
+            factor = std::max(min_factor, std::min(max_factor, factor));
+         }
+         // Do not increase the step size right after a rejection.
+         if (rejects > 0) { factor = std::min(factor, 1.0); }
+         err_old = std::max(e, 1e-4);
+
+         x = y;
+         t += dt;
+         dt_last = dt;
+         num_accepted++;
+         if (fsal)
+         {
+            k[0].Swap(k[s-1]);
+            k0_valid = true;
+         }
+         dt = std::min(dt*factor, dt_max);
+         return;
+      }
+
+      num_rejected++;
+      MFEM_VERIFY(rejects < max_rejects, "EmbeddedRKSolver: too many rejected"
+                  " steps, error estimate = " << e);
+      const double factor = safety*std::pow(e, -1.0/(order+1));
+      dt *= std::max(min_factor, factor);
+      MFEM_VERIFY(dt >= dt_min, "EmbeddedRKSolver: step size " << dt
+                  << " is below the minimum " << dt_min);
+   }
+}
+
+void EmbeddedRKSolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   while (t < tf)
+   {
+      if (tf - t < dt) { dt = tf - t; }
+      Step(x, t, dt);
+   }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double BogackiShampine32Solver::a[] =
+{
+   1./2,
+   0., 3./4,
+   2./9, 1./3, 4./9
+};
+const double BogackiShampine32Solver::b[] =
+{
+   2./9, 1./3, 4./9, 0.
+};
+const double BogackiShampine32Solver::bh[] =
+{
+   7./24, 1./4, 1./3, 1./8
+};
+const double BogackiShampine32Solver::c[] =
+{
+   1./2, 3./4, 1.
+};
+
+const double DormandPrince54Solver::a[] =
+{
+   1./5,
+   3./40, 9./40,
+   44./45, -56./15, 32./9,
+   19372./6561, -25360./2187, 64448./6561, -212./729,
+   9017./3168, -355./33, 46732./5247, 49./176, -5103./18656,
+   35./384, 0., 500./1113, 125./192, -2187./6784, 11./84
+};
+const double DormandPrince54Solver::b[] =
+{
+   35./384, 0., 500./1113, 125./192, -2187./6784, 11./84, 0.
+};
+const double DormandPrince54Solver::bh[] =
+{
+   5179./57600, 0., 7571./16695, 393./640, -92097./339200, 187./2100, 1./40
+};
+const double DormandPrince54Solver::c[] =
+{
+   1./5, 3./10, 4./5, 8./9, 1., 1.
+};
+
+
 void BackwardEulerSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -492,6 +834,159 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
 }
 
 
+IMEXRKSolver::IMEXRKSolver(int _s, const double *_aE, const double *_aI,
+                           const double *_bE, const double *_bI,
+                           const double *_c)
+   : s(_s), aE(_aE), aI(_aI), bE(_bE), bI(_bI), c(_c), split(NULL)
+{
+   MFEM_VERIFY(aI[0] == 0.0, "the first stage must be explicit");
+   kE = new Vector[s];
+   kI = new Vector[s];
+}
+
+void IMEXRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   split = dynamic_cast<SplitTimeDependentOperator *>(f);
+   MFEM_VERIFY(split, "IMEXRKSolver requires a SplitTimeDependentOperator");
+   int n = f->Width();
+   y.SetSize(n, mem_type);
+   for (int i = 0; i < s; i++)
+   {
+      kE[i].SetSize(n, mem_type);
+      kI[i].SetSize(n, mem_type);
+   }
+}
+
+void IMEXRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   // Stage i: z_i = y_i + dt aI[i][i] kI_i, where
+   //    y_i = x + dt sum_{j<i} (aE[i][j] kE_j + aI[i][j] kI_j),
+   //    kI_i = f_I(z_i, t + c[i] dt), kE_i = f_E(z_i, t + c[i] dt).
+   for (int i = 0; i < s; i++)
+   {
+      y = x;
+      for (int j = 0; j < i; j++)
+      {
+         if (aE[i*s+j] != 0.0) { y.Add(aE[i*s+j]*dt, kE[j]); }
+         if (aI[i*s+j] != 0.0) { y.Add(aI[i*s+j]*dt, kI[j]); }
+      }
+      split->SetTime(t + c[i]*dt);
+      const double gdt = aI[i*s+i]*dt;
+      if (gdt == 0.0)
+      {
+         split->ImplicitPartMult(y, kI[i]);
+      }
+      else
+      {
+         split->ImplicitPartSolve(gdt, y, kI[i]);
+         y.Add(gdt, kI[i]);
+      }
+      split->ExplicitPartMult(y, kE[i]);
+   }
+   for (int i = 0; i < s; i++)
+   {
+      if (bE[i] != 0.0) { x.Add(bE[i]*dt, kE[i]); }
+      if (bI[i] != 0.0) { x.Add(bI[i]*dt, kI[i]); }
+   }
+   t += dt;
+}
+
+IMEXRKSolver::~IMEXRKSolver()
+{
+   delete [] kI;
+   delete [] kE;
+}
+
+// ARS(2,2,2): gamma = 1 - 1/sqrt(2), delta = 1 - 1/(2 gamma) = -1/sqrt(2).
+const double IMEXARK2Solver::aE[] =
+{
+   0., 0., 0.,
+   .29289321881345247559915563789515096071516, 0., 0.,
+   -.70710678118654752440084436210484903928484,
+   1.70710678118654752440084436210484903928484, 0.
+};
+const double IMEXARK2Solver::aI[] =
+{
+   0., 0., 0.,
+   0., .29289321881345247559915563789515096071516, 0.,
+   0., .70710678118654752440084436210484903928484,
+   .29289321881345247559915563789515096071516
+};
+const double IMEXARK2Solver::bE[] =
+{
+   -.70710678118654752440084436210484903928484,
+   1.70710678118654752440084436210484903928484, 0.
+};
+const double IMEXARK2Solver::bI[] =
+{
+   0., .70710678118654752440084436210484903928484,
+   .29289321881345247559915563789515096071516
+};
+const double IMEXARK2Solver::c[] =
+{
+   0., .29289321881345247559915563789515096071516, 1.
+};
+
+const double IMEXARK3Solver::aE[] =
+{
+   0., 0., 0., 0.,
+   1767732205903./2027836641118, 0., 0., 0.,
+   5535828885825./10492691773637, 788022342437./10882634858940, 0., 0.,
+   6485989280629./16251701735622, -4246266847089./9704473918619,
+   10755448449292./10357097424841, 0.
+};
+const double IMEXARK3Solver::aI[] =
+{
+   0., 0., 0., 0.,
+   1767732205903./4055673282236, 1767732205903./4055673282236, 0., 0.,
+   2746238789719./10658868560708, -640167445237./6845629431997,
+   1767732205903./4055673282236, 0.,
+   1471266399579./7840856788654, -4482444167858./7529755066697,
+   11266239266428./11593286722821, 1767732205903./4055673282236
+};
+const double IMEXARK3Solver::b[] =
+{
+   1471266399579./7840856788654, -4482444167858./7529755066697,
+   11266239266428./11593286722821, 1767732205903./4055673282236
+};
+const double IMEXARK3Solver::c[] =
+{
+   0., 1767732205903./2027836641118, 3./5, 1.
+};
+
+const double IMEXARK4Solver::aE[] =
+{
+   0., 0., 0., 0., 0., 0.,
+   1./2, 0., 0., 0., 0., 0.,
+   13861./62500, 6889./62500, 0., 0., 0., 0.,
+   -116923316275./2393684061468, -2731218467317./15368042101831,
+   9408046702089./11113171139209, 0., 0., 0.,
+   -451086348788./2902428689909, -2682348792572./7519795681897,
+   12662868775082./11960479115383, 3355817975965./11060851509271, 0., 0.,
+   647845179188./3216320057751, 73281519250./8382639484533,
+   552539513391./3454668386233, 3354512671639./8306763924573, 4040./17871, 0.
+};
+const double IMEXARK4Solver::aI[] =
+{
+   0., 0., 0., 0., 0., 0.,
+   1./4, 1./4, 0., 0., 0., 0.,
+   8611./62500, -1743./31250, 1./4, 0., 0., 0.,
+   5012029./34652500, -654441./2922500, 174375./388108, 1./4, 0., 0.,
+   15267082809./155376265600, -71443401./120774400, 730878875./902184768,
+   2285395./8070912, 1./4, 0.,
+   82889./524892, 0., 15625./83664, 69875./102672, -2260./8211, 1./4
+};
+const double IMEXARK4Solver::b[] =
+{
+   82889./524892, 0., 15625./83664, 69875./102672, -2260./8211, 1./4
+};
+const double IMEXARK4Solver::c[] =
+{
+   0., 1./2, 83./250, 31./50, 17./20, 1.
+};
+
+
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -14,6 +14,9 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
 
 namespace mfem
 {
@@ -206,6 +209,238 @@ public:
 };
 
 
+/** A low-storage (2N-register) explicit Runge-Kutta method in the Williamson
+    form, given by the coefficients A[i], B[i] and c[i], i = 0,...,s-1:
+       dq = A[i] dq + dt f(x, t + c[i] dt),
+       x  = x + B[i] dq,
+    with A[0] = 0. Besides the solution, only the register dq and the output
+    of f are stored, independent of the number of stages. The update of dq is
+    performed with TimeDependentOperator::ScaleAddMult(), so operators that
+    implement it fuse the stage update with their action. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector dq, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c)
+      : s(_s), A(_A), B(_B), c(_c) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/// Williamson's 3-stage, 3rd order low-storage Runge-Kutta method.
+class LSRK3Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[3], B[3], c[3];
+
+public:
+   LSRK3Solver() : LowStorageRKSolver(3, A, B, c) { }
+};
+
+
+/// The 5-stage, 4th order low-storage Runge-Kutta method of Carpenter and
+/// Kennedy, "Fourth-order 2N-storage Runge-Kutta schemes", NASA TM-109112.
+class LSRK4Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LSRK4Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
+/** Low-storage, strong stability preserving (SSP) Runge-Kutta methods from
+    D. Ketcheson, "Highly efficient strong stability-preserving Runge-Kutta
+    methods with low-storage implementations", SIAM J. Sci. Comput. 30 (2008):
+    - order 2 with s >= 2 stages, SSP coefficient s-1,
+    - order 3 with s = n^2 >= 4 stages, SSP coefficient n^2-n.
+    The larger SSP coefficients allow proportionally larger time steps, and
+    only two additional vectors are stored for any number of stages. */
+class LowStorageSSPRKSolver : public ODESolver
+{
+private:
+   int s, order;
+   Vector q, k;
+
+   // x += dt_s f(x, t), where t is the time associated with x.
+   void EulerStage(Vector &x, double &t, double dt_s);
+
+public:
+   LowStorageSSPRKSolver(int _s = 4, int _order = 3);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/// Abstract norm used by adaptive ODE solvers to measure the local error.
+class ODEErrorNorm
+{
+public:
+   /** @brief Return the size of the local error estimate @a err for a step
+       from @a x0 to @a x1; a step is accepted when the returned value is not
+       greater than 1. */
+   virtual double Eval(const Vector &err, const Vector &x0,
+                       const Vector &x1) const = 0;
+
+   virtual ~ODEErrorNorm() { }
+};
+
+
+/** The weighted root-mean-square norm
+       sqrt( 1/N sum_i ( err_i / (atol + rtol max(|x0_i|,|x1_i|)) )^2 ),
+    the default error norm of EmbeddedRKSolver. */
+class WeightedRMSErrorNorm : public ODEErrorNorm
+{
+protected:
+   double rel_tol, abs_tol;
+#ifdef MFEM_USE_MPI
+   bool parallel;
+   MPI_Comm comm;
+#endif
+
+public:
+   WeightedRMSErrorNorm(double rtol = 1e-4, double atol = 1e-6);
+
+#ifdef MFEM_USE_MPI
+   /// The sum and the size N are accumulated over all ranks in @a comm.
+   WeightedRMSErrorNorm(MPI_Comm comm, double rtol = 1e-4, double atol = 1e-6);
+#endif
+
+   void SetRelTol(double rtol) { rel_tol = rtol; }
+   void SetAbsTol(double atol) { abs_tol = atol; }
+
+   virtual double Eval(const Vector &err, const Vector &x0,
+                       const Vector &x1) const;
+};
+
+
+/** An adaptive explicit Runge-Kutta method based on an embedded pair, given
+    by a Butcher tableau with two sets of weights:
+    +--------+-------------------------+
+    | c[0]   | a[0]                    |
+    | c[1]   | a[1] a[2]               |
+    | ...    |    ...                  |
+    | c[s-2] | ...   a[s(s-1)/2-1]     |
+    +--------+-------------------------+
+    |        | b[0]  b[1]  ... b[s-1]  |
+    |        | bh[0] bh[1] ... bh[s-1] |
+    +--------+-------------------------+
+    The weights b advance the solution and the embedded weights bh provide the
+    local error estimate, measured in an ODEErrorNorm. The step size is chosen
+    by a PI controller.
+
+    Each call to Step() performs one accepted step, retrying with a smaller
+    step size after each rejected attempt. On return, @a t is advanced by the
+    accepted step size, which can be queried with GetLastStepSize(), and
+    @a dt holds the step size proposed for the next step, so consecutive calls
+    with the returned @a dt follow the controller. Run() limits the last step
+    to end exactly at the final time. */
+class EmbeddedRKSolver : public ODESolver
+{
+protected:
+   int s, order;
+   const double *a, *b, *bh, *c;
+   bool fsal, k0_valid;
+   Vector y, err, *k;
+
+   WeightedRMSErrorNorm default_norm;
+   const ODEErrorNorm *norm;
+
+   double safety, min_factor, max_factor, alpha, beta;
+   double dt_min, dt_max, err_old, dt_last;
+   int max_rejects, num_accepted, num_rejected;
+
+   /// Compute the stages k[1..s-1] and the new solution y from x and k[0].
+   void ComputeStages(const Vector &x, double t, double dt);
+
+public:
+   /** @param[in] _s      Number of stages.
+       @param[in] _order  Order of the lower order method of the pair, used to
+                          set the controller exponents.
+       @param[in] _fsal   The last stage is evaluated at the new solution
+                          (first same as last), so it is reused as the first
+                          stage of the next step. */
+   EmbeddedRKSolver(int _s, int _order, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, bool _fsal = false);
+
+   /// Set the tolerances of the default weighted RMS error norm.
+   void SetTolerances(double rtol, double atol)
+   { default_norm.SetRelTol(rtol); default_norm.SetAbsTol(atol); }
+
+   /** @brief Use the user-supplied norm @a _norm to measure the local error,
+       instead of the default WeightedRMSErrorNorm. The object is not owned. */
+   void SetErrorNorm(const ODEErrorNorm &_norm) { norm = &_norm; }
+
+   /** @brief Set the PI controller parameters: the new step size is
+       dt*safety*err^(-alpha)*err_old^(beta), limited to the range
+       [min_factor, max_factor]*dt. */
+   void SetControllerParameters(double _safety, double _alpha, double _beta,
+                                double _min_factor = 0.2,
+                                double _max_factor = 5.0);
+
+   /// Set the bounds on the step size; Step() fails if dt drops below dt_min.
+   void SetStepSizeBounds(double _dt_min, double _dt_max)
+   { dt_min = _dt_min; dt_max = _dt_max; }
+
+   /// Set the maximum number of consecutive rejected attempts in one Step().
+   void SetMaxRejectedSteps(int max_rej) { max_rejects = max_rej; }
+
+   /// Return the number of accepted steps since the last Init().
+   int GetNumAcceptedSteps() const { return num_accepted; }
+
+   /// Return the number of rejected steps since the last Init().
+   int GetNumRejectedSteps() const { return num_rejected; }
+
+   /// Return the size of the last accepted step.
+   double GetLastStepSize() const { return dt_last; }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/** The 4-stage, 3rd order Bogacki-Shampine method with embedded 2nd order
+    error estimate (FSAL). */
+class BogackiShampine32Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], bh[4], c[3];
+
+public:
+   BogackiShampine32Solver()
+      : EmbeddedRKSolver(4, 2, a, b, bh, c, true) { }
+};
+
+
+/** The 7-stage, 5th order Dormand-Prince method with embedded 4th order error
+    estimate (FSAL). */
+class DormandPrince54Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], bh[7], c[6];
+
+public:
+   DormandPrince54Solver()
+      : EmbeddedRKSolver(7, 4, a, b, bh, c, true) { }
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -281,6 +516,69 @@ public:
 };
 
 
+/** An implicit-explicit (IMEX) additive Runge-Kutta method for operators
+    split as f = f_E + f_I, see SplitTimeDependentOperator. The explicit part
+    is integrated with the tableau (aE, bE, c) and the implicit part with the
+    diagonally implicit tableau (aI, bI, c), both given as dense s x s arrays
+    in row-major order. The first stage is explicit, i.e. aI[0] = 0, so each
+    of the remaining stages requires one call to ImplicitPartSolve(). */
+class IMEXRKSolver : public ODESolver
+{
+protected:
+   int s;
+   const double *aE, *aI, *bE, *bI, *c;
+   SplitTimeDependentOperator *split;
+   Vector y, *kE, *kI;
+
+public:
+   IMEXRKSolver(int _s, const double *_aE, const double *_aI,
+                const double *_bE, const double *_bI, const double *_c);
+
+   /// The operator @a _f must be a SplitTimeDependentOperator.
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual ~IMEXRKSolver();
+};
+
+
+/** The 3-stage, 2nd order IMEX method ARS(2,2,2) of Ascher, Ruuth and Spiteri,
+    with an L-stable implicit part. */
+class IMEXARK2Solver : public IMEXRKSolver
+{
+private:
+   static const double aE[9], aI[9], bE[3], bI[3], c[3];
+
+public:
+   IMEXARK2Solver() : IMEXRKSolver(3, aE, aI, bE, bI, c) { }
+};
+
+
+/** The 4-stage, 3rd order ARK3(2)4L[2]SA method of Kennedy and Carpenter,
+    with an L-stable, stiffly accurate implicit part. */
+class IMEXARK3Solver : public IMEXRKSolver
+{
+private:
+   static const double aE[16], aI[16], b[4], c[4];
+
+public:
+   IMEXARK3Solver() : IMEXRKSolver(4, aE, aI, b, b, c) { }
+};
+
+
+/** The 6-stage, 4th order ARK4(3)6L[2]SA method of Kennedy and Carpenter,
+    with an L-stable, stiffly accurate implicit part. */
+class IMEXARK4Solver : public IMEXRKSolver
+{
+private:
+   static const double aE[36], aI[36], b[6], c[6];
+
+public:
+   IMEXARK4Solver() : IMEXRKSolver(6, aE, aI, b, b, c) { }
+};
+
+
 /// Generalized-alpha ODE solver from "A generalized-α method for integrating
 /// the filtered Navier–Stokes equations with a stabilized finite element
 /// method" by K.E. Jansen, C.H. Whiting and G.M. Hulbert.
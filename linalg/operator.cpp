@@ -20,6 +20,16 @@
 namespace mfem
 {
 
+void Operator::ArrayMult(const Array<const Vector *> &X,
+                         Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible arrays of vectors");
+   for (int i = 0; i < X.Size(); i++)
+   {
+      Mult(*X[i], *Y[i]);
+   }
+}
+
 void Operator::FormLinearSystem(const Array<int> &ess_tdof_list,
                                 Vector &x, Vector &b,
                                 Operator* &Aout, Vector &X, Vector &B,
@@ -69,6 +69,14 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { mfem_error("Operator::MultTranspose() is not overloaded!"); }
 
+   /// Operator application on a set of vectors: `Y[i]=A(X[i])`.
+   /** The default implementation calls Mult() for each pair of vectors.
+       Derived classes can overload this method to apply the operator to all
+       vectors with a single pass over the operator data, see e.g.
+       SparseMatrix::ArrayMult(). */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /** @brief Evaluate the gradient operator at the point @a x. The default
        behavior in class Operator is to generate an error. */
    virtual Operator &GetGradient(const Vector &x) const
@@ -256,6 +264,23 @@ public:
       mfem_error("TimeDependentOperator::Mult() is not overridden!");
    }
 
+   /** @brief Perform the fused update @a y = @a a @a y + @a b f(@a x, t),
+       where t is the current time; if @a a is zero, the input @a y is not
+       used.
+
+       This method is used by low-storage Runge-Kutta methods. The default
+       implementation evaluates Mult() into the temporary vector @a tmp and
+       combines the result with @a y. Operators that can accumulate their
+       action directly into @a y may re-implement it and ignore @a tmp, saving
+       a pass over the data. The vectors @a x and @a y must be different. */
+   virtual void ScaleAddMult(double a, double b, const Vector &x, Vector &y,
+                             Vector &tmp) const
+   {
+      Mult(x, tmp);
+      if (a == 0.0) { y.Set(b, tmp); }
+      else { add(a, y, b, tmp, y); }
+   }
+
    /** @brief Solve the equation: @a k = f(@a x + @a dt @a k, t), for the
        unknown @a k at the current time t.
 
@@ -305,6 +330,51 @@ public:
    virtual ~TimeDependentOperator() { }
 };
 
+/** @brief Base abstract class for time dependent operators split into an
+    explicit (nonstiff) part and an implicit (stiff) part, used by implicit-
+    explicit (IMEX) time integrators. */
+/** Operator of the form: (x,t) -> f(x,t) = f_E(x,t) + f_I(x,t). IMEX methods
+    evaluate f_E explicitly and only solve implicit equations with f_I, see
+    ImplicitPartSolve(). */
+class SplitTimeDependentOperator : public TimeDependentOperator
+{
+protected:
+   mutable Vector tmp; ///< Auxiliary vector used by Mult().
+
+public:
+   /** @brief Construct a "square" SplitTimeDependentOperator y = f(x,t),
+       where x and y have the same dimension @a n. */
+   explicit SplitTimeDependentOperator(int n = 0, double t_ = 0.0)
+      : TimeDependentOperator(n, t_) { }
+
+   /** @brief Perform the action of the explicit part of the operator:
+       @a y = f_E(@a x, t) where t is the current time. */
+   virtual void ExplicitPartMult(const Vector &x, Vector &y) const = 0;
+
+   /** @brief Perform the action of the implicit part of the operator:
+       @a y = f_I(@a x, t) where t is the current time. */
+   virtual void ImplicitPartMult(const Vector &x, Vector &y) const = 0;
+
+   /** @brief Solve the equation: @a k = f_I(@a x + @a dt @a k, t), for the
+       unknown @a k at the current time t.
+
+       This is the analogue of TimeDependentOperator::ImplicitSolve() for the
+       implicit part of the operator only. */
+   virtual void ImplicitPartSolve(const double dt, const Vector &x,
+                                  Vector &k) = 0;
+
+   /// Perform the action of the full operator: @a y = f_E + f_I.
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      tmp.SetSize(y.Size());
+      ExplicitPartMult(x, y);
+      ImplicitPartMult(x, tmp);
+      y += tmp;
+   }
+
+   virtual ~SplitTimeDependentOperator() { }
+};
+
 /// Base class for solvers
 class Solver : public Operator
 {
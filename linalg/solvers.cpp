@@ -64,6 +64,16 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::GlobalSum(double *vals, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type == 1)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, vals, n, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -355,17 +365,18 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    for (i = 1; true; )
    {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
-
+      //  x = x + alpha d,  r = r - alpha A d
       if (prec)
       {
+         // the fused update would also compute (r, r), which is not needed
+         x.Add(alpha, d);
+         r.Add(-alpha, z);
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         betanom = GlobalSum(CGUpdate(alpha, d, z, x, r)); // (r, r)
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -445,6 +456,205 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    final_norm = sqrt(betanom);
 }
 
+void CGSolver::ArrayMult(const Array<const Vector *> &B,
+                         Array<Vector *> &X) const
+{
+   const int nrhs = B.Size();
+   MFEM_VERIFY(X.Size() == nrhs, "incompatible arrays of vectors");
+
+   Array<Vector *> R(nrhs), D(nrhs), Z(nrhs);
+   for (int k = 0; k < nrhs; k++)
+   {
+      R[k] = new Vector(width);
+      D[k] = new Vector(width);
+      Z[k] = new Vector(width);
+   }
+   Vector nom(nrhs), nom0(nrhs), den(nrhs), r0(nrhs);
+   Array<int> iters(nrhs), conv(nrhs), active;
+   Array<const Vector *> act_in;
+   Array<Vector *> act_out;
+
+   // Apply 'op' to the vectors In[k] for all k in 'active'.
+   auto apply = [&](const Operator &op, const Array<Vector *> &In,
+                    Array<Vector *> &Out)
+   {
+      act_in.SetSize(active.Size());
+      act_out.SetSize(active.Size());
+      for (int a = 0; a < active.Size(); a++)
+      {
+         act_in[a] = In[active[a]];
+         act_out[a] = Out[active[a]];
+      }
+      op.ArrayMult(act_in, act_out);
+   };
+
+   for (int k = 0; k < nrhs; k++) { active.Append(k); }
+   if (iterative_mode)
+   {
+      apply(*oper, X, R);
+      for (int k = 0; k < nrhs; k++)
+      {
+         subtract(*B[k], *R[k], *R[k]); // r = b - A x
+      }
+   }
+   else
+   {
+      for (int k = 0; k < nrhs; k++)
+      {
+         *R[k] = *B[k];
+         *X[k] = 0.0;
+      }
+   }
+   if (prec) { apply(*prec, R, Z); } // z = B r
+
+   int i, num_active = 0;
+   for (int k = 0; k < nrhs; k++)
+   {
+      *D[k] = prec ? *Z[k] : *R[k];
+      nom0(k) = nom(k) = Dot(*D[k], *R[k]);
+      MFEM_ASSERT(IsFinite(nom(k)), "nom = " << nom(k));
+      r0(k) = std::max(nom(k)*rel_tol*rel_tol, abs_tol*abs_tol);
+      iters[k] = 0;
+      conv[k] = 1;
+      if (nom(k) > r0(k)) { active[num_active++] = k; }
+   }
+   active.SetSize(num_active);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+                << nom0.Max() << "  active : " << active.Size()
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   apply(*oper, D, Z); // z = A d
+   for (int a = 0; a < active.Size(); a++)
+   {
+      const int k = active[a];
+      den(k) = Dot(*Z[k], *D[k]);
+      MFEM_ASSERT(IsFinite(den(k)), "den = " << den(k));
+   }
+
+   for (i = 1; active.Size() > 0; )
+   {
+      num_active = 0;
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         if (den(k) <= 0.0)
+         {
+            if (Dot(*D[k], *D[k]) > 0.0 && print_level >= 0)
+            {
+               mfem::out << "PCG: The operator is not positive definite. "
+                         << "(Ad, d) = " << den(k) << " for rhs " << k << '\n';
+            }
+            if (den(k) == 0.0) { conv[k] = 0; continue; }
+         }
+         const double alpha = nom(k)/den(k);
+         X[k]->Add(alpha, *D[k]);  //  x = x + alpha d
+         R[k]->Add(-alpha, *Z[k]); //  r = r - alpha A d
+         active[num_active++] = k;
+      }
+      active.SetSize(num_active);
+
+      if (prec) { apply(*prec, R, Z); } //  z = B r
+
+      double max_betanom = 0.0;
+      num_active = 0;
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         const double betanom = prec ? Dot(*R[k], *Z[k]) : Dot(*R[k], *R[k]);
+         MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
+         max_betanom = std::max(max_betanom, betanom);
+         iters[k] = i;
+         if (betanom < r0(k))
+         {
+            nom(k) = betanom;
+            continue;
+         }
+         if (i >= max_iter)
+         {
+            conv[k] = 0;
+            nom(k) = betanom;
+            continue;
+         }
+         const double beta = betanom/nom(k);
+         add(prec ? *Z[k] : *R[k], beta, *D[k], *D[k]); //  d = z + beta d
+         nom(k) = betanom;
+         active[num_active++] = k;
+      }
+      active.SetSize(num_active);
+
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+                   << max_betanom << "  active : " << active.Size() << '\n';
+      }
+      if (active.Size() == 0) { break; }
+      i++;
+
+      apply(*oper, D, Z);      //  z = A d
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         den(k) = Dot(*D[k], *Z[k]);
+         MFEM_ASSERT(IsFinite(den(k)), "den = " << den(k));
+      }
+   }
+
+   converged = 1;
+   final_iter = 0;
+   double max_nom = 0.0;
+   for (int k = 0; k < nrhs; k++)
+   {
+      if (!conv[k]) { converged = 0; }
+      final_iter = std::max(final_iter, iters[k]);
+      max_nom = std::max(max_nom, nom(k));
+      delete Z[k];
+      delete D[k];
+      delete R[k];
+   }
+   final_norm = sqrt(max_nom);
+
+   if (print_level == 2 || print_level == 3)
+   {
+      mfem::out << "Number of PCG iterations: " << final_iter << " (max over "
+                << nrhs << " right-hand sides)\n";
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "PCG: No convergence!" << '\n';
+   }
+}
+
+// Call the ArrayMult() method of 'op' with the columns of B and X.
+static void ColumnArrayMult(const Operator &op, const DenseMatrix &B,
+                            DenseMatrix &X)
+{
+   const int nrhs = B.Width();
+   X.SetSize(op.Width(), nrhs);
+   MFEM_VERIFY(B.Height() == op.Height(), "incompatible dimensions");
+
+   Vector *cols = new Vector[2*nrhs];
+   Array<const Vector *> b(nrhs);
+   Array<Vector *> x(nrhs);
+   for (int k = 0; k < nrhs; k++)
+   {
+      const_cast<DenseMatrix &>(B).GetColumnReference(k, cols[k]);
+      X.GetColumnReference(k, cols[nrhs+k]);
+      b[k] = &cols[k];
+      x[k] = &cols[nrhs+k];
+   }
+   op.ArrayMult(b, x);
+   delete [] cols;
+}
+
+void CGSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   ColumnArrayMult(*this, B, X);
+}
+
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter, int max_num_iter,
         double RTOLERANCE, double ATOLERANCE)
@@ -473,116 +683,1217 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
-inline void GeneratePlaneRotation(double &dx, double &dy,
-                                  double &cs, double &sn)
+// Delete the vectors in @a v and set its size to 0.
+static void DeleteVectors(Array<Vector *> &v)
 {
-   if (dy == 0.0)
+   for (int i = 0; i < v.Size(); i++) { delete v[i]; }
+   v.SetSize(0);
+}
+
+// Set the columns of the new vectors @a V to V[j] = sum_i Z[i] Y(i,j).
+static void LinearCombination(const Array<Vector *> &Z, const DenseMatrix &Y,
+                              Array<Vector *> &V)
+{
+   const int n = Z[0]->Size();
+   V.SetSize(Y.Width());
+   for (int j = 0; j < Y.Width(); j++)
+   {
+      V[j] = new Vector(n);
+      *V[j] = 0.0;
+      for (int i = 0; i < Y.Height(); i++) { V[j]->Add(Y(i,j), *Z[i]); }
+   }
+}
+
+// Orthonormalize the columns of Y with the modified Gram-Schmidt method in the
+// inner product defined by the SPD matrix @a M, or the Euclidean inner product
+// if @a M is NULL.
+static void SmallOrthonormalize(DenseMatrix &Y, const DenseMatrix *M = NULL)
+{
+   const int p = Y.Height(), k = Y.Width();
+   Vector MYj(p), Yi, Yj;
+   for (int j = 0; j < k; j++)
+   {
+      Y.GetColumnReference(j, Yj);
+      for (int i = 0; i <= j; i++)
+      {
+         if (M) { M->Mult(Yj, MYj); }
+         else { MYj = Yj; }
+         if (i < j)
+         {
+            Y.GetColumnReference(i, Yi);
+            Yj.Add(-(Yi * MYj), Yi);
+         }
+         else
+         {
+            const double nrm = sqrt(Yj * MYj);
+            if (nrm > 0.0) { Yj /= nrm; }
+         }
+      }
+   }
+}
+
+// Compute in Y an orthonormal basis of an approximate invariant subspace of the
+// pencil A y = theta B y, associated with the k eigenvalues theta of smallest
+// magnitude. This is done with subspace iteration with A^{-1} B, so A must be
+// invertible. Complex conjugate eigenvalues are represented by a real basis of
+// their invariant subspace.
+static void SmallestEigenSubspace(const DenseMatrix &A, const DenseMatrix &B,
+                                  int k, DenseMatrix &Y)
+{
+   const int p = A.Height();
+   const int max_it = 200;
+   DenseMatrixInverse Ainv(A);
+   DenseMatrix BY(p, k), Z(p, k), YtZ(k);
+   Y.SetSize(p, k);
+   for (int j = 0; j < k; j++)
+   {
+      Vector col;
+      Y.GetColumnReference(j, col);
+      col.Randomize(j+1);
+   }
+   SmallOrthonormalize(Y);
+   for (int it = 0; it < max_it; it++)
+   {
+      Mult(B, Y, BY);
+      Ainv.Mult(BY, Z);
+      SmallOrthonormalize(Z);
+      // sum of the squared sines of the angles between the subspaces
+      MultAtB(Y, Z, YtZ);
+      const double dist = k - YtZ.FNorm2();
+      Y = Z;
+      if (dist < 1e-20*k) { break; }
+   }
+}
+
+void DeflatedCGSolver::SetRecycleDim(int k, int l)
+{
+   MFEM_VERIFY(k >= 0, "invalid dimension of the deflation subspace: " << k);
+   rdim = k;
+   ndir = (l < 0) ? 2*k : l;
+   if (W.Size() > rdim) { ResetRecycleSpace(); }
+}
+
+void DeflatedCGSolver::ResetRecycleSpace()
+{
+   DeleteVectors(W);
+   DeleteVectors(AW);
+   DeleteVectors(Y);
+   DeleteVectors(AY);
+   DeleteVectors(P);
+   DeleteVectors(AP);
+   DeleteVectors(BAP);
+   WtAW.SetSize(0);
+   WtAWinv.SetSize(0);
+   AWtBAW.SetSize(0);
+   update_aw = false;
+}
+
+void DeflatedCGSolver::SetPreconditioner(Solver &pr)
+{
+   CGSolver::SetPreconditioner(pr);
+   update_aw = true;
+}
+
+void DeflatedCGSolver::SetOperator(const Operator &op)
+{
+   CGSolver::SetOperator(op);
+   q.SetSize(width);
+   if (W.Size() > 0 && W[0]->Size() != width) { ResetRecycleSpace(); }
+   update_aw = true;
+}
+
+void DeflatedCGSolver::DeflationCoefficients(const Array<Vector *> &V,
+                                             const Vector &y,
+                                             Vector &c) const
+{
+   const int k = V.Size();
+   Vector Vty(k);
+   for (int i = 0; i < k; i++) { Vty(i) = (*V[i]) * y; }
+   GlobalSum(Vty.GetData(), k);
+   c.SetSize(k);
+   WtAWinv.Mult(Vty, c);
+}
+
+void DeflatedCGSolver::FactorWtAW() const
+{
+   const int k = W.Size();
+   WtAW.SetSize(k);
+   for (int j = 0; j < k; j++)
+   {
+      for (int i = 0; i <= j; i++) { WtAW(i,j) = (*W[i]) * (*AW[j]); }
+   }
+   GlobalSum(WtAW.Data(), k*k);
+   for (int j = 0; j < k; j++)
+   {
+      for (int i = j+1; i < k; i++) { WtAW(i,j) = WtAW(j,i); }
+   }
+   DenseMatrixInverse(WtAW).GetInverseMatrix(WtAWinv);
+}
+
+void DeflatedCGSolver::UpdateProducts() const
+{
+   const int k = W.Size();
+   Vector BAWj(prec ? width : 0);
+   AWtBAW.SetSize(k);
+   for (int j = 0; j < k; j++)
+   {
+      oper->Mult(*W[j], *AW[j]);
+   }
+   for (int j = 0; j < k; j++)
+   {
+      if (prec) { prec->Mult(*AW[j], BAWj); }
+      const Vector &baw = prec ? BAWj : *AW[j];
+      for (int i = 0; i < k; i++) { AWtBAW(i,j) = (*AW[i]) * baw; }
+   }
+   GlobalSum(AWtBAW.Data(), k*k);
+   AWtBAW.Symmetrize();
+   FactorWtAW();
+   update_aw = false;
+}
+
+void DeflatedCGSolver::UpdateRecycleSpace(int np) const
+{
+   // Z = [Y, P], where Y is the current subspace for the next solve, or W
+   const bool first = (Y.Size() == 0);
+   const Array<Vector *> &Y0 = first ? W : Y, &AY0 = first ? AW : AY;
+   const int k = Y0.Size(), p = k + np;
+   Array<Vector *> Z(p), AZ(p);
+   for (int j = 0; j < p; j++)
+   {
+      Z[j] = (j < k) ? Y0[j] : P[j-k];
+      AZ[j] = (j < k) ? AY0[j] : AP[j-k];
+   }
+
+   // Harmonic Ritz values of B A in span(Z): G y = theta F y with the SPD
+   // matrices F = Z^t A Z and G = (A Z)^t B (A Z). Since the search directions
+   // are A-orthogonal to each other and to Y, F is block diagonal.
+   DenseMatrix F(p), G(p);
+   F = 0.0;
+   G = 0.0;
+   if (first)
+   {
+      F.CopyMN(WtAW, 0, 0);
+      G.CopyMN(AWtBAW, 0, 0);
+   }
+   else
+   {
+      for (int j = 0; j < k; j++) { F(j,j) = 1.0; }
+      G.CopyMN(AYtBAY, 0, 0);
+   }
+   for (int j = 0; j < np; j++) { F(k+j,k+j) = PtAP(j); }
+   // the new columns of G
+   Vector buf(p*np);
+   for (int j = 0; j < np; j++)
+   {
+      const Vector &bap = prec ? *BAP[j] : *AP[j];
+      for (int i = 0; i <= k+j; i++) { buf(i+j*p) = (*AZ[i]) * bap; }
+   }
+   GlobalSum(buf.GetData(), p*np);
+   for (int j = 0; j < np; j++)
+   {
+      for (int i = 0; i <= k+j; i++) { G(i,k+j) = G(k+j,i) = buf(i+j*p); }
+   }
+
+   // the new subspace is A-orthonormal
+   DenseMatrix Yc, GYc;
+   SmallestEigenSubspace(G, F, std::min(rdim, p), Yc);
+   SmallOrthonormalize(Yc, &F);
+   Array<Vector *> Yn, AYn;
+   LinearCombination(Z, Yc, Yn);
+   LinearCombination(AZ, Yc, AYn);
+   GYc.SetSize(p, Yc.Width());
+   mfem::Mult(G, Yc, GYc);
+   AYtBAY.SetSize(Yc.Width());
+   MultAtB(Yc, GYc, AYtBAY);
+
+   if (!first)
+   {
+      DeleteVectors(Y);
+      DeleteVectors(AY);
+   }
+   Yn.Copy(Y);
+   AYn.Copy(AY);
+}
+
+void DeflatedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   int i, np = 0;
+   double r0, den, nom, nom0, betanom, alpha, beta;
+   const int k = W.Size();
+   Vector c;
+
+   if (k > 0 && update_aw) { UpdateProducts(); }
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   if (k > 0)
+   {
+      // x += W (W^t A W)^{-1} W^t r,  r = b - A x
+      DeflationCoefficients(W, r, c);
+      for (int l = 0; l < k; l++)
+      {
+         x.Add(c(l), *W[l]);
+         r.Add(-c(l), *AW[l]);
+      }
+   }
+
+   if (prec)
+   {
+      prec->Mult(r, z); // z = B r
+   }
+   else
+   {
+      z = r;
+   }
+   d = z;
+   if (k > 0)
+   {
+      // d = z - W (W^t A W)^{-1} (A W)^t z
+      DeflationCoefficients(AW, z, c);
+      for (int l = 0; l < k; l++) { d.Add(-c(l), *W[l]); }
+   }
+   nom0 = nom = Dot(z, r);
+   MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                << nom << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+   if (nom <= r0)
+   {
+      converged = 1;
+      final_iter = 0;
+      final_norm = sqrt(nom);
+      return;
+   }
+
+   oper->Mult(d, q);  // q = A d
+   den = Dot(q, d);
+   MFEM_ASSERT(IsFinite(den), "den = " << den);
+   if (den <= 0.0)
+   {
+      if (Dot(d, d) > 0.0 && print_level >= 0)
+      {
+         mfem::out << "DCG: The operator is not positive definite. (Ad, d) = "
+                   << den << '\n';
+      }
+      if (den == 0.0)
+      {
+         converged = 0;
+         final_iter = 0;
+         final_norm = sqrt(nom);
+         return;
+      }
+   }
+
+   // start iteration
+   const bool recycle = (rdim > 0 && ndir > 0);
+   if (recycle)
+   {
+      for (int l = P.Size(); l < ndir; l++)
+      {
+         P.Append(new Vector(width));
+         AP.Append(new Vector(width));
+      }
+      for (int l = BAP.Size(); prec && l < ndir; l++)
+      {
+         BAP.Append(new Vector(width));
+      }
+      PtAP.SetSize(ndir);
+   }
+   converged = 0;
+   final_iter = max_iter;
+   for (i = 1; true; )
+   {
+      alpha = nom/den;
+      if (recycle)
+      {
+         // save the search direction for the update of the subspace
+         *P[np] = d;
+         *AP[np] = q;
+         PtAP(np) = den;
+         if (prec) { *BAP[np] = z; }
+      }
+
+      //  x = x + alpha d,  r = r - alpha A d
+      if (prec)
+      {
+         x.Add(alpha, d);
+         r.Add(-alpha, q);
+         prec->Mult(r, z);      //  z = B r
+         betanom = Dot(r, z);
+      }
+      else
+      {
+         betanom = GlobalSum(CGUpdate(alpha, d, q, x, r)); // (r, r)
+         z = r;
+      }
+      MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
+      if (recycle)
+      {
+         // B A d = (z_old - z_new) / alpha
+         if (prec) { add(1.0/alpha, *BAP[np], -1.0/alpha, z, *BAP[np]); }
+         if (++np == ndir)
+         {
+            UpdateRecycleSpace(np);
+            np = 0;
+         }
+      }
+
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+
+      if (betanom < r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of DCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << betanom << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+
+      if (++i > max_iter)
+      {
+         break;
+      }
+
+      beta = betanom/nom;
+      add(z, beta, d, d);   //  d = z + beta d
+      if (k > 0)
+      {
+         DeflationCoefficients(AW, z, c);
+         for (int l = 0; l < k; l++) { d.Add(-c(l), *W[l]); }
+      }
+      oper->Mult(d, q);       //  q = A d
+      den = Dot(d, q);
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (Dot(d, d) > 0.0 && print_level >= 0)
+         {
+            mfem::out << "DCG: The operator is not positive definite. (Ad, d) = "
+                      << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      nom = betanom;
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+      mfem::out << "DCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (betanom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(betanom);
+
+   // the updated subspace becomes the deflation subspace of the next solve
+   if (np > 0) { UpdateRecycleSpace(np); }
+   if (Y.Size() > 0)
+   {
+      DeleteVectors(W);
+      DeleteVectors(AW);
+      Y.Copy(W);
+      AY.Copy(AW);
+      Y.SetSize(0);
+      AY.SetSize(0);
+      AWtBAW = AYtBAY;
+      FactorWtAW();
+   }
+}
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   w.SetSize(width);
+   n.SetSize(width);
+   z.SetSize(width);
+   s.SetSize(width);
+   p.SetSize(width);
+   if (prec)
+   {
+      u.SetSize(width);
+      m.SetSize(width);
+      q.SetSize(width);
+   }
+}
+
+void PipelinedCGSolver::StartReduction(double *buf, int num) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type == 1)
+   {
+      MPI_Iallreduce(MPI_IN_PLACE, buf, num, MPI_DOUBLE, MPI_SUM, comm,
+                     &request);
+   }
+#endif
+}
+
+void PipelinedCGSolver::FinishReduction() const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type == 1)
+   {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Preconditioned pipelined CG following Algorithm 4 in Ghysels and
+   // Vanroose, Parallel Computing 40 (2014). Without a preconditioner the
+   // vectors u, m and q coincide with r, w and s, respectively.
+   int i;
+   double r0 = 0.0, nom0 = 0.0, nom = 0.0, betanom = 0.0, den;
+   double alpha = 0.0, beta, delta;
+   double dots[2];
+
+   Vector &uu = prec ? u : r;
+   Vector &mm = prec ? m : w;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u); // u = B r
+   }
+   oper->Mult(uu, w);   // w = A u
+
+   converged = 0;
+   final_iter = max_iter;
+   for (i = 0; true; i++)
+   {
+      // Single (global) reduction for (B r, r) and (A B r, B r), overlapped
+      // with the preconditioner and operator applications below.
+      dots[0] = r * uu;
+      dots[1] = w * uu;
+      StartReduction(dots, 2);
+
+      if (prec)
+      {
+         prec->Mult(w, m); // m = B w
+      }
+      oper->Mult(mm, n);   // n = A m
+
+      FinishReduction();
+      betanom = dots[0];
+      delta = dots[1];
+      MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
+
+      if (i == 0)
+      {
+         nom0 = nom = betanom;
+         if (print_level == 1 || print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom << (print_level == 3 ? " ...\n" : "\n");
+         }
+         r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+         if (nom <= r0)
+         {
+            converged = 1;
+            final_iter = 0;
+            final_norm = sqrt(nom);
+            return;
+         }
+      }
+      else
+      {
+         if (print_level == 1)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << betanom << '\n';
+         }
+         if (betanom < r0)
+         {
+            if (print_level == 2)
+            {
+               mfem::out << "Number of Pipelined PCG iterations: " << i << '\n';
+            }
+            else if (print_level == 3)
+            {
+               mfem::out << "   Iteration : " << setw(3) << i
+                         << "  (B r, r) = " << betanom << '\n';
+            }
+            converged = 1;
+            final_iter = i;
+            break;
+         }
+         if (i >= max_iter)
+         {
+            break;
+         }
+      }
+
+      if (i == 0)
+      {
+         beta = 0.0;
+         den = delta;
+      }
+      else
+      {
+         beta = betanom/nom;
+         den = delta - beta*betanom/alpha; // = (A d, d)
+      }
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "Pipelined PCG: The operator is not positive definite."
+                      << " (Ad, d) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = betanom/den;
+      nom = betanom;
+
+      if (i == 0)
+      {
+         z = n;
+         s = w;
+         p = uu;
+         if (prec) { q = m; }
+      }
+      else
+      {
+         add(n, beta, z, z);    //  z = n + beta z
+         add(w, beta, s, s);    //  s = w + beta s
+         add(uu, beta, p, p);   //  p = u + beta p
+         if (prec) { add(m, beta, q, q); } //  q = m + beta q
+      }
+      x.Add(alpha, p);          //  x = x + alpha p
+      r.Add(-alpha, s);         //  r = r - alpha s
+      if (prec) { u.Add(-alpha, q); } //  u = u - alpha q
+      w.Add(-alpha, z);         //  w = w - alpha z
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+      mfem::out << "Pipelined PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (betanom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(betanom);
+}
+
+
+inline void GeneratePlaneRotation(double &dx, double &dy,
+                                  double &cs, double &sn)
+{
+   if (dy == 0.0)
+   {
+      cs = 1.0;
+      sn = 0.0;
+   }
+   else if (fabs(dy) > fabs(dx))
+   {
+      double temp = dx / dy;
+      sn = 1.0 / sqrt( 1.0 + temp*temp );
+      cs = temp * sn;
+   }
+   else
+   {
+      double temp = dy / dx;
+      cs = 1.0 / sqrt( 1.0 + temp*temp );
+      sn = temp * cs;
+   }
+}
+
+inline void ApplyPlaneRotation(double &dx, double &dy, double &cs, double &sn)
+{
+   double temp = cs * dx + sn * dy;
+   dy = -sn * dx + cs * dy;
+   dx = temp;
+}
+
+inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
+                   Array<Vector*> &v)
+{
+   Vector y(s);
+
+   // Backsolve:
+   for (int i = k; i >= 0; i--)
+   {
+      y(i) /= h(i,i);
+      for (int j = i - 1; j >= 0; j--)
+      {
+         y(j) -= h(j,i) * y(i);
+      }
+   }
+
+   for (int j = 0; j <= k; j++)
+   {
+      x.Add(y(j), *v[j]);
+   }
+}
+
+void GMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Generalized Minimum Residual method following the algorithm
+   // on p. 20 of the SIAM Templates book.
+
+   int n = width;
+
+   DenseMatrix H(m+1, m);
+   Vector s(m+1), cs(m+1), sn(m+1);
+   Vector r(n), w(n);
+   Array<Vector *> v;
+
+   double resid;
+   int i, j, k;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+   }
+   else
+   {
+      x = 0.0;
+   }
+
+   if (prec)
+   {
+      if (iterative_mode)
+      {
+         subtract(b, r, w);
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         prec->Mult(b, r);
+      }
+   }
+   else
+   {
+      if (iterative_mode)
+      {
+         subtract(b, r, r);
+      }
+      else
+      {
+         r = b;
+      }
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   final_norm = std::max(rel_tol*beta, abs_tol);
+
+   if (beta <= final_norm)
+   {
+      final_norm = beta;
+      final_iter = 0;
+      converged = 1;
+      goto finish;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   v.SetSize(m+1, NULL);
+
+   for (j = 1; j <= max_iter; )
+   {
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      s = 0.0; s(0) = beta;
+
+      for (i = 0; i < m && j <= max_iter; i++, j++)
+      {
+         if (prec)
+         {
+            oper->Mult(*v[i], r);
+            prec->Mult(r, w);        // w = M A v[i]
+         }
+         else
+         {
+            oper->Mult(*v[i], w);
+         }
+
+         for (k = 0; k <= i; k++)
+         {
+            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
+            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
+         }
+
+         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
+         MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
+         if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+         v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
+
+         for (k = 0; k < i; k++)
+         {
+            ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
+         }
+
+         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+
+         resid = fabs(s(i+1));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+
+         if (resid <= final_norm)
+         {
+            Update(x, i, H, s, v);
+            final_norm = resid;
+            final_iter = j;
+            converged = 1;
+            goto finish;
+         }
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  ||B r|| = " << resid << '\n';
+         }
+      }
+
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      Update(x, i-1, H, s, v);
+
+      oper->Mult(x, r);
+      if (prec)
+      {
+         subtract(b, r, w);
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         subtract(b, r, r);
+      }
+      beta = Norm(r);         // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      if (beta <= final_norm)
+      {
+         final_norm = beta;
+         final_iter = j;
+         converged = 1;
+         goto finish;
+      }
+   }
+
+   final_norm = beta;
+   final_iter = max_iter;
+   converged = 0;
+
+finish:
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GMRES: No convergence!\n";
+   }
+   for (i = 0; i < v.Size(); i++)
+   {
+      delete v[i];
+   }
+}
+
+void GMRESSolver::ArrayMult(const Array<const Vector *> &B,
+                            Array<Vector *> &X) const
+{
+   const int nrhs = B.Size();
+   const int n = width;
+   MFEM_VERIFY(X.Size() == nrhs, "incompatible arrays of vectors");
+
+   // Per right-hand side data: Hessenberg matrix, Givens rotations, Krylov
+   // basis and work vectors.
+   Array<DenseMatrix *> H(nrhs);
+   Array<Vector *> s(nrhs), cs(nrhs), sn(nrhs), R(nrhs), W(nrhs);
+   Array<Array<Vector *> *> V(nrhs);
+   Vector beta(nrhs), norm_goal(nrhs), resid(nrhs);
+   Array<int> iters(nrhs), conv(nrhs), active;
+   Array<const Vector *> act_in;
+   Array<Vector *> act_out, act_tmp;
+
+   // Apply 'op' to the vectors In[k] for all k in 'active'.
+   auto apply = [&](const Operator &op, const Array<Vector *> &In,
+                    Array<Vector *> &Out)
+   {
+      act_in.SetSize(active.Size());
+      act_out.SetSize(active.Size());
+      for (int a = 0; a < active.Size(); a++)
+      {
+         act_in[a] = In[active[a]];
+         act_out[a] = Out[active[a]];
+      }
+      op.ArrayMult(act_in, act_out);
+   };
+
+   // Compute the (preconditioned) residual r = M (b - A x) of the active
+   // right-hand sides.
+   auto residual = [&]()
+   {
+      apply(*oper, X, R);
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         subtract(*B[k], *R[k], prec ? *W[k] : *R[k]);
+      }
+      if (prec) { apply(*prec, W, R); }
+   };
+
+   for (int k = 0; k < nrhs; k++)
+   {
+      H[k] = new DenseMatrix(m+1, m);
+      s[k] = new Vector(m+1);
+      cs[k] = new Vector(m+1);
+      sn[k] = new Vector(m+1);
+      R[k] = new Vector(n);
+      W[k] = new Vector(n);
+      V[k] = new Array<Vector *>(m+1);
+      for (int i = 0; i <= m; i++) { (*V[k])[i] = NULL; }
+      active.Append(k);
+   }
+
+   if (iterative_mode)
+   {
+      residual();
+   }
+   else
+   {
+      for (int k = 0; k < nrhs; k++) { *X[k] = 0.0; }
+      if (prec)
+      {
+         for (int k = 0; k < nrhs; k++) { *W[k] = *B[k]; }
+         apply(*prec, W, R);
+      }
+      else
+      {
+         for (int k = 0; k < nrhs; k++) { *R[k] = *B[k]; }
+      }
+   }
+
+   int num_active = 0;
+   for (int k = 0; k < nrhs; k++)
+   {
+      beta(k) = Norm(*R[k]);
+      MFEM_ASSERT(IsFinite(beta(k)), "beta = " << beta(k));
+      norm_goal(k) = std::max(rel_tol*beta(k), abs_tol);
+      resid(k) = beta(k);
+      iters[k] = 0;
+      conv[k] = 1;
+      if (beta(k) > norm_goal(k)) { active[num_active++] = k; }
+   }
+   active.SetSize(num_active);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  max ||B r|| = " << beta.Max()
+                << "  active : " << active.Size()
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i, j;
+   for (j = 1; j <= max_iter && active.Size() > 0; )
+   {
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         Array<Vector *> &v = *V[k];
+         if (v[0] == NULL) { v[0] = new Vector(n); }
+         v[0]->Set(1.0/beta(k), *R[k]);
+         *s[k] = 0.0; (*s[k])(0) = beta(k);
+      }
+
+      for (i = 0; i < m && j <= max_iter && active.Size() > 0; i++, j++)
+      {
+         // Gather the i-th Krylov vectors of the active right-hand sides and
+         // apply the (preconditioned) operator to all of them at once.
+         act_tmp.SetSize(nrhs);
+         for (int a = 0; a < active.Size(); a++)
+         {
+            const int k = active[a];
+            act_tmp[k] = (*V[k])[i];
+         }
+         if (prec)
+         {
+            apply(*oper, act_tmp, R);
+            apply(*prec, R, W);      // w = M A v[i]
+         }
+         else
+         {
+            apply(*oper, act_tmp, W);
+         }
+
+         num_active = 0;
+         for (int a = 0; a < active.Size(); a++)
+         {
+            const int k = active[a];
+            Array<Vector *> &v = *V[k];
+            DenseMatrix &h = *H[k];
+            Vector &w = *W[k];
+            for (int l = 0; l <= i; l++)
+            {
+               h(l,i) = Dot(w, *v[l]);  // H(l,i) = w * v[l]
+               w.Add(-h(l,i), *v[l]);   // w -= H(l,i) * v[l]
+            }
+            h(i+1,i) = Norm(w);         // H(i+1,i) = ||w||
+            MFEM_ASSERT(IsFinite(h(i+1,i)), "Norm(w) = " << h(i+1,i));
+            if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+            v[i+1]->Set(1.0/h(i+1,i), w); // v[i+1] = w / H(i+1,i)
+
+            for (int l = 0; l < i; l++)
+            {
+               ApplyPlaneRotation(h(l,i), h(l+1,i), (*cs[k])(l), (*sn[k])(l));
+            }
+            GeneratePlaneRotation(h(i,i), h(i+1,i), (*cs[k])(i), (*sn[k])(i));
+            ApplyPlaneRotation(h(i,i), h(i+1,i), (*cs[k])(i), (*sn[k])(i));
+            ApplyPlaneRotation((*s[k])(i), (*s[k])(i+1), (*cs[k])(i),
+                               (*sn[k])(i));
+
+            resid(k) = fabs((*s[k])(i+1));
+            MFEM_ASSERT(IsFinite(resid(k)), "resid = " << resid(k));
+            iters[k] = j;
+            if (resid(k) <= norm_goal(k))
+            {
+               Update(*X[k], i, h, *s[k], v);
+               continue;
+            }
+            active[num_active++] = k;
+         }
+         active.SetSize(num_active);
+
+         if (print_level == 1)
+         {
+            double max_resid = 0.0;
+            for (int a = 0; a < active.Size(); a++)
+            {
+               max_resid = std::max(max_resid, resid(active[a]));
+            }
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  max ||B r|| = " << max_resid
+                      << "  active : " << active.Size() << '\n';
+         }
+      }
+
+      if (active.Size() == 0) { break; }
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         Update(*X[k], i-1, *H[k], *s[k], *V[k]);
+      }
+      residual();
+      num_active = 0;
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int k = active[a];
+         beta(k) = Norm(*R[k]);  // beta = ||r||
+         MFEM_ASSERT(IsFinite(beta(k)), "beta = " << beta(k));
+         resid(k) = beta(k);
+         if (beta(k) <= norm_goal(k)) { continue; }
+         active[num_active++] = k;
+      }
+      active.SetSize(num_active);
+   }
+
+   converged = 1;
+   final_iter = 0;
+   final_norm = 0.0;
+   for (int a = 0; a < active.Size(); a++) { conv[active[a]] = 0; }
+   for (int k = 0; k < nrhs; k++)
    {
-      cs = 1.0;
-      sn = 0.0;
+      if (!conv[k]) { converged = 0; }
+      final_iter = std::max(final_iter, iters[k]);
+      final_norm = std::max(final_norm, resid(k));
+      for (int l = 0; l <= m; l++) { delete (*V[k])[l]; }
+      delete V[k];
+      delete W[k];
+      delete R[k];
+      delete sn[k];
+      delete cs[k];
+      delete s[k];
+      delete H[k];
    }
-   else if (fabs(dy) > fabs(dx))
+
+   if (print_level == 2 || print_level == 3)
    {
-      double temp = dx / dy;
-      sn = 1.0 / sqrt( 1.0 + temp*temp );
-      cs = temp * sn;
+      mfem::out << "GMRES: Number of iterations: " << final_iter
+                << " (max over " << nrhs << " right-hand sides)\n";
    }
-   else
+   if (print_level >= 0 && !converged)
    {
-      double temp = dy / dx;
-      cs = 1.0 / sqrt( 1.0 + temp*temp );
-      sn = temp * cs;
+      mfem::out << "GMRES: No convergence!\n";
    }
 }
 
-inline void ApplyPlaneRotation(double &dx, double &dy, double &cs, double &sn)
+void GMRESSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
 {
-   double temp = cs * dx + sn * dy;
-   dy = -sn * dx + cs * dy;
-   dx = temp;
+   ColumnArrayMult(*this, B, X);
 }
 
-inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
-                   Array<Vector*> &v)
+void GCRODRSolver::ResetRecycleSpace()
 {
-   Vector y(s);
+   DeleteVectors(U);
+   DeleteVectors(C);
+   update_c = false;
+}
 
-   // Backsolve:
-   for (int i = k; i >= 0; i--)
+void GCRODRSolver::SetOperator(const Operator &op)
+{
+   GMRESSolver::SetOperator(op);
+   if (U.Size() > 0 && U[0]->Size() != width) { ResetRecycleSpace(); }
+   update_c = true;
+}
+
+void GCRODRSolver::UpdateProducts() const
+{
+   Vector t(width);
+   for (int j = 0; j < U.Size(); j++)
    {
-      y(i) /= h(i,i);
-      for (int j = i - 1; j >= 0; j--)
+      if (prec)
       {
-         y(j) -= h(j,i) * y(i);
+         oper->Mult(*U[j], t);
+         prec->Mult(t, *C[j]);
       }
+      else
+      {
+         oper->Mult(*U[j], *C[j]);
+      }
+      // orthonormalize C with modified Gram-Schmidt, keeping C = B A U
+      for (int i = 0; i < j; i++)
+      {
+         const double h = Dot(*C[j], *C[i]);
+         C[j]->Add(-h, *C[i]);
+         U[j]->Add(-h, *U[i]);
+      }
+      const double h = Norm(*C[j]);
+      *C[j] /= h;
+      *U[j] /= h;
    }
-
-   for (int j = 0; j <= k; j++)
-   {
-      x.Add(y(j), *v[j]);
-   }
+   update_c = false;
 }
 
-void GMRESSolver::Mult(const Vector &b, Vector &x) const
+void GCRODRSolver::Mult(const Vector &b, Vector &x) const
 {
-   // Generalized Minimum Residual method following the algorithm
-   // on p. 20 of the SIAM Templates book.
+   MFEM_VERIFY(rdim >= 0 && rdim < m, "the dimension of the recycled subspace"
+               " must be smaller than the restart length");
+   const int n = width;
 
-   int n = width;
-
-   DenseMatrix H(m+1, m);
-   Vector s(m+1), cs(m+1), sn(m+1);
+   DenseMatrix H(m+1, m), R(m+1, m), Bk;
+   Vector s(m+1), cs(m+1), sn(m+1), c, y;
    Vector r(n), w(n);
-   Array<Vector *> v;
+   Array<Vector *> v(m+1);
+   v = NULL;
 
-   double resid;
-   int i, j, k;
+   double beta, resid;
+   int i, j, pass = 1;
+
+   if (U.Size() > 0 && update_c) { UpdateProducts(); }
 
    if (iterative_mode)
    {
       oper->Mult(x, r);
+      subtract(b, r, w);
    }
    else
    {
       x = 0.0;
+      w = b;
    }
-
    if (prec)
    {
-      if (iterative_mode)
-      {
-         subtract(b, r, w);
-         prec->Mult(w, r);    // r = M (b - A x)
-      }
-      else
-      {
-         prec->Mult(b, r);
-      }
+      prec->Mult(w, r);    // r = M (b - A x)
    }
    else
    {
-      if (iterative_mode)
-      {
-         subtract(b, r, r);
-      }
-      else
-      {
-         r = b;
-      }
+      r = w;
    }
-   double beta = Norm(r);  // beta = ||r||
+   beta = Norm(r);  // beta = ||r||
    MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
 
    final_norm = std::max(rel_tol*beta, abs_tol);
 
-   if (beta <= final_norm)
-   {
-      final_norm = beta;
-      final_iter = 0;
-      converged = 1;
-      goto finish;
-   }
-
    if (print_level == 1 || print_level == 3)
    {
       mfem::out << "   Pass : " << setw(2) << 1
@@ -590,15 +1901,46 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
                 << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
    }
 
-   v.SetSize(m+1, NULL);
-
-   for (j = 1; j <= max_iter; )
+   converged = 0;
+   for (j = 1; true; pass++)
    {
+      // minimize the residual over the recycled subspace:
+      // x += U C^t r,  r -= C C^t r
+      const int k = U.Size();
+      if (k > 0)
+      {
+         c.SetSize(k);
+         for (int l = 0; l < k; l++) { c(l) = (*C[l]) * r; }
+         GlobalSum(c.GetData(), k);
+         for (int l = 0; l < k; l++)
+         {
+            x.Add(c(l), *U[l]);
+            r.Add(-c(l), *C[l]);
+         }
+         beta = Norm(r);
+      }
+      if (beta <= final_norm)
+      {
+         final_norm = beta;
+         final_iter = j-1;
+         converged = 1;
+         break;
+      }
+      if (j > max_iter)
+      {
+         final_norm = beta;
+         final_iter = max_iter;
+         break;
+      }
+
+      // Arnoldi process with (I - C C^t) B A, B A V = C Bk + V H
+      const int mk = m - k;
       if (v[0] == NULL) { v[0] = new Vector(n); }
       v[0]->Set(1.0/beta, r);
       s = 0.0; s(0) = beta;
-
-      for (i = 0; i < m && j <= max_iter; i++, j++)
+      Bk.SetSize(k, mk);
+      resid = beta;
+      for (i = 0; i < mk && j <= max_iter; )
       {
          if (prec)
          {
@@ -610,92 +1952,158 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
             oper->Mult(*v[i], w);
          }
 
-         for (k = 0; k <= i; k++)
+         for (int l = 0; l < k; l++)
          {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
+            Bk(l,i) = Dot(w, *C[l]);
+            w.Add(-Bk(l,i), *C[l]);
+         }
+         for (int l = 0; l <= i; l++)
+         {
+            H(l,i) = Dot(w, *v[l]);  // H(l,i) = w * v[l]
+            w.Add(-H(l,i), *v[l]);   // w -= H(l,i) * v[l]
          }
-
          H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
          MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
          v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
 
-         for (k = 0; k < i; k++)
+         // QR factorization of H with Givens rotations, R = Q^t H
+         for (int l = 0; l <= i+1; l++) { R(l,i) = H(l,i); }
+         for (int l = 0; l < i; l++)
          {
-            ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
+            ApplyPlaneRotation(R(l,i), R(l+1,i), cs(l), sn(l));
          }
-
-         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
-         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         GeneratePlaneRotation(R(i,i), R(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(R(i,i), R(i+1,i), cs(i), sn(i));
          ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
 
          resid = fabs(s(i+1));
          MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+         i++, j++;
 
-         if (resid <= final_norm)
+         if (print_level == 1)
          {
-            Update(x, i, H, s, v);
-            final_norm = resid;
-            final_iter = j;
-            converged = 1;
-            goto finish;
+            mfem::out << "   Pass : " << setw(2) << pass
+                      << "   Iteration : " << setw(3) << j-1
+                      << "  ||B r|| = " << resid << '\n';
          }
+         if (resid <= final_norm) { break; }
+      }
+      const int ns = i; // number of Arnoldi steps
 
-         if (print_level == 1)
+      // x += V y + U z, where R y = Q^t beta e_1 and z = -Bk y
+      y.SetSize(ns);
+      for (int l = ns-1; l >= 0; l--)
+      {
+         double t = s(l);
+         for (int p = l+1; p < ns; p++) { t -= R(l,p)*y(p); }
+         y(l) = t/R(l,l);
+      }
+      for (int l = 0; l < ns; l++) { x.Add(y(l), *v[l]); }
+      for (int l = 0; l < k; l++)
+      {
+         double t = 0.0;
+         for (int p = 0; p < ns; p++) { t += Bk(l,p)*y(p); }
+         x.Add(-t, *U[l]);
+      }
+
+      if (rdim > 0)
+      {
+         // With Z = [U, V_ns], W = [C, V_{ns+1}] and B A Z = W G, compute the
+         // harmonic Ritz vectors of B A in span(Z): G^t G y = theta G^t W^t Z y
+         const int p = k + ns, knew = std::min(rdim, p);
+         DenseMatrix G(p+1, p), WtZ(p+1, p), GtG(p), GtWtZ(p);
+         G = 0.0;
+         WtZ = 0.0;
+         for (int l = 0; l < k; l++)
          {
-            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
-                      << "   Iteration : " << setw(3) << j
-                      << "  ||B r|| = " << resid << '\n';
+            G(l,l) = 1.0;
+            for (int q = 0; q < ns; q++) { G(l,k+q) = Bk(l,q); }
+            for (int q = 0; q < k; q++) { WtZ(l,q) = (*C[l]) * (*U[q]); }
+         }
+         for (int l = 0; l <= ns; l++)
+         {
+            for (int q = 0; q < ns; q++) { G(k+l,k+q) = H(l,q); }
+            for (int q = 0; q < k; q++) { WtZ(k+l,q) = (*v[l]) * (*U[q]); }
+            if (l < ns) { WtZ(k+l,k+l) = 1.0; }
+         }
+         // only the products with U, the first k columns, need a reduction
+         if (k > 0) { GlobalSum(WtZ.Data(), (p+1)*k); }
+         MultAtB(G, G, GtG);
+         MultAtB(G, WtZ, GtWtZ);
+         DenseMatrix P, GP(p+1, knew), Q;
+         SmallestEigenSubspace(GtG, GtWtZ, knew, P);
+         mfem::Mult(G, P, GP);
+
+         // G P = Q T (thin QR), C = W Q, U = Z P T^{-1}
+         DenseMatrix T(knew);
+         T = 0.0;
+         Q = GP;
+         for (int l = 0; l < knew; l++)
+         {
+            for (int q = 0; q < l; q++)
+            {
+               double h = 0.0;
+               for (int a = 0; a <= p; a++) { h += Q(a,q)*Q(a,l); }
+               for (int a = 0; a <= p; a++) { Q(a,l) -= h*Q(a,q); }
+               T(q,l) = h;
+            }
+            double h = 0.0;
+            for (int a = 0; a <= p; a++) { h += Q(a,l)*Q(a,l); }
+            T(l,l) = h = sqrt(h);
+            for (int a = 0; a <= p; a++) { Q(a,l) /= h; }
+         }
+         DenseMatrix Tinv, PTinv(p, knew);
+         DenseMatrixInverse(T).GetInverseMatrix(Tinv);
+         mfem::Mult(P, Tinv, PTinv);
+
+         Array<Vector *> Z(p), Wb(p+1), Un, Cn;
+         for (int l = 0; l <= p; l++)
+         {
+            if (l < p) { Z[l] = (l < k) ? U[l] : v[l-k]; }
+            Wb[l] = (l < k) ? C[l] : v[l-k];
          }
+         LinearCombination(Z, PTinv, Un);
+         LinearCombination(Wb, Q, Cn);
+         DeleteVectors(U);
+         DeleteVectors(C);
+         Un.Copy(U);
+         Cn.Copy(C);
       }
 
-      if (print_level == 1 && j <= max_iter)
+      if (print_level == 1 && resid > final_norm && j <= max_iter)
       {
          mfem::out << "Restarting..." << '\n';
       }
 
-      Update(x, i-1, H, s, v);
-
+      // the true residual is checked at the beginning of the next pass
       oper->Mult(x, r);
+      subtract(b, r, w);
       if (prec)
       {
-         subtract(b, r, w);
          prec->Mult(w, r);    // r = M (b - A x)
       }
       else
       {
-         subtract(b, r, r);
+         r = w;
       }
       beta = Norm(r);         // beta = ||r||
       MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
-      if (beta <= final_norm)
-      {
-         final_norm = beta;
-         final_iter = j;
-         converged = 1;
-         goto finish;
-      }
    }
 
-   final_norm = beta;
-   final_iter = max_iter;
-   converged = 0;
-
-finish:
    if (print_level == 1 || print_level == 3)
    {
-      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+      mfem::out << "   Pass : " << setw(2) << pass
                 << "   Iteration : " << setw(3) << final_iter
                 << "  ||B r|| = " << final_norm << '\n';
    }
    else if (print_level == 2)
    {
-      mfem::out << "GMRES: Number of iterations: " << final_iter << '\n';
+      mfem::out << "GCRO-DR: Number of iterations: " << final_iter << '\n';
    }
    if (print_level >= 0 && !converged)
    {
-      mfem::out << "GMRES: No convergence!\n";
+      mfem::out << "GCRO-DR: No convergence!\n";
    }
    for (i = 0; i < v.Size(); i++)
    {
@@ -956,8 +2364,8 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       }
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      //  s = r - alpha * v
+      resid = sqrt(GlobalSum(AddAndDot(r, -alpha, v, s, s)));
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (resid < tol_goal)
       {
@@ -982,13 +2390,16 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          shat = s;
       }
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
+      double dots[2];
+      Dot2(t, s, t, dots);     //  (t, s) and (t, t) with one reduction
+      GlobalSum(dots, 2);
+      omega = dots[0] / dots[1];
       x.Add(alpha, phat);   //  x += alpha * phat
       x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
 
       rho_2 = rho_1;
-      resid = Norm(r);
+      //  r = s - omega * t
+      resid = sqrt(GlobalSum(AddAndDot(s, -omega, t, r, r)));
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (print_level >= 0)
       {
@@ -1114,17 +2525,18 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       {
          q.Add(-beta, v0);
       }
-      add(q, -alpha, v1, v0);
 
       delta = gamma1*alpha - gamma0*sigma1*beta;
       rho3 = sigma0*beta;
       rho2 = sigma1*alpha + gamma0*gamma1*beta;
       if (!prec)
       {
-         beta = Norm(v0);
+         // v0 = q - alpha v1 and its norm in one pass
+         beta = sqrt(GlobalSum(AddAndNormSquared(1.0, q, -alpha, v1, v0)));
       }
       else
       {
+         add(q, -alpha, v1, v0);
          prec->Mult(v0, q);
          beta = sqrt(Dot(v0, q));
       }
@@ -1679,9 +3091,37 @@ slbqp_done:
 
 #ifdef MFEM_USE_SUITESPARSE
 
+// Return true if the sparsity pattern of A is given by the arrays I and J.
+static bool SameSparsity(const SparseMatrix &A, const Array<int> &I,
+                         const Array<int> &J)
+{
+   const int n = A.Height();
+   if (I.Size() != n + 1 || J.Size() != A.NumNonZeroElems()) { return false; }
+   const int *Ap = A.GetI(), *Ai = A.GetJ();
+   for (int i = 0; i <= n; i++)
+   {
+      if (Ap[i] != I[i]) { return false; }
+   }
+   for (int k = 0; k < J.Size(); k++)
+   {
+      if (Ai[k] != J[k]) { return false; }
+   }
+   return true;
+}
+
+static void CopySparsity(const SparseMatrix &A, Array<int> &I, Array<int> &J)
+{
+   const int n = A.Height();
+   I.SetSize(n + 1);
+   J.SetSize(A.GetI()[n]);
+   std::copy(A.GetI(), A.GetI() + n + 1, I.GetData());
+   std::copy(A.GetJ(), A.GetJ() + J.Size(), J.GetData());
+}
+
 void UMFPackSolver::Init()
 {
    mat = NULL;
+   Symbolic = NULL;
    Numeric = NULL;
    AI = AJ = NULL;
    if (!use_long_ints)
@@ -1696,22 +3136,6 @@ void UMFPackSolver::Init()
 
 void UMFPackSolver::SetOperator(const Operator &op)
 {
-   int *Ap, *Ai;
-   void *Symbolic;
-   double *Ax;
-
-   if (Numeric)
-   {
-      if (!use_long_ints)
-      {
-         umfpack_di_free_numeric(&Numeric);
-      }
-      else
-      {
-         umfpack_dl_free_numeric(&Numeric);
-      }
-   }
-
    mat = const_cast<SparseMatrix *>(dynamic_cast<const SparseMatrix *>(&op));
    MFEM_VERIFY(mat, "not a SparseMatrix");
 
@@ -1724,24 +3148,49 @@ void UMFPackSolver::SetOperator(const Operator &op)
    width = mat->Width();
    MFEM_VERIFY(width == height, "not a square matrix");
 
-   Ap = mat->GetI();
-   Ai = mat->GetJ();
-   Ax = mat->GetData();
+   Factor(!Symbolic || !SameSparsity(*mat, sym_I, sym_J));
+}
+
+void UMFPackSolver::UpdateValues(const Operator &op)
+{
+   mat = const_cast<SparseMatrix *>(dynamic_cast<const SparseMatrix *>(&op));
+   MFEM_VERIFY(mat, "not a SparseMatrix");
+   MFEM_VERIFY(Symbolic && mat->Height() == height &&
+               mat->NumNonZeroElems() == sym_J.Size(),
+               "the sparsity pattern has changed, use SetOperator()");
+   mat->SortColumnIndices();
+   MFEM_ASSERT(SameSparsity(*mat, sym_I, sym_J),
+               "the sparsity pattern has changed, use SetOperator()");
+
+   Factor(false);
+}
+
+void UMFPackSolver::Factor(bool symbolic)
+{
+   int *Ap = mat->GetI();
+   int *Ai = mat->GetJ();
+   double *Ax = mat->GetData();
 
    if (!use_long_ints)
    {
-      int status = umfpack_di_symbolic(width, width, Ap, Ai, Ax, &Symbolic,
-                                       Control, Info);
-      if (status < 0)
+      if (Numeric) { umfpack_di_free_numeric(&Numeric); }
+      if (symbolic)
       {
-         umfpack_di_report_info(Control, Info);
-         umfpack_di_report_status(Control, status);
-         mfem_error("UMFPackSolver::SetOperator :"
-                    " umfpack_di_symbolic() failed!");
+         if (Symbolic) { umfpack_di_free_symbolic(&Symbolic); }
+         CopySparsity(*mat, sym_I, sym_J);
+         int status = umfpack_di_symbolic(width, width, Ap, Ai, Ax, &Symbolic,
+                                          Control, Info);
+         if (status < 0)
+         {
+            umfpack_di_report_info(Control, Info);
+            umfpack_di_report_status(Control, status);
+            mfem_error("UMFPackSolver::SetOperator :"
+                       " umfpack_di_symbolic() failed!");
+         }
       }
 
-      status = umfpack_di_numeric(Ap, Ai, Ax, Symbolic, &Numeric,
-                                  Control, Info);
+      int status = umfpack_di_numeric(Ap, Ai, Ax, Symbolic, &Numeric,
+                                      Control, Info);
       if (status < 0)
       {
          umfpack_di_report_info(Control, Info);
@@ -1749,33 +3198,39 @@ void UMFPackSolver::SetOperator(const Operator &op)
          mfem_error("UMFPackSolver::SetOperator :"
                     " umfpack_di_numeric() failed!");
       }
-      umfpack_di_free_symbolic(&Symbolic);
    }
    else
    {
       SuiteSparse_long status;
 
-      delete [] AJ;
-      delete [] AI;
-      AI = new SuiteSparse_long[width + 1];
-      AJ = new SuiteSparse_long[Ap[width]];
-      for (int i = 0; i <= width; i++)
-      {
-         AI[i] = (SuiteSparse_long)(Ap[i]);
-      }
-      for (int i = 0; i < Ap[width]; i++)
+      if (Numeric) { umfpack_dl_free_numeric(&Numeric); }
+      if (symbolic)
       {
-         AJ[i] = (SuiteSparse_long)(Ai[i]);
-      }
+         if (Symbolic) { umfpack_dl_free_symbolic(&Symbolic); }
+         CopySparsity(*mat, sym_I, sym_J);
 
-      status = umfpack_dl_symbolic(width, width, AI, AJ, Ax, &Symbolic,
-                                   Control, Info);
-      if (status < 0)
-      {
-         umfpack_dl_report_info(Control, Info);
-         umfpack_dl_report_status(Control, status);
-         mfem_error("UMFPackSolver::SetOperator :"
-                    " umfpack_dl_symbolic() failed!");
+         delete [] AJ;
+         delete [] AI;
+         AI = new SuiteSparse_long[width + 1];
+         AJ = new SuiteSparse_long[Ap[width]];
+         for (int i = 0; i <= width; i++)
+         {
+            AI[i] = (SuiteSparse_long)(Ap[i]);
+         }
+         for (int i = 0; i < Ap[width]; i++)
+         {
+            AJ[i] = (SuiteSparse_long)(Ai[i]);
+         }
+
+         status = umfpack_dl_symbolic(width, width, AI, AJ, Ax, &Symbolic,
+                                      Control, Info);
+         if (status < 0)
+         {
+            umfpack_dl_report_info(Control, Info);
+            umfpack_dl_report_status(Control, status);
+            mfem_error("UMFPackSolver::SetOperator :"
+                       " umfpack_dl_symbolic() failed!");
+         }
       }
 
       status = umfpack_dl_numeric(AI, AJ, Ax, Symbolic, &Numeric,
@@ -1787,7 +3242,6 @@ void UMFPackSolver::SetOperator(const Operator &op)
          mfem_error("UMFPackSolver::SetOperator :"
                     " umfpack_dl_numeric() failed!");
       }
-      umfpack_dl_free_symbolic(&Symbolic);
    }
 }
 
@@ -1861,16 +3315,15 @@ UMFPackSolver::~UMFPackSolver()
 {
    delete [] AJ;
    delete [] AI;
-   if (Numeric)
+   if (!use_long_ints)
    {
-      if (!use_long_ints)
-      {
-         umfpack_di_free_numeric(&Numeric);
-      }
-      else
-      {
-         umfpack_dl_free_numeric(&Numeric);
-      }
+      if (Numeric) { umfpack_di_free_numeric(&Numeric); }
+      if (Symbolic) { umfpack_di_free_symbolic(&Symbolic); }
+   }
+   else
+   {
+      if (Numeric) { umfpack_dl_free_numeric(&Numeric); }
+      if (Symbolic) { umfpack_dl_free_symbolic(&Symbolic); }
    }
 }
 
@@ -1881,16 +3334,6 @@ void KLUSolver::Init()
 
 void KLUSolver::SetOperator(const Operator &op)
 {
-   if (Numeric)
-   {
-      MFEM_ASSERT(Symbolic != 0,
-                  "Had Numeric pointer in KLU, but not Symbolic");
-      klu_free_symbolic(&Symbolic, &Common);
-      Symbolic = 0;
-      klu_free_numeric(&Numeric, &Common);
-      Numeric = 0;
-   }
-
    mat = const_cast<SparseMatrix *>(dynamic_cast<const SparseMatrix *>(&op));
    MFEM_VERIFY(mat != NULL, "not a SparseMatrix");
 
@@ -1902,11 +3345,47 @@ void KLUSolver::SetOperator(const Operator &op)
    width = mat->Width();
    MFEM_VERIFY(width == height, "not a square matrix");
 
+   Factor(!Symbolic || !SameSparsity(*mat, sym_I, sym_J));
+}
+
+void KLUSolver::UpdateValues(const Operator &op)
+{
+   mat = const_cast<SparseMatrix *>(dynamic_cast<const SparseMatrix *>(&op));
+   MFEM_VERIFY(mat != NULL, "not a SparseMatrix");
+   MFEM_VERIFY(Symbolic && mat->Height() == height &&
+               mat->NumNonZeroElems() == sym_J.Size(),
+               "the sparsity pattern has changed, use SetOperator()");
+   mat->SortColumnIndices();
+   MFEM_ASSERT(SameSparsity(*mat, sym_I, sym_J),
+               "the sparsity pattern has changed, use SetOperator()");
+
+   Factor(false);
+}
+
+void KLUSolver::Factor(bool symbolic)
+{
+   if (Numeric)
+   {
+      MFEM_ASSERT(Symbolic != 0,
+                  "Had Numeric pointer in KLU, but not Symbolic");
+      klu_free_numeric(&Numeric, &Common);
+      Numeric = 0;
+   }
+
    int * Ap = mat->GetI();
    int * Ai = mat->GetJ();
    double * Ax = mat->GetData();
 
-   Symbolic = klu_analyze( height, Ap, Ai, &Common);
+   if (symbolic)
+   {
+      if (Symbolic)
+      {
+         klu_free_symbolic(&Symbolic, &Common);
+         Symbolic = 0;
+      }
+      CopySparsity(*mat, sym_I, sym_J);
+      Symbolic = klu_analyze( height, Ap, Ai, &Common);
+   }
    Numeric = klu_factor(Ap, Ai, Ax, Symbolic, &Common);
 }
 
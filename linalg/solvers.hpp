@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "densemat.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
@@ -32,7 +33,7 @@ namespace mfem
 class IterativeSolver : public Solver
 {
 #ifdef MFEM_USE_MPI
-private:
+protected:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
 #endif
@@ -51,6 +52,13 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Sum the @a n local values in @a vals over all MPI ranks when the
+       solver uses global inner products. */
+   /** This is used together with the fused kernels, e.g. AddAndDot(), which
+       return local inner products. */
+   void GlobalSum(double *vals, int n) const;
+   double GlobalSum(double val) const { GlobalSum(&val, 1); return val; }
+
 public:
    IterativeSolver();
 
@@ -126,6 +134,21 @@ public:
    { IterativeSolver::SetOperator(op); UpdateVectors(); }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve for multiple right-hand sides @a B, running one CG
+       recurrence per right-hand side in lockstep. */
+   /** In every iteration, the operator and the preconditioner are applied to
+       all active (not yet converged) vectors at once through
+       Operator::ArrayMult(), so that e.g. a SparseMatrix is read only once per
+       iteration for a block of right-hand sides. The statistics returned by
+       GetNumIterations() and GetFinalNorm() are the maximum over all
+       right-hand sides, and GetConverged() is true only if all of them
+       converged. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+
+   /// Solve for the columns of @a B, see ArrayMult().
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const;
 };
 
 /// Conjugate gradient method. (tolerances are squared)
@@ -139,6 +162,148 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/// Pipelined conjugate gradient method
+/** This is the communication-hiding (preconditioned) conjugate gradient method
+    of P. Ghysels and W. Vanroose, "Hiding global synchronization latency in the
+    preconditioned Conjugate Gradient algorithm", Parallel Computing, 2014.
+
+    All inner products of one iteration are combined into a single global
+    reduction which, in parallel, is started with a non-blocking MPI_Iallreduce
+    and overlapped with the application of the preconditioner and the operator.
+    The price is additional memory (up to 9 work vectors) and slightly weaker
+    numerical stability compared to CGSolver, in particular when the residual
+    is reduced by many orders of magnitude. The convergence criterion and the
+    print levels are the same as in CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+   /** @brief Start the global reduction of the @a num local values in @a buf.
+       If the reduction is non-blocking, it must be completed with
+       FinishReduction(). */
+   void StartReduction(double *buf, int num) const;
+   void FinishReduction() const;
+
+#ifdef MFEM_USE_MPI
+   mutable MPI_Request request;
+#endif
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetPreconditioner(Solver &pr)
+   { IterativeSolver::SetPreconditioner(pr); if (oper) { UpdateVectors(); } }
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
+/// Deflated conjugate gradient method with subspace recycling
+/** This is the deflated (preconditioned) CG method of Y. Saad, M. Yeung,
+    J. Erhel and F. Guyomarc'h, "A deflated version of the conjugate gradient
+    algorithm", SIAM J. Sci. Comput., 2000, with the recycling strategy of
+    S. Wang, E. de Sturler and G. Paulino, "Large-scale topology optimization
+    using preconditioned Krylov subspace methods with recycling", Int. J.
+    Numer. Meth. Eng., 2007. It is intended for sequences of slowly changing
+    SPD systems, e.g. in time-dependent problems.
+
+    The iteration is kept A-orthogonal to a deflation subspace W of dimension
+    up to k, see SetRecycleDim(), which removes the corresponding (slow) modes
+    from the convergence. During every call to Mult(), the search directions
+    are collected in blocks of l vectors and, after each block, the subspace
+    for the next solve is set to the harmonic Ritz vectors of the
+    preconditioned operator B A associated with its k smallest eigenvalues in
+    the span of this subspace and the block. The subspace persists across calls
+    to Mult(); when the operator or the preconditioner are changed with
+    SetOperator() or SetPreconditioner(), the products with W are recomputed
+    before the next solve. Call ResetRecycleSpace() when W is no longer
+    meaningful, e.g. after the mesh has been modified. The preconditioner must
+    be symmetric. */
+class DeflatedCGSolver : public CGSolver
+{
+protected:
+   int rdim, ndir; // see SetRecycleDim()
+
+   /// The deflation subspace W, A-orthonormal after an update, and A W.
+   mutable Array<Vector *> W, AW;
+   /// The matrices W^t A W, its inverse, and (A W)^t B (A W).
+   mutable DenseMatrix WtAW, WtAWinv, AWtBAW;
+   mutable bool update_aw;
+
+   /** The subspace Y for the next solve, A-orthonormal, and A Y; they are
+       empty until the first update during a solve. */
+   mutable Array<Vector *> Y, AY;
+   /// The matrix (A Y)^t B (A Y).
+   mutable DenseMatrix AYtBAY;
+
+   /// The current block of search directions P, A P, B A P and (P, A P).
+   mutable Array<Vector *> P, AP, BAP;
+   mutable Vector PtAP;
+   mutable Vector q;
+
+   /// Set @a c = (W^t A W)^{-1} V^t y.
+   void DeflationCoefficients(const Array<Vector *> &V, const Vector &y,
+                              Vector &c) const;
+
+   /// Compute #WtAW and #WtAWinv from W and AW.
+   void FactorWtAW() const;
+
+   /// Recompute AW and the small matrices for the current operator.
+   void UpdateProducts() const;
+
+   /** Update Y (or set it, starting from W) with the harmonic Ritz vectors
+       computed from Y and the first @a np vectors of the current block. */
+   void UpdateRecycleSpace(int np) const;
+
+public:
+   DeflatedCGSolver() { rdim = ndir = 0; update_aw = false; }
+
+#ifdef MFEM_USE_MPI
+   DeflatedCGSolver(MPI_Comm _comm) : CGSolver(_comm)
+   { rdim = ndir = 0; update_aw = false; }
+#endif
+
+   /** @brief Set the dimension @a k of the deflation subspace and the number
+       @a l of search directions per update of the subspace. */
+   /** The default value of @a l is 2 @a k. The solver stores 4 @a k + 3 @a l
+       additional vectors. Every update costs about 2 @a k (@a k + @a l)
+       vector updates and @a l (@a k + @a l/2) inner products. */
+   void SetRecycleDim(int k, int l = -1);
+
+   /// Return the current dimension of the deflation subspace.
+   int GetRecycleDim() const { return W.Size(); }
+
+   /// Discard the deflation subspace.
+   void ResetRecycleSpace();
+
+   virtual void SetPreconditioner(Solver &pr);
+
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve for the right-hand sides @a B one after the other, so that
+       each solve benefits from the subspace updated by the previous ones. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const
+   { Operator::ArrayMult(B, X); }
+
+   using CGSolver::Mult;
+
+   virtual ~DeflatedCGSolver() { ResetRecycleSpace(); }
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
@@ -156,6 +321,82 @@ public:
    void SetKDim(int dim) { m = dim; }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve for multiple right-hand sides @a B, running one GMRES
+       iteration per right-hand side in lockstep. */
+   /** The operator and the preconditioner are applied to the new Krylov
+       vectors of all active right-hand sides at once through
+       Operator::ArrayMult(). Each right-hand side keeps its own Krylov basis,
+       so this method needs B.Size()*(m+1) work vectors. The statistics are
+       reported as in CGSolver::ArrayMult(). */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+
+   /// Solve for the columns of @a B, see ArrayMult().
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+};
+
+/// GMRES method with deflated restarting and subspace recycling (GCRO-DR)
+/** This is the GCRO-DR method of M. Parks, E. de Sturler, G. Mackey,
+    D. Johnson and S. Maiti, "Recycling Krylov subspaces for sequences of
+    linear systems", SIAM J. Sci. Comput., 2006, applied to the (left)
+    preconditioned operator B A as in GMRESSolver.
+
+    A subspace U of dimension up to SetRecycleDim(), with C = B A U
+    orthonormal, is kept from cycle to cycle and across calls to Mult(). Every
+    cycle minimizes the residual over U plus a Krylov subspace of dimension
+    m - k of the operator projected onto the orthogonal complement of C, and
+    then replaces U with the harmonic Ritz vectors associated with the
+    eigenvalues of smallest magnitude. When the operator or the preconditioner
+    are changed with SetOperator() or SetPreconditioner(), C is recomputed from
+    U before the next solve. Call ResetRecycleSpace() when U is no longer
+    meaningful, e.g. after the mesh has been modified. */
+class GCRODRSolver : public GMRESSolver
+{
+protected:
+   int rdim; // see SetRecycleDim()
+
+   /// The recycled subspace U and C = B A U, with C^t C = I.
+   mutable Array<Vector *> U, C;
+   mutable bool update_c;
+
+   /// Recompute C for the current operator and orthonormalize it.
+   void UpdateProducts() const;
+
+public:
+   GCRODRSolver() { rdim = 10; update_c = false; }
+
+#ifdef MFEM_USE_MPI
+   GCRODRSolver(MPI_Comm _comm) : GMRESSolver(_comm)
+   { rdim = 10; update_c = false; }
+#endif
+
+   /** @brief Set the dimension @a k of the recycled subspace, default is 10.
+       Must be smaller than the restart length, see SetKDim(). */
+   void SetRecycleDim(int k) { rdim = k; }
+
+   /// Return the current dimension of the recycled subspace.
+   int GetRecycleDim() const { return U.Size(); }
+
+   /// Discard the recycled subspace.
+   void ResetRecycleSpace();
+
+   virtual void SetPreconditioner(Solver &pr)
+   { GMRESSolver::SetPreconditioner(pr); update_c = true; }
+
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve for the right-hand sides @a B one after the other, so that
+       each solve benefits from the subspace updated by the previous ones. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const
+   { Operator::ArrayMult(B, X); }
+
+   using GMRESSolver::Mult;
+
+   virtual ~GCRODRSolver() { ResetRecycleSpace(); }
 };
 
 /// FGMRES method
@@ -346,11 +587,17 @@ class UMFPackSolver : public Solver
 protected:
    bool use_long_ints;
    SparseMatrix *mat;
-   void *Numeric;
+   void *Symbolic, *Numeric;
    SuiteSparse_long *AI, *AJ;
+   /// Sparsity pattern of the symbolic factorization #Symbolic.
+   Array<int> sym_I, sym_J;
 
    void Init();
 
+   /** Compute the numeric factorization of #mat, preceded by the symbolic
+       factorization if @a symbolic is true. */
+   void Factor(bool symbolic);
+
 public:
    double Control[UMFPACK_CONTROL];
    mutable double Info[UMFPACK_INFO];
@@ -368,10 +615,18 @@ public:
    /** @brief Factorize the given Operator @a op which must be a SparseMatrix.
 
        The factorization uses the parameters set in the #Control data member.
+       If the sparsity pattern of @a op is the same as the one of the previous
+       operator, the symbolic factorization is reused and only the numeric
+       factorization is computed.
        @note This method calls SparseMatrix::SortColumnIndices() with @a op,
        modifying the matrix if the column indices are not already sorted. */
    virtual void SetOperator(const Operator &op);
 
+   /** @brief Factorize the given Operator @a op, which must be a SparseMatrix
+       with the same sparsity pattern as the previous operator, reusing the
+       symbolic factorization without comparing the patterns. */
+   void UpdateValues(const Operator &op);
+
    /// Set the print level field in the #Control data member.
    void SetPrintLevel(int print_lvl) { Control[UMFPACK_PRL] = print_lvl; }
 
@@ -388,9 +643,15 @@ protected:
    SparseMatrix *mat;
    klu_symbolic *Symbolic;
    klu_numeric *Numeric;
+   /// Sparsity pattern of the symbolic factorization #Symbolic.
+   Array<int> sym_I, sym_J;
 
    void Init();
 
+   /** Compute the numeric factorization of #mat, preceded by the symbolic
+       analysis if @a symbolic is true. */
+   void Factor(bool symbolic);
+
 public:
    KLUSolver()
       : mat(0),Symbolic(0),Numeric(0)
@@ -399,9 +660,16 @@ public:
       : mat(0),Symbolic(0),Numeric(0)
    { Init(); SetOperator(A); }
 
-   // Works on sparse matrices only; calls SparseMatrix::SortColumnIndices().
+   /** Works on sparse matrices only; calls SparseMatrix::SortColumnIndices().
+       If the sparsity pattern of @a op is the same as the one of the previous
+       operator, the symbolic analysis is reused. */
    virtual void SetOperator(const Operator &op);
 
+   /** @brief Factorize the given SparseMatrix @a op with the same sparsity
+       pattern as the previous operator, reusing the symbolic analysis without
+       comparing the patterns. */
+   void UpdateValues(const Operator &op);
+
    virtual void Mult(const Vector &b, Vector &x) const;
    virtual void MultTranspose(const Vector &b, Vector &x) const;
 
@@ -0,0 +1,753 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SparseCholeskySolver
+
+#include "sparsechol.hpp"
+
+#include <cmath>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+
+// Include the METIS header, if using version 5. If using METIS 4, the needed
+// declarations are inlined below, i.e. no header is needed.
+#if defined(MFEM_USE_METIS) && defined(MFEM_USE_METIS_5)
+#include "metis.h"
+#endif
+
+// METIS 4 prototypes
+#if defined(MFEM_USE_METIS) && !defined(MFEM_USE_METIS_5)
+typedef int idx_t;
+typedef int idxtype;
+extern "C" {
+   void METIS_NodeND(int*, idxtype*, idxtype*, int*, int*, idxtype*, idxtype*);
+}
+#endif
+
+namespace mfem
+{
+
+// Compute the adjacency graph (without the diagonal) of the pattern of A+A^T.
+static void SymmetricGraph(const SparseMatrix &A, Array<int> &xadj,
+                           Array<int> &adj)
+{
+   const int n = A.Height();
+   const int *I = A.GetI(), *J = A.GetJ();
+
+   Array<int> cnt(n+1);
+   cnt = 0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] != i) { cnt[i+1]++; cnt[J[k]+1]++; }
+      }
+   }
+   cnt.PartialSum();
+   Array<int> all(cnt[n]);
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if (j != i) { all[cnt[i]++] = j; all[cnt[j]++] = i; }
+      }
+   }
+   // cnt[i] now points to the end of row i
+   xadj.SetSize(n+1);
+   adj.SetSize(all.Size());
+   xadj[0] = 0;
+   for (int i = 0, beg = 0; i < n; i++)
+   {
+      int *row = all.GetData() + beg, *end = all.GetData() + cnt[i];
+      std::sort(row, end);
+      end = std::unique(row, end);
+      std::copy(row, end, adj.GetData() + xadj[i]);
+      xadj[i+1] = xadj[i] + int(end - row);
+      beg = cnt[i];
+   }
+   adj.SetSize(xadj[n]);
+}
+
+// Approximate minimum degree ordering based on the quotient graph: every
+// eliminated variable becomes an element whose variables form a clique, and
+// the degree of a variable is approximated by the sum of the external sizes of
+// its adjacent elements and the number of its adjacent variables.
+static void MinimumDegree(int n, const Array<int> &xadj, const Array<int> &adj,
+                          Array<int> &perm)
+{
+   enum { VARIABLE, ELEMENT, ABSORBED };
+   std::vector<std::vector<int> > vadj(n), eadj(n), elem(n);
+   std::vector<int> status(n, VARIABLE), degree(n), flag(n, -1);
+   std::vector<int> ext_tag(n, -1), ext(n, 0);
+   typedef std::pair<int,int> entry;
+   std::priority_queue<entry, std::vector<entry>, std::greater<entry> > heap;
+
+   for (int i = 0; i < n; i++)
+   {
+      vadj[i].assign(adj.GetData() + xadj[i], adj.GetData() + xadj[i+1]);
+      degree[i] = xadj[i+1] - xadj[i];
+      heap.push(entry(degree[i], i));
+   }
+
+   perm.SetSize(n);
+   for (int k = 0; k < n; k++)
+   {
+      // select the variable of minimum (approximate) degree
+      int p = heap.top().second;
+      while (status[p] != VARIABLE || heap.top().first != degree[p])
+      {
+         heap.pop();
+         p = heap.top().second;
+      }
+      heap.pop();
+      perm[k] = p;
+      status[p] = ELEMENT;
+
+      // the new element p: its variables are the variables adjacent to p and
+      // the variables of the elements adjacent to p, which are absorbed
+      std::vector<int> &Lp = elem[p];
+      Lp.clear();
+      flag[p] = k;
+      for (size_t a = 0; a < vadj[p].size(); a++)
+      {
+         const int v = vadj[p][a];
+         if (status[v] == VARIABLE && flag[v] != k)
+         {
+            flag[v] = k;
+            Lp.push_back(v);
+         }
+      }
+      for (size_t a = 0; a < eadj[p].size(); a++)
+      {
+         const int e = eadj[p][a];
+         if (status[e] != ELEMENT) { continue; }
+         for (size_t b = 0; b < elem[e].size(); b++)
+         {
+            const int v = elem[e][b];
+            if (status[v] == VARIABLE && flag[v] != k)
+            {
+               flag[v] = k;
+               Lp.push_back(v);
+            }
+         }
+         status[e] = ABSORBED;
+         std::vector<int>().swap(elem[e]);
+      }
+      std::vector<int>().swap(vadj[p]);
+      std::vector<int>().swap(eadj[p]);
+
+      // update the adjacency lists of the variables of the new element and
+      // compute |Le \ Lp| for the elements adjacent to them
+      for (size_t a = 0; a < Lp.size(); a++)
+      {
+         const int i = Lp[a];
+         std::vector<int> &ea = eadj[i];
+         size_t m = 0;
+         for (size_t b = 0; b < ea.size(); b++)
+         {
+            const int e = ea[b];
+            if (status[e] != ELEMENT) { continue; }
+            if (ext_tag[e] != k)
+            {
+               // prune the eliminated variables of e and count the external
+               // ones; elements fully contained in Lp are absorbed
+               ext_tag[e] = k;
+               std::vector<int> &Le = elem[e];
+               size_t q = 0;
+               int cnt = 0;
+               for (size_t c = 0; c < Le.size(); c++)
+               {
+                  const int v = Le[c];
+                  if (status[v] != VARIABLE) { continue; }
+                  Le[q++] = v;
+                  if (flag[v] != k) { cnt++; }
+               }
+               Le.resize(q);
+               ext[e] = cnt;
+               if (cnt == 0) { status[e] = ABSORBED; continue; }
+            }
+            ea[m++] = e;
+         }
+         ea.resize(m);
+         ea.push_back(p);
+
+         // variables in Lp are now connected through p
+         std::vector<int> &va = vadj[i];
+         m = 0;
+         for (size_t b = 0; b < va.size(); b++)
+         {
+            const int v = va[b];
+            if (status[v] == VARIABLE && flag[v] != k) { va[m++] = v; }
+         }
+         va.resize(m);
+      }
+
+      // approximate external degrees
+      const int remaining = n - k - 1;
+      for (size_t a = 0; a < Lp.size(); a++)
+      {
+         const int i = Lp[a];
+         long d = long(Lp.size()) - 1 + long(vadj[i].size());
+         const std::vector<int> &ea = eadj[i];
+         for (size_t b = 0; b + 1 < ea.size(); b++)
+         {
+            // the elements other than p were visited above, see ext_tag
+            d += ext[ea[b]];
+         }
+         degree[i] = int(std::min(d, long(remaining - 1)));
+         heap.push(entry(degree[i], i));
+      }
+   }
+}
+
+void SparseCholeskySolver::ComputeOrdering(const Array<int> &xadj,
+                                           const Array<int> &adj)
+{
+   const int n = height;
+   perm.SetSize(n);
+   Ordering ord = ordering;
+#ifndef MFEM_USE_METIS
+   if (ord == NESTED_DISSECTION) { ord = MINIMUM_DEGREE; }
+#endif
+   if (ord == NATURAL || n <= 1)
+   {
+      for (int i = 0; i < n; i++) { perm[i] = i; }
+   }
+   else if (ord == MINIMUM_DEGREE)
+   {
+      MinimumDegree(n, xadj, adj, perm);
+   }
+   else
+   {
+#ifdef MFEM_USE_METIS
+      // In case METIS have been compiled with 64bit indices
+      std::vector<idx_t> mxadj(xadj.GetData(), xadj.GetData() + n + 1);
+      std::vector<idx_t> madj(adj.GetData(), adj.GetData() + adj.Size());
+      std::vector<idx_t> mperm(n), miperm(n);
+      idx_t nvtxs = n;
+      if (madj.empty()) { madj.push_back(0); }
+#ifndef MFEM_USE_METIS_5
+      int numflag = 0, options[8];
+      options[0] = 0;
+      METIS_NodeND(&nvtxs, mxadj.data(), madj.data(), &numflag, options,
+                   mperm.data(), miperm.data());
+#else
+      idx_t options[METIS_NOPTIONS];
+      METIS_SetDefaultOptions(options);
+      int err = METIS_NodeND(&nvtxs, mxadj.data(), madj.data(), NULL, options,
+                             mperm.data(), miperm.data());
+      MFEM_VERIFY(err == METIS_OK, "error in METIS_NodeND: " << err);
+#endif
+      for (int i = 0; i < n; i++) { perm[i] = int(mperm[i]); }
+#endif
+   }
+}
+
+void SparseCholeskySolver::Analyze()
+{
+   const int n = height;
+   Array<int> xadj, adj;
+   SymmetricGraph(*mat, xadj, adj);
+   ComputeOrdering(xadj, adj);
+
+   // elimination tree of the permuted matrix
+   iperm.SetSize(n);
+   for (int k = 0; k < n; k++) { iperm[perm[k]] = k; }
+   Array<int> parent(n), anc(n);
+   for (int i = 0; i < n; i++)
+   {
+      parent[i] = anc[i] = -1;
+      const int v = perm[i];
+      for (int a = xadj[v]; a < xadj[v+1]; a++)
+      {
+         int r = iperm[adj[a]];
+         if (r >= i) { continue; }
+         while (anc[r] != -1 && anc[r] != i)
+         {
+            const int t = anc[r];
+            anc[r] = i;
+            r = t;
+         }
+         if (anc[r] == -1) { anc[r] = i; parent[r] = i; }
+      }
+   }
+
+   // postorder the elimination tree, keeping the children in increasing order
+   Array<int> head(n), next(n), post(n), stack(n);
+   head = -1;
+   for (int j = n-1; j >= 0; j--)
+   {
+      if (parent[j] != -1) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+   }
+   for (int j = 0, k = 0; j < n; j++)
+   {
+      if (parent[j] != -1) { continue; }
+      int top = 0;
+      stack[0] = j;
+      while (top >= 0)
+      {
+         const int p = stack[top];
+         const int c = head[p];
+         if (c == -1) { top--; post[k++] = p; }
+         else { head[p] = next[c]; stack[++top] = c; }
+      }
+   }
+   // relabel: the new position of column j is ipost[j]
+   Array<int> ipost(n), new_perm(n), new_parent(n);
+   for (int k = 0; k < n; k++) { ipost[post[k]] = k; }
+   for (int k = 0; k < n; k++)
+   {
+      new_perm[k] = perm[post[k]];
+      const int pk = parent[post[k]];
+      new_parent[k] = (pk == -1) ? -1 : ipost[pk];
+   }
+   Swap(perm, new_perm);
+   Swap(parent, new_parent);
+   for (int k = 0; k < n; k++) { iperm[perm[k]] = k; }
+
+   // column counts of L, by traversing the row subtrees
+   Array<int> cc(n), nchild(n), mark(n);
+   cc = 1;
+   nchild = 0;
+   for (int i = 0; i < n; i++)
+   {
+      if (parent[i] != -1) { nchild[parent[i]]++; }
+      mark[i] = i;
+      const int v = perm[i];
+      for (int a = xadj[v]; a < xadj[v+1]; a++)
+      {
+         for (int r = iperm[adj[a]]; r < i && mark[r] != i; r = parent[r])
+         {
+            cc[r]++;
+            mark[r] = i;
+         }
+      }
+   }
+
+   // fundamental supernodes
+   Array<int> sn_of(n);
+   sn_col.SetSize(0);
+   for (int j = 0; j < n; j++)
+   {
+      if (j == 0 || parent[j-1] != j || cc[j-1] != cc[j] + 1 || nchild[j] != 1)
+      {
+         sn_col.Append(j);
+      }
+      sn_of[j] = sn_col.Size() - 1;
+   }
+   const int nsn = sn_col.Size();
+   sn_col.Append(n);
+
+   // children of the supernodes and the structure of the upper triangle of
+   // the permuted matrix, stored by columns
+   sn_nchild.SetSize(nsn);
+   sn_nchild = 0;
+   Array<int> sn_head(nsn), sn_next(nsn);
+   sn_head = -1;
+   for (int s = nsn-1; s >= 0; s--)
+   {
+      const int p = parent[sn_col[s+1]-1];
+      if (p == -1) { continue; }
+      const int ps = sn_of[p];
+      sn_next[s] = sn_head[ps];
+      sn_head[ps] = s;
+      sn_nchild[ps]++;
+   }
+
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   acol_I.SetSize(n+1);
+   acol_I[0] = 0;
+   for (int j = 0; j < n; j++)
+   {
+      const int v = perm[j];
+      int cnt = 0;
+      for (int a = I[v]; a < I[v+1]; a++) { if (iperm[J[a]] >= j) { cnt++; } }
+      acol_I[j+1] = acol_I[j] + cnt;
+   }
+   acol_row.SetSize(acol_I[n]);
+   acol_src.SetSize(acol_I[n]);
+   for (int j = 0; j < n; j++)
+   {
+      const int v = perm[j];
+      int pos = acol_I[j];
+      for (int a = I[v]; a < I[v+1]; a++)
+      {
+         const int r = iperm[J[a]];
+         if (r >= j) { acol_row[pos] = r; acol_src[pos] = a; pos++; }
+      }
+   }
+
+   // row structure of the supernodes: the columns of the supernode, followed
+   // by the rows of A and of the children below the diagonal block
+   sn_rows_I.SetSize(nsn+1);
+   sn_val_I.SetSize(nsn+1);
+   sn_rows_I[0] = sn_val_I[0] = 0;
+   sn_rows.SetSize(0);
+   mark = -1;
+   max_front = 0;
+   for (int s = 0; s < nsn; s++)
+   {
+      const int f = sn_col[s], l = sn_col[s+1] - 1;
+      for (int j = f; j <= l; j++) { sn_rows.Append(j); mark[j] = s; }
+      const int beg = sn_rows.Size();
+      for (int j = f; j <= l; j++)
+      {
+         for (int a = xadj[perm[j]]; a < xadj[perm[j]+1]; a++)
+         {
+            const int r = iperm[adj[a]];
+            if (r > l && mark[r] != s) { sn_rows.Append(r); mark[r] = s; }
+         }
+      }
+      for (int c = sn_head[s]; c != -1; c = sn_next[c])
+      {
+         const int cbeg = sn_rows_I[c] + sn_col[c+1] - sn_col[c];
+         for (int a = cbeg; a < sn_rows_I[c+1]; a++)
+         {
+            const int r = sn_rows[a];
+            if (r > l && mark[r] != s) { sn_rows.Append(r); mark[r] = s; }
+         }
+      }
+      std::sort(sn_rows.GetData() + beg, sn_rows.GetData() + sn_rows.Size());
+      sn_rows_I[s+1] = sn_rows.Size();
+
+      const int m = sn_rows_I[s+1] - sn_rows_I[s];
+      MFEM_ASSERT(m == cc[f], "invalid supernode structure");
+      sn_val_I[s+1] = sn_val_I[s] + m*(l - f + 1);
+      max_front = std::max(max_front, m);
+   }
+}
+
+void SparseCholeskySolver::Factor()
+{
+   const int nsn = GetNumSupernodes();
+   const double *Adata = mat->GetData();
+
+   factor_single = single;
+   if (factor_single)
+   {
+      Lval.Destroy();
+      Lval_sp.resize(sn_val_I[nsn]);
+   }
+   else
+   {
+      std::vector<float>().swap(Lval_sp);
+      Lval.SetSize(sn_val_I[nsn]);
+   }
+   Vector front(max_front*max_front);
+   double *F = front.GetData();
+   Array<int> relpos(height);
+
+   // stack of the update matrices of the supernodes whose parent has not been
+   // processed yet; the children of a supernode are always on top of it
+   std::vector<double> ustack;
+   std::vector<int> ustack_sn;
+   std::vector<size_t> ustack_off;
+
+   for (int s = 0; s < nsn; s++)
+   {
+      const int f = sn_col[s], ns = sn_col[s+1] - f;
+      const int *rows = sn_rows.GetData() + sn_rows_I[s];
+      const int m = sn_rows_I[s+1] - sn_rows_I[s];
+      for (int i = 0; i < m; i++) { relpos[rows[i]] = i; }
+
+      // assemble the frontal matrix (lower triangle)
+      std::fill(F, F + m*m, 0.0);
+      for (int jj = 0; jj < ns; jj++)
+      {
+         double *Fj = F + jj*m;
+         for (int a = acol_I[f+jj]; a < acol_I[f+jj+1]; a++)
+         {
+            Fj[relpos[acol_row[a]]] += Adata[acol_src[a]];
+         }
+      }
+      for (int c = 0; c < sn_nchild[s]; c++)
+      {
+         const int cs = ustack_sn.back();
+         const double *U = ustack.data() + ustack_off.back();
+         const int cns = sn_col[cs+1] - sn_col[cs];
+         const int *crows = sn_rows.GetData() + sn_rows_I[cs] + cns;
+         const int mu = sn_rows_I[cs+1] - sn_rows_I[cs] - cns;
+         for (int jj = 0; jj < mu; jj++)
+         {
+            double *Fj = F + relpos[crows[jj]]*m;
+            const double *Uj = U + jj*mu;
+            for (int ii = jj; ii < mu; ii++)
+            {
+               Fj[relpos[crows[ii]]] += Uj[ii];
+            }
+         }
+         ustack.resize(ustack_off.back());
+         ustack_sn.pop_back();
+         ustack_off.pop_back();
+      }
+
+      // factor the first ns columns of the frontal matrix
+      for (int k = 0; k < ns; k++)
+      {
+         double *Fk = F + k*m;
+         const double d = Fk[k];
+         if (type == CHOLESKY)
+         {
+            MFEM_VERIFY(d > 0.0, "the matrix is not positive definite,"
+                        " pivot " << f+k << " = " << d);
+            const double dk = std::sqrt(d);
+            Fk[k] = dk;
+            for (int i = k+1; i < m; i++) { Fk[i] /= dk; }
+            for (int j = k+1; j < ns; j++)
+            {
+               double *Fj = F + j*m;
+               const double t = Fk[j];
+               for (int i = j; i < m; i++) { Fj[i] -= Fk[i]*t; }
+            }
+         }
+         else
+         {
+            MFEM_VERIFY(d != 0.0, "zero pivot " << f+k);
+            for (int j = k+1; j < ns; j++)
+            {
+               double *Fj = F + j*m;
+               const double t = Fk[j]/d;
+               for (int i = j; i < m; i++) { Fj[i] -= Fk[i]*t; }
+            }
+            for (int i = k+1; i < m; i++) { Fk[i] /= d; }
+         }
+      }
+
+      // Schur complement: F22 -= L21 D L21^T
+      const int mu = m - ns;
+      const bool ldlt = (type == LDLT);
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp parallel for schedule(dynamic,8) if (mu*ns > 16384)
+#endif
+      for (int j = ns; j < m; j++)
+      {
+         double *Fj = F + j*m;
+         for (int k = 0; k < ns; k++)
+         {
+            const double *Fk = F + k*m;
+            const double t = ldlt ? Fk[j]*Fk[k] : Fk[j];
+            for (int i = j; i < m; i++) { Fj[i] -= Fk[i]*t; }
+         }
+      }
+
+      if (factor_single)
+      {
+         std::copy(F, F + m*ns, Lval_sp.begin() + sn_val_I[s]);
+      }
+      else
+      {
+         std::copy(F, F + m*ns, Lval.GetData() + sn_val_I[s]);
+      }
+      if (mu > 0)
+      {
+         const size_t off = ustack.size();
+         ustack.resize(off + size_t(mu)*mu);
+         double *U = ustack.data() + off;
+         for (int jj = 0; jj < mu; jj++)
+         {
+            std::copy(F + (ns+jj)*m + ns, F + (ns+jj+1)*m, U + jj*mu);
+         }
+         ustack_sn.push_back(s);
+         ustack_off.push_back(off);
+      }
+   }
+   MFEM_ASSERT(ustack_sn.empty(), "internal error");
+}
+
+SparseCholeskySolver::SparseCholeskySolver(Factorization type_)
+   : mat(NULL), type(type_), ordering(NESTED_DISSECTION), max_front(0),
+     single(false), factor_single(false) { }
+
+SparseCholeskySolver::SparseCholeskySolver(const SparseMatrix &A,
+                                           Factorization type_)
+   : mat(NULL), type(type_), ordering(NESTED_DISSECTION), max_front(0),
+     single(false), factor_single(false)
+{
+   SetOperator(A);
+}
+
+void SparseCholeskySolver::SetOperator(const Operator &op)
+{
+   mat = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(mat, "not a SparseMatrix");
+   MFEM_VERIFY(mat->Finalized(), "the SparseMatrix is not finalized");
+   MFEM_VERIFY(mat->Height() == mat->Width(), "not a square matrix");
+
+   const int n = mat->Height();
+   const int nnz = mat->NumNonZeroElems();
+   const bool same = (n == height && sym_I.Size() == n + 1 &&
+                      sym_J.Size() == nnz &&
+                      std::equal(sym_I.GetData(), sym_I.GetData() + n + 1,
+                                 mat->GetI()) &&
+                      std::equal(sym_J.GetData(), sym_J.GetData() + nnz,
+                                 mat->GetJ()));
+   if (!same)
+   {
+      height = width = n;
+      Analyze();
+      sym_I.SetSize(n + 1);
+      sym_J.SetSize(nnz);
+      std::copy(mat->GetI(), mat->GetI() + n + 1, sym_I.GetData());
+      std::copy(mat->GetJ(), mat->GetJ() + nnz, sym_J.GetData());
+   }
+   Factor();
+}
+
+void SparseCholeskySolver::UpdateValues(const Operator &op)
+{
+   mat = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(mat, "not a SparseMatrix");
+   MFEM_VERIFY(sym_I.Size() == height + 1 && mat->Height() == height &&
+               mat->NumNonZeroElems() == sym_J.Size(),
+               "the sparsity pattern has changed, use SetOperator()");
+   Factor();
+}
+
+// Forward and backward substitution with the supernodal factor L (and D), in
+// place for the nrhs vectors in Y, in the precision of the type T.
+template <typename T>
+static void SupernodalSolve(bool ldlt, int n, int nsn, const int *sn_col,
+                            const int *sn_rows_I, const int *sn_rows,
+                            const int *sn_val_I, const T *Lval,
+                            int nrhs, T *Y)
+{
+   // forward substitution with L (and D)
+   for (int s = 0; s < nsn; s++)
+   {
+      const int f = sn_col[s], ns = sn_col[s+1] - f;
+      const int *rows = sn_rows + sn_rows_I[s];
+      const int m = sn_rows_I[s+1] - sn_rows_I[s];
+      const T *L = Lval + sn_val_I[s];
+      for (int r = 0; r < nrhs; r++)
+      {
+         T *y = Y + size_t(r)*n;
+         for (int k = 0; k < ns; k++)
+         {
+            const T *Lk = L + k*m;
+            const T yk = ldlt ? y[f+k] : (y[f+k] /= Lk[k]);
+            for (int i = k+1; i < m; i++) { y[rows[i]] -= Lk[i]*yk; }
+         }
+         if (ldlt)
+         {
+            for (int k = 0; k < ns; k++) { y[f+k] /= L[k*m+k]; }
+         }
+      }
+   }
+
+   // backward substitution with L^T
+   for (int s = nsn-1; s >= 0; s--)
+   {
+      const int f = sn_col[s], ns = sn_col[s+1] - f;
+      const int *rows = sn_rows + sn_rows_I[s];
+      const int m = sn_rows_I[s+1] - sn_rows_I[s];
+      const T *L = Lval + sn_val_I[s];
+      for (int r = 0; r < nrhs; r++)
+      {
+         T *y = Y + size_t(r)*n;
+         for (int k = ns-1; k >= 0; k--)
+         {
+            const T *Lk = L + k*m;
+            T yk = y[f+k];
+            for (int i = k+1; i < m; i++) { yk -= Lk[i]*y[rows[i]]; }
+            y[f+k] = ldlt ? yk : yk/Lk[k];
+         }
+      }
+   }
+}
+
+void SparseCholeskySolver::Solve(int nrhs, double *Y) const
+{
+   const int n = height, nsn = GetNumSupernodes();
+   const bool ldlt = (type == LDLT);
+   // the precision of the factor, not the one requested for the next Factor()
+   if (!factor_single)
+   {
+      SupernodalSolve(ldlt, n, nsn, sn_col.GetData(), sn_rows_I.GetData(),
+                      sn_rows.GetData(), sn_val_I.GetData(), Lval.GetData(),
+                      nrhs, Y);
+      return;
+   }
+   std::vector<float> Ysp(Y, Y + size_t(n)*nrhs);
+   SupernodalSolve(ldlt, n, nsn, sn_col.GetData(), sn_rows_I.GetData(),
+                   sn_rows.GetData(), sn_val_I.GetData(), Lval_sp.data(),
+                   nrhs, Ysp.data());
+   std::copy(Ysp.begin(), Ysp.end(), Y);
+}
+
+void SparseCholeskySolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(mat, "the operator is not set");
+   const int n = height;
+   const double *bd = b.HostRead();
+   Vector y(n);
+   for (int k = 0; k < n; k++) { y(k) = bd[perm[k]]; }
+   Solve(1, y.GetData());
+   double *xd = x.HostWrite();
+   for (int k = 0; k < n; k++) { xd[perm[k]] = y(k); }
+}
+
+void SparseCholeskySolver::ArrayMult(const Array<const Vector *> &B,
+                                     Array<Vector *> &X) const
+{
+   MFEM_VERIFY(mat, "the operator is not set");
+   MFEM_VERIFY(B.Size() == X.Size(), "incompatible arrays");
+   const int n = height, nrhs = B.Size();
+   Vector Y(n*nrhs);
+   for (int r = 0; r < nrhs; r++)
+   {
+      const double *bd = B[r]->HostRead();
+      double *y = Y.GetData() + r*n;
+      for (int k = 0; k < n; k++) { y[k] = bd[perm[k]]; }
+   }
+   Solve(nrhs, Y.GetData());
+   for (int r = 0; r < nrhs; r++)
+   {
+      double *xd = X[r]->HostWrite();
+      const double *y = Y.GetData() + r*n;
+      for (int k = 0; k < n; k++) { xd[perm[k]] = y[k]; }
+   }
+}
+
+void SparseCholeskySolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   MFEM_VERIFY(B.Height() == height, "incompatible dimensions");
+   const int nrhs = B.Width();
+   X.SetSize(height, nrhs);
+   Array<const Vector *> b(nrhs);
+   Array<Vector *> x(nrhs);
+   Vector *cols = new Vector[2*nrhs];
+   for (int r = 0; r < nrhs; r++)
+   {
+      cols[r].SetDataAndSize(const_cast<double *>(B.GetColumn(r)), height);
+      X.GetColumnReference(r, cols[nrhs+r]);
+      b[r] = &cols[r];
+      x[r] = &cols[nrhs+r];
+   }
+   ArrayMult(b, x);
+   delete [] cols;
+}
+
+long SparseCholeskySolver::GetFactorNNZ() const
+{
+   long nnz = 0;
+   for (int s = 0; s < GetNumSupernodes(); s++)
+   {
+      const long ns = sn_col[s+1] - sn_col[s];
+      const long m = sn_rows_I[s+1] - sn_rows_I[s];
+      nnz += ns*m - ns*(ns - 1)/2;
+   }
+   return nnz;
+}
+
+}
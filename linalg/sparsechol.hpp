@@ -0,0 +1,177 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPARSECHOL
+#define MFEM_SPARSECHOL
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+#include <vector>
+
+namespace mfem
+{
+
+/** @brief Direct solver for symmetric SparseMatrix systems based on a
+    supernodal multifrontal Cholesky (A = L L^T) or LDL^T (A = L D L^T)
+    factorization. */
+/** The factorization is computed in two phases:
+    - the symbolic analysis, which computes a fill-reducing ordering, the
+      elimination tree, and the supernode partition and structure of L;
+    - the numeric factorization, which processes the supernodes in postorder,
+      assembling each dense frontal matrix from the entries of A and the update
+      matrices of its children, and factoring it with dense kernels.
+
+    The symbolic analysis is reused by SetOperator() when the new matrix has
+    the same sparsity pattern as the previous one, and by UpdateValues().
+
+    Only the upper triangle (in the fill-reducing ordering) of the matrix is
+    accessed, so the matrix must be symmetric. The LDL^T factorization does not
+    pivot: it is intended for symmetric indefinite matrices that admit such a
+    factorization, e.g. negative definite or quasi-definite matrices.
+
+    When MFEM is built with MFEM_USE_LEGACY_OPENMP, the Schur complement
+    updates of large frontal matrices are computed in parallel.
+
+    With SetSinglePrecision(), the factor is stored and the triangular solves
+    are performed in single precision, which halves the memory and the bytes
+    moved by the solves. This is intended for use as the inner solver of a
+    MixedPrecisionSolver, which recovers double precision accuracy. */
+class SparseCholeskySolver : public Solver
+{
+public:
+   /// Type of the factorization.
+   enum Factorization
+   {
+      CHOLESKY, ///< A = L L^T, A must be symmetric positive definite
+      LDLT      ///< A = L D L^T with unit lower triangular L and diagonal D
+   };
+
+   /// Fill-reducing ordering used in the symbolic analysis.
+   enum Ordering
+   {
+      NATURAL,            ///< No reordering
+      MINIMUM_DEGREE,     ///< Approximate minimum degree
+      NESTED_DISSECTION   /**< METIS nested dissection, if MFEM is built
+                               with METIS, otherwise MINIMUM_DEGREE */
+   };
+
+protected:
+   const SparseMatrix *mat;
+   Factorization type;
+   Ordering ordering;
+
+   /// Sparsity pattern of the symbolic factorization.
+   Array<int> sym_I, sym_J;
+
+   /// Fill-reducing permutation: row @a k of the factor is row perm[k] of A.
+   Array<int> perm, iperm;
+
+   /** The upper triangle of the permuted matrix, stored by columns of the
+       lower triangle: for column j, the rows acol_row[acol_I[j]...] and the
+       corresponding indices in the data array of #mat, acol_src. */
+   Array<int> acol_I, acol_row, acol_src;
+
+   /** Supernode s contains the columns sn_col[s] ... sn_col[s+1]-1. Its row
+       structure (including the diagonal block) is sn_rows[sn_rows_I[s] ...
+       sn_rows_I[s+1]-1] and its dense column-major panel of L starts at
+       Lval[sn_val_I[s]]. */
+   Array<int> sn_col, sn_rows_I, sn_rows, sn_val_I;
+   /// Number of children of each supernode in the supernodal elimination tree.
+   Array<int> sn_nchild;
+   /// Maximal row count of a supernode, i.e. the largest frontal matrix size.
+   int max_front;
+
+   /** Values of the factor L. For LDL^T, the diagonal entries of the panels
+       hold D and the unit diagonal of L is implicit. In single precision, the
+       values are stored in #Lval_sp instead. */
+   Vector Lval;
+   std::vector<float> Lval_sp;
+   /** Requested precision (#single) and the precision of the current factor
+       (#factor_single), which changes only in Factor(). */
+   bool single, factor_single;
+
+   /// Compute the fill-reducing ordering of the graph of A + A^T.
+   void ComputeOrdering(const Array<int> &xadj, const Array<int> &adj);
+
+   /// Compute the symbolic factorization of #mat.
+   void Analyze();
+
+   /// Compute the numeric factorization of #mat.
+   void Factor();
+
+   /** Solve in place for the @a nrhs vectors stored by columns in @a Y
+       (leading dimension #height), given in the permuted ordering. */
+   void Solve(int nrhs, double *Y) const;
+
+public:
+   /// Create a solver with the given factorization @a type.
+   SparseCholeskySolver(Factorization type = CHOLESKY);
+
+   /// Create a solver with the given factorization @a type and factor @a A.
+   SparseCholeskySolver(const SparseMatrix &A,
+                        Factorization type = CHOLESKY);
+
+   /** @brief Set the fill-reducing ordering. Takes effect in the next call to
+       SetOperator() with a new sparsity pattern. The default is
+       NESTED_DISSECTION. */
+   void SetOrdering(Ordering ord) { ordering = ord; sym_I.DeleteAll(); }
+
+   /** @brief Store the factor and perform the solves in single precision.
+       Takes effect in the next factorization. */
+   /** The factorization itself is computed in double precision, so a matrix
+       which is positive definite in double precision can always be factored
+       with the CHOLESKY type. */
+   void SetSinglePrecision(bool sp = true) { single = sp; }
+
+   /** @brief Factor the given Operator @a op, which must be a symmetric
+       SparseMatrix.
+
+       If the sparsity pattern of @a op is the same as the one of the previous
+       operator, the symbolic factorization is reused and only the numeric
+       factorization is computed. */
+   virtual void SetOperator(const Operator &op);
+
+   /** @brief Factor the given Operator @a op, which must be a SparseMatrix
+       with the same sparsity pattern as the previous operator, reusing the
+       symbolic factorization without comparing the patterns. */
+   void UpdateValues(const Operator &op);
+
+   /// Solve A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Since A is symmetric, this is the same as Mult().
+   virtual void MultTranspose(const Vector &b, Vector &x) const
+   { Mult(b, x); }
+
+   /** @brief Solve for all right-hand sides @a B at once, traversing the
+       factor only once. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+
+   /// Solve for the columns of @a B, see ArrayMult().
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+
+   /// Return the fill-reducing permutation: row @a k of L is row perm[k] of A.
+   const Array<int> &GetPermutation() const { return perm; }
+
+   /// Return the number of supernodes.
+   int GetNumSupernodes() const { return sn_col.Size() - 1; }
+
+   /// Return the number of nonzero entries in L, including the diagonal.
+   long GetFactorNNZ() const;
+};
+
+}
+
+#endif
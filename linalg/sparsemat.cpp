@@ -549,6 +549,57 @@ void SparseMatrix::Mult(const Vector &x, Vector &y) const
    AddMult(x, y);
 }
 
+void SparseMatrix::ArrayMult(const Array<const Vector *> &X,
+                             Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible arrays of vectors");
+
+   if (!Finalized() || Device::IsEnabled())
+   {
+      Operator::ArrayMult(X, Y);
+      return;
+   }
+
+   // Number of vectors processed with a single pass over the matrix data; the
+   // partial sums of one row are kept in registers.
+   const int NB = 8;
+   const double *xp[NB];
+   double *yp[NB];
+   const double *Ap = A;
+   const int *Ip = I, *Jp = J;
+   const int nv = X.Size();
+   for (int k0 = 0; k0 < nv; k0 += NB)
+   {
+      const int nb = std::min(NB, nv - k0);
+      for (int k = 0; k < nb; k++)
+      {
+         MFEM_ASSERT(X[k0+k]->Size() == width && Y[k0+k]->Size() == height,
+                     "invalid vector sizes");
+         xp[k] = X[k0+k]->HostRead();
+         yp[k] = Y[k0+k]->HostWrite();
+      }
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < height; i++)
+      {
+         double d[NB];
+         for (int k = 0; k < nb; k++) { d[k] = 0.0; }
+         const int end = Ip[i+1];
+         for (int j = Ip[i]; j < end; j++)
+         {
+            const double a = Ap[j];
+            const int c = Jp[j];
+            for (int k = 0; k < nb; k++)
+            {
+               d[k] += a * xp[k][c];
+            }
+         }
+         for (int k = 0; k < nb; k++) { yp[k][i] = d[k]; }
+      }
+   }
+}
+
 void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 {
    MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
@@ -152,6 +152,14 @@ public:
    /// Return the element data, i.e. the array #A, const version.
    inline const double *GetData() const { return A; }
 
+   /** @brief Return the arrays #I, #J and #A of a finalized matrix, for reading
+       on the host. */
+   const int *HostReadI() const { return mfem::HostRead(I, height+1); }
+   const int *HostReadJ() const
+   { return mfem::HostRead(J, HostReadI()[height]); }
+   const double *HostReadData() const
+   { return mfem::HostRead(A, HostReadI()[height]); }
+
    /// Returns the number of elements in row @a i.
    int RowSize(const int i) const;
 
@@ -216,6 +224,13 @@ public:
    /// Matrix vector multiplication.
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Matrix multiplication with a set of vectors: `Y[i] = A * X[i]`,
+       reading the matrix entries once for every block of (up to 8) vectors. */
+   /** With a device backend enabled, or if the matrix is not finalized, this
+       method falls back to Operator::ArrayMult(). */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
@@ -51,6 +51,135 @@ void GSSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+/// Create the multicolor Gauss-Seidel smoother.
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           double w, int it)
+{
+   type = t;
+   omega = w;
+   iterations = it;
+   SetOperator(a);
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(height == width, "the SparseMatrix must be square");
+   ComputeColoring();
+}
+
+void MulticolorGSSmoother::ComputeColoring()
+{
+   const int n = height;
+   const int *I = oper->GetI(), *J = oper->GetJ();
+
+   // pattern of A^T, to color the graph of A + A^T
+   Array<int> tI(n+1), tJ(I[n]);
+   tI = 0;
+   for (int k = 0; k < I[n]; k++) { tI[J[k]+1]++; }
+   for (int i = 0; i < n; i++) { tI[i+1] += tI[i]; }
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++) { tJ[tI[J[k]]++] = i; }
+   }
+   for (int i = n; i > 0; i--) { tI[i] = tI[i-1]; }
+   tI[0] = 0;
+
+   // greedy coloring: the smallest color not used by a colored neighbor
+   Array<int> color(n), mark;
+   int num_colors = 0;
+   diag.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      diag[i] = -1;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { diag[i] = k; }
+         else if (J[k] < i) { mark[color[J[k]]] = i; }
+      }
+      for (int k = tI[i]; k < tI[i+1]; k++)
+      {
+         if (tJ[k] < i) { mark[color[tJ[k]]] = i; }
+      }
+      int c = 0;
+      while (c < num_colors && mark[c] == i) { c++; }
+      if (c == num_colors)
+      {
+         num_colors++;
+         mark.Append(-1);
+      }
+      color[i] = c;
+   }
+
+   color_I.SetSize(num_colors+1);
+   color_I = 0;
+   for (int i = 0; i < n; i++) { color_I[color[i]+1]++; }
+   color_I.PartialSum();
+   color_rows.SetSize(n);
+   for (int i = 0; i < n; i++) { color_rows[color_I[color[i]]++] = i; }
+   for (int c = num_colors; c > 0; c--) { color_I[c] = color_I[c-1]; }
+   color_I[0] = 0;
+}
+
+void MulticolorGSSmoother::GetColoring(Array<int> &colors) const
+{
+   colors.SetSize(height);
+   for (int c = 0; c < GetNumColors(); c++)
+   {
+      for (int k = color_I[c]; k < color_I[c+1]; k++)
+      {
+         colors[color_rows[k]] = c;
+      }
+   }
+}
+
+void MulticolorGSSmoother::ColorSweep(int c, const double *b, double *x) const
+{
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   const double *A = oper->GetData();
+   const int begin = color_I[c], end = color_I[c+1];
+   const double w = omega;
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int r = begin; r < end; r++)
+   {
+      const int i = color_rows[r], d = diag[i];
+      double sum = b[i];
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (k != d) { sum -= A[k]*x[J[k]]; }
+      }
+      MFEM_ASSERT(d >= 0 && A[d] != 0.0, "zero diagonal entry in row " << i);
+      x[i] += w*(sum/A[d] - x[i]);
+   }
+}
+
+/// Matrix vector multiplication with the multicolor GS/SOR smoother.
+void MulticolorGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(oper, "the operator is not set");
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   const int nc = GetNumColors();
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         for (int c = 0; c < nc; c++) { ColorSweep(c, xp, yp); }
+      }
+      if (type != 1)
+      {
+         for (int c = nc-1; c >= 0; c--) { ColorSweep(c, xp, yp); }
+      }
+   }
+}
+
 /// Create the Jacobi smoother.
 DSmoother::DSmoother(const SparseMatrix &a, int t, double s, int it)
    : SparseSmoother(a)
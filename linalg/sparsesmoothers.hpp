@@ -51,6 +51,64 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Multicolor Gauss-Seidel, SOR and SSOR smoother of sparse matrix,
+    which sweeps the rows of each color in parallel. */
+/** The rows are colored once in SetOperator(), with a greedy coloring of the
+    graph of A + A^T, so that no two rows of the same color are coupled. The
+    Gauss-Seidel sweeps process the colors one after the other and the rows
+    within a color in any order, in parallel when MFEM is built with
+    MFEM_USE_LEGACY_OPENMP. The result does not depend on the number of
+    threads.
+
+    The backward sweep processes the colors in reverse order, so the symmetric
+    smoother (type 0) of a symmetric matrix is symmetric and can be used as a
+    preconditioner for CG. With a relaxation parameter @a w different from 1,
+    the sweeps are SOR sweeps and the symmetric smoother is SSOR.
+
+    The matrix must be finalized and its sparsity pattern must not change after
+    SetOperator(); its values may change. */
+class MulticolorGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   double omega;
+   int iterations;
+
+   /// The rows of color c are color_rows[color_I[c] ... color_I[c+1]-1].
+   Array<int> color_I, color_rows;
+   /// Index of the diagonal entry of each row in the data array of the matrix.
+   Array<int> diag;
+
+   void ComputeColoring();
+
+   /// One (relaxed) Gauss-Seidel sweep over the rows of color @a c.
+   void ColorSweep(int c, const double *b, double *x) const;
+
+public:
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(int t = 0, double w = 1.0, int it = 1)
+   { type = t; omega = w; iterations = it; }
+
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, double w = 1.0,
+                        int it = 1);
+
+   /// Set the SOR relaxation parameter; 1 corresponds to Gauss-Seidel.
+   void SetRelaxation(double w) { omega = w; }
+
+   /// Set the matrix and compute the coloring of its rows.
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of colors.
+   int GetNumColors() const { return color_I.Size() - 1; }
+
+   /// Return the color of each row in @a colors.
+   void GetColoring(Array<int> &colors) const;
+
+   /// Matrix vector multiplication with the multicolor GS/SOR smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 /// Data type for scaled Jacobi-type smoother of sparse matrix
 class DSmoother : public SparseSmoother
 {
@@ -445,6 +445,100 @@ void subtract(const double a, const Vector &x, const Vector &y, Vector &z)
    }
 }
 
+double AddAndDot(const Vector &x, double a, const Vector &y, Vector &z,
+                 const Vector &w)
+{
+   MFEM_ASSERT(x.Size() == y.Size() && x.Size() == z.Size() &&
+               x.Size() == w.Size(), "incompatible Vectors!");
+
+   const bool use_dev = x.UseDevice() || y.UseDevice() || z.UseDevice() ||
+                        w.UseDevice();
+   const int N = z.Size();
+   // Note: get read access first, in case z is the same as x/y/w.
+   auto xd = x.Read(use_dev);
+   auto yd = y.Read(use_dev);
+   auto wd = w.Read(use_dev);
+   auto zd = z.Write(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Sum, i, N,
+   {
+      const double zi = xd[i] + a * yd[i];
+      zd[i] = zi;
+      return zi * wd[i];
+   });
+}
+
+double AddAndNormSquared(double a, const Vector &x, double b, const Vector &y,
+                         Vector &z)
+{
+   MFEM_ASSERT(x.Size() == y.Size() && x.Size() == z.Size(),
+               "incompatible Vectors!");
+
+   const bool use_dev = x.UseDevice() || y.UseDevice() || z.UseDevice();
+   const int N = z.Size();
+   // Note: get read access first, in case z is the same as x/y.
+   auto xd = x.Read(use_dev);
+   auto yd = y.Read(use_dev);
+   auto zd = z.Write(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Sum, i, N,
+   {
+      const double zi = a * xd[i] + b * yd[i];
+      zd[i] = zi;
+      return zi * zi;
+   });
+}
+
+double CGUpdate(double alpha, const Vector &d, const Vector &Ad, Vector &x,
+                Vector &r)
+{
+   MFEM_ASSERT(d.Size() == Ad.Size() && d.Size() == x.Size() &&
+               d.Size() == r.Size(), "incompatible Vectors!");
+
+   const bool use_dev = d.UseDevice() || Ad.UseDevice() || x.UseDevice() ||
+                        r.UseDevice();
+   const int N = x.Size();
+   auto dd = d.Read(use_dev);
+   auto Add = Ad.Read(use_dev);
+   auto xd = x.ReadWrite(use_dev);
+   auto rd = r.ReadWrite(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Sum, i, N,
+   {
+      xd[i] += alpha * dd[i];
+      const double ri = rd[i] - alpha * Add[i];
+      rd[i] = ri;
+      return ri * ri;
+   });
+}
+
+void Dot2(const Vector &x, const Vector &y, const Vector &z, double *dots)
+{
+   MFEM_ASSERT(x.Size() == y.Size() && x.Size() == z.Size(),
+               "incompatible Vectors!");
+
+   const bool use_dev = x.UseDevice() || y.UseDevice() || z.UseDevice();
+   const int N = x.Size();
+   auto xd = x.Read(use_dev);
+   auto yd = y.Read(use_dev);
+   auto zd = z.Read(use_dev);
+   if (use_dev && Device::IsEnabled())
+   {
+      // MFEM_FORALL_REDUCE combines scalar values only
+      dots[0] = MFEM_FORALL_REDUCE(true, Sum, i, N, return xd[i]*yd[i];);
+      dots[1] = MFEM_FORALL_REDUCE(true, Sum, i, N, return xd[i]*zd[i];);
+      return;
+   }
+   double xy = 0.0, xz = 0.0;
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for reduction(+:xy,xz)
+#endif
+   for (int i = 0; i < N; i++)
+   {
+      xy += xd[i] * yd[i];
+      xz += xd[i] * zd[i];
+   }
+   dots[0] = xy;
+   dots[1] = xz;
+}
+
 void Vector::median(const Vector &lo, const Vector &hi)
 {
    MFEM_ASSERT(size == lo.size && size == hi.size,
@@ -716,6 +810,33 @@ double Vector::Norml2() const
       return 0.0;
    } // end if 0 == size
 
+   const bool use_dev = UseDevice();
+   if (use_dev && Device::IsEnabled())
+   {
+      // On the device, compute the sum of squares with one reduction and use
+      // a second, scaled, reduction only in case of overflow or underflow.
+      const int N = size;
+      auto m_data = Read();
+      const double nrm2 =
+         MFEM_FORALL_REDUCE(true, Sum, i, N, return m_data[i]*m_data[i];);
+      if (IsFinite(nrm2) &&
+          nrm2 >= std::numeric_limits<double>::min() /
+          std::numeric_limits<double>::epsilon())
+      {
+         return std::sqrt(nrm2);
+      }
+      const double scale = Normlinf();
+      if (scale == 0.0) { return 0.0; }
+      const double s = 1.0/scale;
+      const double sum = MFEM_FORALL_REDUCE(true, Sum, i, N,
+      {
+         const double d = m_data[i]*s;
+         return d*d;
+      });
+      return scale * std::sqrt(sum);
+   }
+
+   data.Read(MemoryClass::HOST, size);
    if (1 == size)
    {
       return std::abs(data[0]);
@@ -745,22 +866,20 @@ double Vector::Norml2() const
 
 double Vector::Normlinf() const
 {
-   double max = 0.0;
-   for (int i = 0; i < size; i++)
-   {
-      max = std::max(std::abs(data[i]), max);
-   }
-   return max;
+   const bool use_dev = UseDevice();
+   const int N = size;
+   auto m_data = Read(use_dev);
+   const double max = MFEM_FORALL_REDUCE(use_dev, Max, i, N,
+                                         return fabs(m_data[i]););
+   return (N > 0) ? max : 0.0;
 }
 
 double Vector::Norml1() const
 {
-   double sum = 0.0;
-   for (int i = 0; i < size; i++)
-   {
-      sum += std::abs(data[i]);
-   }
-   return sum;
+   const bool use_dev = UseDevice();
+   const int N = size;
+   auto m_data = Read(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Sum, i, N, return fabs(m_data[i]););
 }
 
 double Vector::Normlp(double p) const
@@ -817,133 +936,29 @@ double Vector::Max() const
 {
    if (size == 0) { return -infinity(); }
 
-   double max = data[0];
-
-   for (int i = 1; i < size; i++)
-   {
-      if (data[i] > max)
-      {
-         max = data[i];
-      }
-   }
-
-   return max;
+   const bool use_dev = UseDevice();
+   const int N = size;
+   auto m_data = Read(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Max, i, N, return m_data[i];);
 }
 
 double Vector::Sum() const
 {
-   double sum = 0.0;
-
-   for (int i = 0; i < size; i++)
-   {
-      sum += data[i];
-   }
-
-   return sum;
-}
-
-#ifdef MFEM_USE_CUDA
-static __global__ void cuKernelMin(const int N, double *gdsr, const double *x)
-{
-   __shared__ double s_min[MFEM_CUDA_BLOCKS];
-   const int n = blockDim.x*blockIdx.x + threadIdx.x;
-   if (n>=N) { return; }
-   const int bid = blockIdx.x;
-   const int tid = threadIdx.x;
-   const int bbd = bid*blockDim.x;
-   const int rid = bbd+tid;
-   s_min[tid] = x[n];
-   for (int workers=blockDim.x>>1; workers>0; workers>>=1)
-   {
-      __syncthreads();
-      if (tid >= workers) { continue; }
-      if (rid >= N) { continue; }
-      const int dualTid = tid + workers;
-      if (dualTid >= N) { continue; }
-      const int rdd = bbd+dualTid;
-      if (rdd >= N) { continue; }
-      if (dualTid >= blockDim.x) { continue; }
-      s_min[tid] = fmin(s_min[tid], s_min[dualTid]);
-   }
-   if (tid==0) { gdsr[bid] = s_min[0]; }
-}
-
-static Array<double> cuda_reduce_buf;
-
-static double cuVectorMin(const int N, const double *X)
-{
-   const int tpb = MFEM_CUDA_BLOCKS;
-   const int blockSize = MFEM_CUDA_BLOCKS;
-   const int gridSize = (N+blockSize-1)/blockSize;
-   const int min_sz = (N%tpb)==0? (N/tpb) : (1+N/tpb);
-   cuda_reduce_buf.SetSize(min_sz);
-   Memory<double> &buf = cuda_reduce_buf.GetMemory();
-   double *d_min = buf.Write(MemoryClass::CUDA, min_sz);
-   cuKernelMin<<<gridSize,blockSize>>>(N, d_min, X);
-   MFEM_GPU_CHECK(cudaGetLastError());
-   const double *h_min = buf.Read(MemoryClass::HOST, min_sz);
-   double min = std::numeric_limits<double>::infinity();
-   for (int i = 0; i < min_sz; i++) { min = fmin(min, h_min[i]); }
-   return min;
-}
-
-static __global__ void cuKernelDot(const int N, double *gdsr,
-                                   const double *x, const double *y)
-{
-   __shared__ double s_dot[MFEM_CUDA_BLOCKS];
-   const int n = blockDim.x*blockIdx.x + threadIdx.x;
-   if (n>=N) { return; }
-   const int bid = blockIdx.x;
-   const int tid = threadIdx.x;
-   const int bbd = bid*blockDim.x;
-   const int rid = bbd+tid;
-   s_dot[tid] = x[n] * y[n];
-   for (int workers=blockDim.x>>1; workers>0; workers>>=1)
-   {
-      __syncthreads();
-      if (tid >= workers) { continue; }
-      if (rid >= N) { continue; }
-      const int dualTid = tid + workers;
-      if (dualTid >= N) { continue; }
-      const int rdd = bbd+dualTid;
-      if (rdd >= N) { continue; }
-      if (dualTid >= blockDim.x) { continue; }
-      s_dot[tid] += s_dot[dualTid];
-   }
-   if (tid==0) { gdsr[bid] = s_dot[0]; }
-}
-
-static double cuVectorDot(const int N, const double *X, const double *Y)
-{
-   const int tpb = MFEM_CUDA_BLOCKS;
-   const int blockSize = MFEM_CUDA_BLOCKS;
-   const int gridSize = (N+blockSize-1)/blockSize;
-   const int dot_sz = (N%tpb)==0? (N/tpb) : (1+N/tpb);
-   cuda_reduce_buf.SetSize(dot_sz);
-   Memory<double> &buf = cuda_reduce_buf.GetMemory();
-   double *d_dot = buf.Write(MemoryClass::CUDA, dot_sz);
-   cuKernelDot<<<gridSize,blockSize>>>(N, d_dot, X, Y);
-   MFEM_GPU_CHECK(cudaGetLastError());
-   const double *h_dot = buf.Read(MemoryClass::HOST, dot_sz);
-   double dot = 0.0;
-   for (int i = 0; i < dot_sz; i++) { dot += h_dot[i]; }
-   return dot;
+   const bool use_dev = UseDevice();
+   const int N = size;
+   auto m_data = Read(use_dev);
+   return MFEM_FORALL_REDUCE(use_dev, Sum, i, N, return m_data[i];);
 }
-#endif // MFEM_USE_CUDA
 
 double Vector::operator*(const Vector &v) const
 {
    MFEM_ASSERT(size == v.size, "incompatible Vectors!");
 
    const bool use_dev = UseDevice() || v.UseDevice();
-#if defined(MFEM_USE_CUDA) || defined(MFEM_USE_OPENMP)
    auto m_data = Read(use_dev);
-#else
-   Read(use_dev);
-#endif
    auto v_data = v.Read(use_dev);
 
-   if (!use_dev) { goto vector_dot_cpu; }
+   if (!use_dev) { return operator*(v_data); }
 
 #ifdef MFEM_USE_OCCA
    if (DeviceCanUseOcca())
@@ -953,43 +968,8 @@ double Vector::operator*(const Vector &v) const
    }
 #endif
 
-#ifdef MFEM_USE_CUDA
-   if (Device::Allows(Backend::CUDA_MASK))
-   {
-      return cuVectorDot(size, m_data, v_data);
-   }
-#endif
-
-#ifdef MFEM_USE_HIP
-   if (Device::Allows(Backend::HIP_MASK))
-   {
-      auto m_data = HostRead();
-      auto v_data = v.HostRead();
-      double prod = 0.0;
-      const int N = size;
-      for (int i = 0; i < N; i++)
-      {
-         prod += m_data[i] * v_data[i];
-      }
-      return prod;
-   }
-#endif
-
-#ifdef MFEM_USE_OPENMP
-   if (Device::Allows(Backend::OMP_MASK))
-   {
-      double prod = 0.0;
-      #pragma omp parallel for reduction(+:prod)
-      for (int i = 0; i < size; i++)
-      {
-         prod += m_data[i] * v_data[i];
-      }
-      return prod;
-   }
-#endif
-
-vector_dot_cpu:
-   return operator*(v_data);
+   const int N = size;
+   return MFEM_FORALL_REDUCE(true, Sum, i, N, return m_data[i]*v_data[i];);
 }
 
 double Vector::Min() const
@@ -997,47 +977,17 @@ double Vector::Min() const
    if (size == 0) { return infinity(); }
 
    const bool use_dev = UseDevice();
+   const int N = size;
    auto m_data = Read(use_dev);
 
-   if (!use_dev) { goto vector_min_cpu; }
-
 #ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   if (use_dev && DeviceCanUseOcca())
    {
       return occa::linalg::min<double,double>(OccaMemoryRead(data, size));
    }
 #endif
 
-#ifdef MFEM_USE_CUDA
-   if (Device::Allows(Backend::CUDA_MASK))
-   {
-      return cuVectorMin(size, m_data);
-   }
-#endif
-
-#ifdef MFEM_USE_OPENMP
-   if (Device::Allows(Backend::OMP_MASK))
-   {
-      double minimum = m_data[0];
-      #pragma omp parallel for reduction(min:minimum)
-      for (int i = 0; i < size; i++)
-      {
-         minimum = std::min(minimum, m_data[i]);
-      }
-      return minimum;
-   }
-#endif
-
-vector_min_cpu:
-   double minimum = data[0];
-   for (int i = 1; i < size; i++)
-   {
-      if (m_data[i] < minimum)
-      {
-         minimum = m_data[i];
-      }
-   }
-   return minimum;
+   return MFEM_FORALL_REDUCE(use_dev, Min, i, N, return m_data[i];);
 }
 
 
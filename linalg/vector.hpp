@@ -360,6 +360,33 @@ public:
 #endif
 };
 
+/** @name Fused vector kernels
+
+    These functions combine a vector update with the local inner product(s)
+    that are needed immediately after it, so that the data is read only once.
+    They are intended for the inner loops of Krylov solvers; the returned values
+    are local (per MPI rank) and have to be summed for parallel vectors, see
+    IterativeSolver. */
+///@{
+
+/// Set z = x + a * y and return the inner product (z, w); @a w can be @a z.
+double AddAndDot(const Vector &x, double a, const Vector &y, Vector &z,
+                 const Vector &w);
+
+/// Set z = a * x + b * y and return the inner product (z, z).
+double AddAndNormSquared(double a, const Vector &x, double b, const Vector &y,
+                         Vector &z);
+
+/** @brief Conjugate gradient update: set x += alpha * d, r -= alpha * Ad and
+    return the inner product (r, r). */
+double CGUpdate(double alpha, const Vector &d, const Vector &Ad, Vector &x,
+                Vector &r);
+
+/// Compute the two inner products dots[0] = (x, y) and dots[1] = (x, z).
+void Dot2(const Vector &x, const Vector &y, const Vector &z, double *dots);
+
+///@}
+
 // Inline methods
 
 inline bool IsFinite(const double &val)
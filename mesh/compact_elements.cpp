@@ -0,0 +1,84 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class CompactElements
+
+#include "compact_elements.hpp"
+
+namespace mfem
+{
+
+void CompactElements::SetElements(const Array<Element*> &elems)
+{
+   const int ne = elems.Size();
+   offsets.SetSize(ne+1);
+   offsets[0] = 0;
+   for (int i = 0; i < ne; i++)
+   {
+      offsets[i+1] = offsets[i] + elems[i]->GetNVertices();
+   }
+   vertices.SetSize(offsets[ne]);
+   attributes.SetSize(ne);
+   geoms.SetSize(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      const Element *el = elems[i];
+      const int *v = el->GetVertices();
+      int *cv = vertices.GetData() + offsets[i];
+      for (int j = 0; j < offsets[i+1] - offsets[i]; j++) { cv[j] = v[j]; }
+      attributes[i] = el->GetAttribute();
+      geoms[i] = char(el->GetGeometryType());
+   }
+}
+
+void CompactElements::Reserve(int ne, int nv)
+{
+   offsets.Reserve(ne+1);
+   vertices.Reserve(nv);
+   attributes.Reserve(ne);
+   geoms.Reserve(ne);
+}
+
+void CompactElements::Append(Geometry::Type geom, const int *v, int attr)
+{
+   const int nv = Geometry::NumVerts[geom];
+   for (int j = 0; j < nv; j++) { vertices.Append(v[j]); }
+   offsets.Append(vertices.Size());
+   attributes.Append(attr);
+   geoms.Append(char(geom));
+}
+
+void CompactElements::Clear()
+{
+   offsets.SetSize(1);
+   offsets[0] = 0;
+   vertices.SetSize(0);
+   attributes.SetSize(0);
+   geoms.SetSize(0);
+}
+
+void CompactElements::MakeRef(int ne, int *offsets, int *vertices,
+                              char *geoms, int *attributes)
+{
+   MFEM_ASSERT(offsets[0] == 0, "invalid offsets");
+   this->offsets.MakeRef(offsets, ne+1);
+   this->vertices.MakeRef(vertices, offsets[ne]);
+   this->geoms.MakeRef(geoms, ne);
+   this->attributes.MakeRef(attributes, ne);
+}
+
+long CompactElements::MemoryUsage() const
+{
+   return (offsets.MemoryUsage() + vertices.MemoryUsage() +
+           attributes.MemoryUsage() + geoms.MemoryUsage());
+}
+
+}
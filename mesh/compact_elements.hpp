@@ -0,0 +1,97 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_COMPACT_ELEMENTS
+#define MFEM_COMPACT_ELEMENTS
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../fem/geom.hpp"
+#include "element.hpp"
+
+namespace mfem
+{
+
+/** @brief Compact structure-of-arrays storage of the connectivity of a set of
+    mesh elements: a CSR element-to-vertex array, an array of geometry types
+    and an array of attributes. */
+/** Unlike an array of Element pointers, this representation uses no heap
+    allocation and no virtual table pointer per element, and stores the
+    vertices of consecutive elements contiguously. It is used to export and
+    import the elements of a Mesh, see Mesh::GetCompactElements() and
+    Mesh::AddElements(), e.g. by the binary mesh format. The Mesh itself keeps
+    its elements as Element objects. */
+class CompactElements
+{
+protected:
+   /// The vertices of element i are vertices[offsets[i] ... offsets[i+1]-1].
+   Array<int> offsets, vertices;
+   Array<int> attributes;
+   Array<char> geoms;
+
+public:
+   CompactElements() { offsets.Append(0); }
+
+   /// Create the compact representation of the given elements.
+   explicit CompactElements(const Array<Element*> &elems)
+   { SetElements(elems); }
+
+   /// Replace the contents with the connectivity of the given elements.
+   void SetElements(const Array<Element*> &elems);
+
+   /// Reserve space for @a ne elements with @a nv vertices in total.
+   void Reserve(int ne, int nv);
+
+   /// Append an element with the given geometry, vertices and attribute.
+   void Append(Geometry::Type geom, const int *v, int attr = 1);
+
+   /// Remove all elements.
+   void Clear();
+
+   /** @brief Use the given arrays, e.g. arrays in a memory-mapped file, as the
+       storage of @a ne elements, without copying them. */
+   /** The arrays are not owned and must stay valid while they are used. They
+       have the layout of the members, i.e., @a offsets has @a ne + 1 entries,
+       the first of which is 0. */
+   void MakeRef(int ne, int *offsets, int *vertices, char *geoms,
+                int *attributes);
+
+   /// Return the number of elements.
+   int Size() const { return geoms.Size(); }
+
+   Geometry::Type GetGeometry(int i) const
+   { return Geometry::Type(geoms[i]); }
+
+   int GetAttribute(int i) const { return attributes[i]; }
+
+   void SetAttribute(int i, int attr) { attributes[i] = attr; }
+
+   int GetNVertices(int i) const { return offsets[i+1] - offsets[i]; }
+
+   const int *GetVertices(int i) const
+   { return vertices.GetData() + offsets[i]; }
+
+   int *GetVertices(int i) { return vertices.GetData() + offsets[i]; }
+
+   /// Return the offsets of the element vertices, Size()+1 entries.
+   const int *GetOffsets() const { return offsets.GetData(); }
+
+   /// Return the geometries of the elements, stored as char.
+   const char *GetGeometries() const { return geoms.GetData(); }
+
+   const int *GetAttributes() const { return attributes.GetData(); }
+
+   long MemoryUsage() const;
+};
+
+}
+
+#endif
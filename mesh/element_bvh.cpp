@@ -0,0 +1,302 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class ElementBVH
+
+#include "element_bvh.hpp"
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <limits>
+
+namespace mfem
+{
+
+ElementBVH::ElementBVH(const Mesh &mesh, double pad)
+   : sdim(mesh.SpaceDimension()), padding(pad)
+{
+   Rebuild(mesh);
+}
+
+void ElementBVH::ComputeElementBoxes(const Mesh &mesh)
+{
+   const int ne = mesh.GetNE();
+   const GridFunction *nodes = mesh.GetNodes();
+   const FiniteElementSpace *nfes = nodes ? nodes->FESpace() : NULL;
+   // a rank of a parallel mesh may own no elements
+   const bool curved =
+      nfes && (nfes->GetNURBSext() || (ne > 0 && nfes->GetOrder(0) > 1));
+   // boxes of straight-sided elements are only enlarged to account for the
+   // roundoff in the inverse element transformation
+   const double pad = curved ? padding : 1e-8;
+
+   MFEM_VERIFY(!nodes || nfes->GetVDim() == sdim, "invalid mesh nodes");
+   elem_box.SetSize(2*sdim*ne);
+   Array<int> dofs;
+   Vector vals;
+   for (int i = 0; i < ne; i++)
+   {
+      double *box = elem_box.GetData() + 2*sdim*i;
+      for (int d = 0; d < sdim; d++)
+      {
+         box[d] = std::numeric_limits<double>::infinity();
+         box[sdim+d] = -box[d];
+      }
+      if (nodes)
+      {
+         nfes->GetElementVDofs(i, dofs);
+         nodes->GetSubVector(dofs, vals);
+         const int nd = dofs.Size()/sdim;
+         for (int d = 0; d < sdim; d++)
+         {
+            for (int j = 0; j < nd; j++)
+            {
+               const double x = vals(d*nd + j);
+               box[d] = std::min(box[d], x);
+               box[sdim+d] = std::max(box[sdim+d], x);
+            }
+         }
+      }
+      else
+      {
+         mesh.GetElementVertices(i, dofs);
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            const double *x = mesh.GetVertex(dofs[j]);
+            for (int d = 0; d < sdim; d++)
+            {
+               box[d] = std::min(box[d], x[d]);
+               box[sdim+d] = std::max(box[sdim+d], x[d]);
+            }
+         }
+      }
+      double size = 0.0;
+      for (int d = 0; d < sdim; d++)
+      {
+         size = std::max(size, box[sdim+d] - box[d]);
+      }
+      for (int d = 0; d < sdim; d++)
+      {
+         box[d] -= pad*size;
+         box[sdim+d] += pad*size;
+      }
+   }
+}
+
+void ElementBVH::BuildTree()
+{
+   const int ne = elem_box.Size()/(2*sdim);
+   elems.SetSize(ne);
+   for (int i = 0; i < ne; i++) { elems[i] = i; }
+
+   node_child.SetSize(0);
+   node_begin.SetSize(0);
+   node_end.SetSize(0);
+   node_child.Append(-1);
+   node_begin.Append(0);
+   node_end.Append(ne);
+
+   // The nodes are split in the order in which they are created, so the
+   // children of a node always have larger indices than the node itself.
+   const double *eb = elem_box.GetData();
+   for (int k = 0; k < node_child.Size(); k++)
+   {
+      const int begin = node_begin[k], end = node_end[k];
+      if (end - begin <= LeafSize) { continue; }
+
+      // split along the longest dimension of the box of the element centers
+      int dir = 0;
+      double max_ext = -1.0;
+      for (int d = 0; d < sdim; d++)
+      {
+         double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+         for (int j = begin; j < end; j++)
+         {
+            const double *b = eb + 2*sdim*elems[j];
+            const double c = b[d] + b[sdim+d];
+            lo = std::min(lo, c);
+            hi = std::max(hi, c);
+         }
+         if (hi - lo > max_ext) { max_ext = hi - lo; dir = d; }
+      }
+      const int mid = (begin + end)/2;
+      const int sd = sdim;
+      std::nth_element(elems.GetData() + begin, elems.GetData() + mid,
+                       elems.GetData() + end, [eb,sd,dir](int a, int b)
+      {
+         return (eb[2*sd*a+dir] + eb[2*sd*a+sd+dir] <
+                 eb[2*sd*b+dir] + eb[2*sd*b+sd+dir]);
+      });
+
+      node_child[k] = node_child.Size();
+      node_child.Append(-1);
+      node_begin.Append(begin);
+      node_end.Append(mid);
+      node_child.Append(-1);
+      node_begin.Append(mid);
+      node_end.Append(end);
+   }
+   RefitTree();
+}
+
+void ElementBVH::RefitTree()
+{
+   const int nn = node_child.Size();
+   node_box.SetSize(2*sdim*nn);
+   for (int k = nn-1; k >= 0; k--)
+   {
+      double *box = node_box.GetData() + 2*sdim*k;
+      for (int d = 0; d < sdim; d++)
+      {
+         box[d] = std::numeric_limits<double>::infinity();
+         box[sdim+d] = -box[d];
+      }
+      const int c = node_child[k];
+      for (int j = 0; j < ((c < 0) ? node_end[k] - node_begin[k] : 2); j++)
+      {
+         const double *b = (c < 0) ?
+                           elem_box.GetData() + 2*sdim*elems[node_begin[k]+j] :
+                           node_box.GetData() + 2*sdim*(c+j);
+         for (int d = 0; d < sdim; d++)
+         {
+            box[d] = std::min(box[d], b[d]);
+            box[sdim+d] = std::max(box[sdim+d], b[sdim+d]);
+         }
+      }
+   }
+}
+
+void ElementBVH::Update(const Mesh &mesh)
+{
+   if (mesh.GetNE() != elems.Size() || mesh.SpaceDimension() != sdim)
+   {
+      Rebuild(mesh);
+      return;
+   }
+   ComputeElementBoxes(mesh);
+   RefitTree();
+}
+
+void ElementBVH::Rebuild(const Mesh &mesh)
+{
+   sdim = mesh.SpaceDimension();
+   ComputeElementBoxes(mesh);
+   BuildTree();
+}
+
+void ElementBVH::FindCandidates(const double *x,
+                                Array<int> &elements) const
+{
+   elements.SetSize(0);
+   if (elems.Size() == 0) { return; }
+
+   int stack[64];
+   int top = 0;
+   stack[top++] = 0;
+   while (top > 0)
+   {
+      const int k = stack[--top];
+      if (!Contains(node_box.GetData() + 2*sdim*k, x)) { continue; }
+      const int c = node_child[k];
+      if (c >= 0)
+      {
+         MFEM_ASSERT(top+2 <= 64, "the tree is too deep");
+         stack[top++] = c+1;
+         stack[top++] = c;
+         continue;
+      }
+      for (int j = node_begin[k]; j < node_end[k]; j++)
+      {
+         if (Contains(elem_box.GetData() + 2*sdim*elems[j], x))
+         {
+            elements.Append(elems[j]);
+         }
+      }
+   }
+
+   if (elements.Size() > 1)
+   {
+      // try the elements with the closest box centers first
+      std::vector<std::pair<double,int> > dist(elements.Size());
+      for (int i = 0; i < elements.Size(); i++)
+      {
+         const double *b = elem_box.GetData() + 2*sdim*elements[i];
+         double d2 = 0.0;
+         for (int d = 0; d < sdim; d++)
+         {
+            const double t = x[d] - 0.5*(b[d] + b[sdim+d]);
+            d2 += t*t;
+         }
+         dist[i] = std::make_pair(d2, elements[i]);
+      }
+      std::sort(dist.begin(), dist.end());
+      for (int i = 0; i < elements.Size(); i++)
+      {
+         elements[i] = dist[i].second;
+      }
+   }
+}
+
+void ElementBVH::GetCoarseBoxes(int max_boxes, Vector &boxes) const
+{
+   const int nn = node_child.Size();
+   boxes.SetSize(0);
+   if (nn == 0) { return; }
+
+   // The nodes are numbered level by level, so replacing the nodes of the cut
+   // by their children in the order of their indices refines the cut level by
+   // level.
+   Array<bool> in_cut(nn);
+   in_cut = false;
+   in_cut[0] = true;
+   int num_cut = 1;
+   for (int k = 0; k < nn && num_cut < max_boxes; k++)
+   {
+      const int c = node_child[k];
+      if (!in_cut[k] || c < 0) { continue; }
+      in_cut[k] = false;
+      in_cut[c] = in_cut[c+1] = true;
+      num_cut++;
+   }
+
+   boxes.SetSize(2*sdim*num_cut);
+   for (int k = 0, j = 0; k < nn; k++)
+   {
+      if (!in_cut[k]) { continue; }
+      for (int d = 0; d < 2*sdim; d++)
+      {
+         boxes(2*sdim*j + d) = node_box(2*sdim*k + d);
+      }
+      j++;
+   }
+}
+
+void ElementBVH::GetElementBox(int i, Vector &min, Vector &max) const
+{
+   min.SetSize(sdim);
+   max.SetSize(sdim);
+   for (int d = 0; d < sdim; d++)
+   {
+      min(d) = elem_box(2*sdim*i + d);
+      max(d) = elem_box(2*sdim*i + sdim + d);
+   }
+}
+
+long ElementBVH::MemoryUsage() const
+{
+   return ((elem_box.Size() + node_box.Size())*sizeof(double) +
+           node_child.MemoryUsage() + node_begin.MemoryUsage() +
+           node_end.MemoryUsage() + elems.MemoryUsage());
+}
+
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_ELEMENT_BVH
+#define MFEM_ELEMENT_BVH
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../linalg/vector.hpp"
+
+namespace mfem
+{
+
+class Mesh;
+
+/** @brief Bounding volume hierarchy of the axis-aligned bounding boxes of the
+    elements of a Mesh, used to find the elements which may contain a point. */
+/** The bounding box of an element is computed from its vertices or, for meshes
+    with high-order nodes, from the positions of its nodes. In the latter case
+    the box is enlarged by a fraction of its size (see SetPadding()), since a
+    curved element may extend beyond the convex hull of its nodes.
+
+    The tree is built top-down by splitting the elements at the median of their
+    box centers along the longest dimension, until at most LeafSize elements
+    remain. After the mesh nodes are moved, Update() recomputes the boxes and
+    refits the tree without changing its structure, while Rebuild() rebuilds the
+    tree from scratch, which is preferable after large deformations.
+
+    The object does not store a reference to the Mesh; all methods which use
+    the mesh take it as an argument. */
+class ElementBVH
+{
+public:
+   /// Maximal number of elements in a leaf of the tree.
+   static const int LeafSize = 4;
+
+protected:
+   int sdim;
+   double padding;
+
+   /// Bounding boxes of the elements: min and max coordinates, 2*sdim each.
+   Vector elem_box;
+
+   /** The tree nodes, with the root at index 0. Node k covers the elements
+       elems[node_begin[k] ... node_end[k]-1] and has the children node_child[k]
+       and node_child[k]+1, or node_child[k] = -1 for leaves. Children have
+       larger indices than their parents. */
+   Array<int> node_child, node_begin, node_end;
+   /// Bounding boxes of the tree nodes: min and max coordinates, 2*sdim each.
+   Vector node_box;
+   /// Permutation of the elements, such that each node covers a range of it.
+   Array<int> elems;
+
+   void ComputeElementBoxes(const Mesh &mesh);
+   void BuildTree();
+   void RefitTree();
+
+   bool Contains(const double *box, const double *x) const
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         if (x[d] < box[d] || x[d] > box[sdim+d]) { return false; }
+      }
+      return true;
+   }
+
+public:
+   /// Build the hierarchy for the elements of @a mesh.
+   ElementBVH(const Mesh &mesh, double pad = 0.1);
+
+   /** @brief Set the relative enlargement of the element boxes of meshes with
+       high-order nodes. Takes effect in the next call to Update() or
+       Rebuild(). */
+   void SetPadding(double pad) { padding = pad; }
+
+   /** @brief Recompute the element boxes and refit the tree after the nodes of
+       @a mesh have moved. If the number of elements or the space dimension
+       have changed, the tree is rebuilt. */
+   void Update(const Mesh &mesh);
+
+   /// Recompute the element boxes and rebuild the tree.
+   void Rebuild(const Mesh &mesh);
+
+   /** @brief Set @a elements to the elements whose bounding boxes contain the
+       point @a x, sorted by the distance between @a x and the box centers. */
+   void FindCandidates(const double *x, Array<int> &elements) const;
+
+   /** @brief Set @a boxes to the bounding boxes (min and max coordinates,
+       2*sdim each) of at most @a max_boxes tree nodes covering all elements,
+       taken from the levels of the tree closest to the root. */
+   void GetCoarseBoxes(int max_boxes, Vector &boxes) const;
+
+   /// Return the bounding box of element @a i.
+   void GetElementBox(int i, Vector &min, Vector &max) const;
+
+   /// Return the number of nodes in the tree.
+   int GetNumTreeNodes() const { return node_child.Size(); }
+
+   /// Return the number of elements in the hierarchy.
+   int GetNE() const { return elems.Size(); }
+
+   long MemoryUsage() const;
+};
+
+}
+
+#endif
@@ -25,6 +25,8 @@
 #include <cstring>
 #include <ctime>
 #include <functional>
+#include <algorithm>
+#include <vector>
 
 // Include the METIS header, if using version 5. If using METIS 4, the needed
 // declarations are inlined below, i.e. no header is needed.
@@ -55,6 +57,8 @@ using namespace std;
 namespace mfem
 {
 
+bool Mesh::sfc_element_ordering = false;
+
 void Mesh::GetElementJacobian(int i, DenseMatrix &J)
 {
    Geometry::Type geom = GetElementBaseGeometry(i);
@@ -971,6 +975,8 @@ void Mesh::Init()
    sequence = 0;
    Nodes = NULL;
    own_nodes = 1;
+   binary_map = NULL;
+   binary_map_size = 0;
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
@@ -980,6 +986,9 @@ void Mesh::InitTables()
 {
    el_to_edge =
       el_to_face = el_to_el = bel_to_edge = face_edge = edge_vertex = NULL;
+   elem_bvh = NULL;
+   elem_bvh_moved = false;
+   elem_bvh_checksum = 0;
 }
 
 void Mesh::SetEmpty()
@@ -1002,6 +1011,7 @@ void Mesh::DestroyTables()
 
    delete face_edge;
    delete edge_vertex;
+   delete elem_bvh;
 }
 
 void Mesh::DestroyPointers()
@@ -1028,6 +1038,9 @@ void Mesh::DestroyPointers()
    }
 
    DestroyTables();
+
+   // after the nodes, which may use the mapping
+   UnmapBinaryMesh();
 }
 
 void Mesh::Destroy()
@@ -1063,6 +1076,7 @@ void Mesh::DeleteLazyTables()
    delete el_to_el;     el_to_el = NULL;
    delete face_edge;    face_edge = NULL;
    delete edge_vertex;  edge_vertex = NULL;
+   delete elem_bvh;     elem_bvh = NULL;
    DeleteGeometricFactors();
 }
 
@@ -1200,6 +1214,31 @@ void Mesh::AddHexAsWedges(const int *vi, int attr)
    }
 }
 
+void Mesh::AddElements(const CompactElements &elems)
+{
+   elements.SetSize(std::max(elements.Size(), NumOfElements + elems.Size()));
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      Element *el = NewElement(elems.GetGeometry(i));
+      el->SetVertices(elems.GetVertices(i));
+      el->SetAttribute(elems.GetAttribute(i));
+      AddElement(el);
+   }
+}
+
+void Mesh::AddBdrElements(const CompactElements &elems)
+{
+   boundary.SetSize(std::max(boundary.Size(),
+                             NumOfBdrElements + elems.Size()));
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      Element *el = NewElement(elems.GetGeometry(i));
+      el->SetVertices(elems.GetVertices(i));
+      el->SetAttribute(elems.GetAttribute(i));
+      AddBdrElement(el);
+   }
+}
+
 void Mesh::AddBdrSegment(const int *vi, int attr)
 {
    boundary[NumOfBdrElements++] = new Segment(vi, attr);
@@ -1382,6 +1421,123 @@ void Mesh::GetGeckoElementReordering(Array<int> &ordering,
 }
 #endif
 
+// Index of the point with integer coordinates X[0..n-1], 0 <= X[i] < 2^bits,
+// on the n-dimensional Hilbert curve, using the algorithm from J. Skilling,
+// "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004). The array X is
+// overwritten.
+static unsigned long long HilbertIndex(unsigned *X, int bits, int n)
+{
+   const unsigned M = 1u << (bits-1);
+
+   // inverse undo
+   for (unsigned Q = M; Q > 1; Q >>= 1)
+   {
+      const unsigned P = Q - 1;
+      for (int i = 0; i < n; i++)
+      {
+         if (X[i] & Q) { X[0] ^= P; }
+         else
+         {
+            const unsigned t = (X[0] ^ X[i]) & P;
+            X[0] ^= t;
+            X[i] ^= t;
+         }
+      }
+   }
+
+   // Gray encode
+   for (int i = 1; i < n; i++) { X[i] ^= X[i-1]; }
+   unsigned t = 0;
+   for (unsigned Q = M; Q > 1; Q >>= 1)
+   {
+      if (X[n-1] & Q) { t ^= Q - 1; }
+   }
+   for (int i = 0; i < n; i++) { X[i] ^= t; }
+
+   // interleave the bits of the transposed index
+   unsigned long long index = 0;
+   for (int b = bits-1; b >= 0; b--)
+   {
+      for (int i = 0; i < n; i++) { index = (index << 1) | ((X[i] >> b) & 1u); }
+   }
+   return index;
+}
+
+// Index of the point with integer coordinates X[0..n-1] on the Morton curve.
+static unsigned long long MortonIndex(const unsigned *X, int bits, int n)
+{
+   unsigned long long index = 0;
+   for (int b = bits-1; b >= 0; b--)
+   {
+      for (int i = n-1; i >= 0; i--) { index = (index << 1) | ((X[i] >> b) & 1u); }
+   }
+   return index;
+}
+
+void Mesh::GetSFCElementOrdering(Array<int> &ordering, int type) const
+{
+   MFEM_VERIFY(type == HILBERT || type == MORTON, "invalid curve type");
+   const int ne = GetNE(), sdim = spaceDim;
+   // use at most 63 bits for the index
+   const int bits = (sdim == 1) ? 32 : 63/sdim;
+
+   // element centroids and their bounding box
+   Vector cent(sdim*ne);
+   double lo[3], hi[3];
+   for (int d = 0; d < sdim; d++)
+   {
+      lo[d] = std::numeric_limits<double>::infinity();
+      hi[d] = -lo[d];
+   }
+   for (int i = 0; i < ne; i++)
+   {
+      const int nv = elements[i]->GetNVertices();
+      const int *v = elements[i]->GetVertices();
+      for (int d = 0; d < sdim; d++)
+      {
+         double c = 0.0;
+         for (int j = 0; j < nv; j++) { c += vertices[v[j]](d); }
+         c /= nv;
+         cent(sdim*i + d) = c;
+         lo[d] = std::min(lo[d], c);
+         hi[d] = std::max(hi[d], c);
+      }
+   }
+
+   // quantize the centroids and sort them along the curve
+   const double scale = std::ldexp(1.0, bits) - 1.0;
+   std::vector<std::pair<unsigned long long,int> > keys(ne);
+   unsigned X[3];
+   for (int i = 0; i < ne; i++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         const double h = hi[d] - lo[d];
+         X[d] = (h > 0.0) ? unsigned((cent(sdim*i + d) - lo[d])/h*scale) : 0u;
+      }
+      // in 1D both curves reduce to the order of the coordinates
+      const unsigned long long index = (type == HILBERT && sdim > 1) ?
+                                       HilbertIndex(X, bits, sdim) :
+                                       MortonIndex(X, bits, sdim);
+      keys[i] = std::make_pair(index, i);
+   }
+   std::sort(keys.begin(), keys.end());
+
+   ordering.SetSize(ne);
+   for (int k = 0; k < ne; k++) { ordering[keys[k].second] = k; }
+}
+
+void Mesh::ApplySFCElementOrdering()
+{
+   if (NURBSext || ncmesh) { return; }
+#ifdef MFEM_USE_MPI
+   // the elements of a ParMesh are tied to its shared entities
+   if (dynamic_cast<const ParMesh*>(this)) { return; }
+#endif
+   Array<int> ordering;
+   GetSFCElementOrdering(ordering);
+   ReorderElements(ordering);
+}
 
 void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
 {
@@ -2647,6 +2803,10 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    sequence = 0;
    last_operation = Mesh::NONE;
 
+   // The copy owns its vertices and nodes, not a mapping of a binary mesh
+   binary_map = NULL;
+   binary_map_size = 0;
+
    // Duplicate the elements
    elements.SetSize(NumOfElements);
    for (int i = 0; i < NumOfElements; i++)
@@ -2698,6 +2858,11 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Copy the edge-to-vertex Table, edge_vertex
    edge_vertex = (mesh.edge_vertex) ? new Table(*mesh.edge_vertex) : NULL;
 
+   // Do NOT copy the element BVH, elem_bvh
+   elem_bvh = NULL;
+   elem_bvh_moved = false;
+   elem_bvh_checksum = 0;
+
    // Copy the attributes and bdr_attributes
    mesh.attributes.Copy(attributes);
    mesh.bdr_attributes.Copy(bdr_attributes);
@@ -2756,6 +2921,14 @@ Mesh::Mesh(const char *filename, int generate_edges, int refine,
    // Initialization as in the default constructor
    SetEmpty();
 
+   // binary mesh files are mapped to memory instead of read through a stream
+   if (MapBinaryMesh(filename))
+   {
+      Finalize(refine, fix_orientation);
+      if (sfc_element_ordering) { ApplySFCElementOrdering(); }
+      return;
+   }
+
    named_ifgzstream imesh(filename);
    if (!imesh)
    {
@@ -2990,6 +3163,11 @@ void Mesh::Loader(std::istream &input, int generate_edges,
       }
       ReadMFEMMesh(input, mfem_v11, curved);
    }
+   else if (mesh_type == "MFEM binary mesh v1.0")
+   {
+      ReadBinaryMesh(input);
+      finalize_topo = false; // FinalizeTopology() was called by the reader
+   }
    else if (mesh_type == "linemesh") // 1D mesh
    {
       ReadLineMesh(input);
@@ -4452,10 +4630,144 @@ void Mesh::GetVertexToVertexTable(DSTable &v_to_v) const
    }
 }
 
+// Number of bits needed for the numbers 0 ... n-1.
+static int NumBits(unsigned long long n)
+{
+   int bits = 0;
+   while (bits < 64 && (1ULL << bits) < n) { bits++; }
+   return bits;
+}
+
+// Number the distinct keys among the first 'num_own' entries of 'keys' in the
+// order of their first occurrence, as DSTable and STable3D number the entries
+// pushed into them, and set id[k] to the number of the key of entry k. The
+// remaining entries are queries: their id is -1 if their key does not occur
+// among the first 'num_own' entries. The entry of keys[i] is keys[i].two; on
+// input, the entries must be in increasing order among equal keys. If 'lo' is
+// not NULL, lo[k] is a second part of the key of entry k, and 'keys' must
+// already be sorted by it. Returns the
+// number of distinct keys.
+static int NumberKeys(std::vector<Pair<unsigned long long, int> > &keys,
+                      int bits, const unsigned long long *lo, int num_own,
+                      Array<int> &id)
+{
+   const int n = int(keys.size());
+   if (n == 0) { id.SetSize(0); return 0; }
+   Pair<unsigned long long, int> *k = keys.data();
+   RadixSortPairs(k, n, bits);
+
+   // mark the first occurrence of each key, which comes first in its run of
+   // equal keys since the sort is stable
+   Array<int> first(num_own+1);
+   first = 0;
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < n; i++)
+   {
+      const bool start = (i == 0 || k[i].one != k[i-1].one ||
+                          (lo && lo[k[i].two] != lo[k[i-1].two]));
+      if (start && k[i].two < num_own) { first[k[i].two+1] = 1; }
+   }
+   first.PartialSum(); // first[t] = number of first occurrences before t
+   const int num_keys = first[num_own];
+
+   id.SetSize(n);
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < n; i++)
+   {
+      int s = i;
+      while (s > 0 && k[s-1].one == k[i].one &&
+             (!lo || lo[k[s-1].two] == lo[k[i].two])) { s--; }
+      const int t = k[s].two;
+      id[k[i].two] = (t < num_own) ? first[t] : -1;
+   }
+   return num_keys;
+}
+
+int Mesh::SortElementToEdgeTable(Table &e_to_f, Array<int> &be_to_f)
+{
+   const int ne = NumOfElements, nbe = NumOfBdrElements;
+   const unsigned long long nv = NumOfVertices;
+
+   e_to_f.MakeI(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      e_to_f.AddColumnsInRow(i, elements[i]->GetNEdges());
+   }
+   e_to_f.MakeJ();
+   const int *I = e_to_f.GetI();
+   const int num_own = I[ne];
+
+   // the edges of the boundary elements are looked up after the element edges
+   if (Dim == 3)
+   {
+      if (bel_to_edge == NULL) { bel_to_edge = new Table; }
+      bel_to_edge->MakeI(nbe);
+      for (int i = 0; i < nbe; i++)
+      {
+         bel_to_edge->AddColumnsInRow(i, boundary[i]->GetNEdges());
+      }
+      bel_to_edge->MakeJ();
+   }
+   const int *bI = (Dim == 3) ? bel_to_edge->GetI() : NULL;
+   const int num_query = (Dim == 3) ? bI[nbe] : nbe;
+
+   std::vector<Pair<unsigned long long, int> > keys(num_own + num_query);
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < ne + nbe; i++)
+   {
+      const bool bdr = (i >= ne);
+      const int el = bdr ? i - ne : i;
+      const Element *elem = bdr ? boundary[el] : elements[el];
+      const int *v = elem->GetVertices();
+      const int nedges = (bdr && Dim == 2) ? 1 : elem->GetNEdges();
+      const int offset = bdr ? num_own + ((Dim == 3) ? bI[el] : el) : I[el];
+      for (int j = 0; j < nedges; j++)
+      {
+         int a = v[0], b = v[1];
+         if (!bdr || Dim == 3)
+         {
+            const int *ev = elem->GetEdgeVertices(j);
+            a = v[ev[0]];
+            b = v[ev[1]];
+         }
+         if (a > b) { std::swap(a, b); }
+         keys[offset+j] = Pair<unsigned long long, int>(a*nv + b, offset+j);
+      }
+   }
+
+   Array<int> id;
+   const int num_edges = NumberKeys(keys, 2*NumBits(nv), NULL, num_own, id);
+
+   int *J = e_to_f.GetJ();
+   for (int k = 0; k < num_own; k++) { J[k] = id[k]; }
+   if (Dim == 2)
+   {
+      be_to_f.SetSize(nbe);
+      for (int i = 0; i < nbe; i++) { be_to_f[i] = id[num_own + i]; }
+   }
+   else
+   {
+      int *bJ = bel_to_edge->GetJ();
+      for (int k = 0; k < num_query; k++) { bJ[k] = id[num_own + k]; }
+   }
+   return num_edges;
+}
+
 int Mesh::GetElementToEdgeTable(Table & e_to_f, Array<int> &be_to_f)
 {
    int i, NumberOfEdges;
 
+   if (!edge_vertex && Dim > 1)
+   {
+      // number the edges in the order of their first occurrence by sorting
+      return SortElementToEdgeTable(e_to_f, be_to_f);
+   }
    DSTable v_to_v(NumOfVertices);
    GetVertexToVertexTable(v_to_v);
 
@@ -4823,11 +5135,123 @@ STable3D *Mesh::GetFacesTable()
    return faces_tbl;
 }
 
+// Return in f[0] < f[1] < f[2] the three smallest vertices of face j of an
+// element with the given geometry and vertices, which identify the face as in
+// STable3D. For a triangle or a quadrilateral, the face is the element itself.
+static void GetFaceKey(Geometry::Type geom, const int *v, int j, int f[4])
+{
+   typedef Geometry::Constants<Geometry::TETRAHEDRON> tet_t;
+   typedef Geometry::Constants<Geometry::PRISM>       pri_t;
+   typedef Geometry::Constants<Geometry::CUBE>        hex_t;
+   const int *lfv = NULL;
+   int nfv = 0;
+   switch (geom)
+   {
+      case Geometry::TRIANGLE: nfv = 3; break;
+      case Geometry::SQUARE: nfv = 4; break;
+      case Geometry::TETRAHEDRON: lfv = tet_t::FaceVert[j]; nfv = 3; break;
+      case Geometry::PRISM: lfv = pri_t::FaceVert[j]; nfv = (j < 2) ? 3 : 4;
+         break;
+      case Geometry::CUBE: lfv = hex_t::FaceVert[j]; nfv = 4; break;
+      default: MFEM_ABORT("Unexpected type of Element.");
+   }
+   for (int m = 0; m < nfv; m++) { f[m] = lfv ? v[lfv[m]] : v[m]; }
+   std::sort(f, f + nfv);
+}
+
+int Mesh::SortElementToFaceTable()
+{
+   const int ne = NumOfElements, nbe = NumOfBdrElements;
+   const unsigned long long nv = NumOfVertices;
+
+   if (el_to_face == NULL) { el_to_face = new Table; }
+   el_to_face->MakeI(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      el_to_face->AddColumnsInRow(
+         i, Geometry::NumFaces[elements[i]->GetGeometryType()]);
+   }
+   el_to_face->MakeJ();
+   const int *I = el_to_face->GetI();
+   const int num_own = I[ne];
+
+   // if the three vertex numbers of a face do not fit in 64 bits, the key is
+   // split into the first two vertices and the third one
+   const int vbits = NumBits(nv);
+   const bool split = (3*vbits > 64);
+   std::vector<Pair<unsigned long long, int> > keys(num_own + nbe);
+   std::vector<unsigned long long> hi(split ? num_own + nbe : 0);
+   std::vector<unsigned long long> lo(split ? num_own + nbe : 0);
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < ne + nbe; i++)
+   {
+      const bool bdr = (i >= ne);
+      const int el = bdr ? i - ne : i;
+      const Element *elem = bdr ? boundary[el] : elements[el];
+      const Geometry::Type geom = elem->GetGeometryType();
+      const int *v = elem->GetVertices();
+      const int nfaces = bdr ? 1 : Geometry::NumFaces[geom];
+      for (int j = 0; j < nfaces; j++)
+      {
+         int f[4];
+         GetFaceKey(geom, v, j, f);
+         const int k = bdr ? num_own + el : I[el] + j;
+         const unsigned long long ab = f[0]*nv + f[1];
+         if (split)
+         {
+            keys[k] = Pair<unsigned long long, int>(f[2], k);
+            hi[k] = ab;
+            lo[k] = f[2];
+         }
+         else
+         {
+            keys[k] = Pair<unsigned long long, int>(ab*nv + f[2], k);
+         }
+      }
+   }
+
+   Array<int> id;
+   if (split)
+   {
+      // sort by the third vertex first, then stably by the first two
+      RadixSortPairs(keys.data(), int(keys.size()), vbits);
+      for (unsigned k = 0; k < keys.size(); k++)
+      {
+         keys[k].one = hi[keys[k].two];
+      }
+      NumOfFaces = NumberKeys(keys, 2*vbits, lo.data(), num_own, id);
+   }
+   else
+   {
+      NumOfFaces = NumberKeys(keys, 3*vbits, NULL, num_own, id);
+   }
+
+   int *J = el_to_face->GetJ();
+   for (int k = 0; k < num_own; k++) { J[k] = id[k]; }
+   be_to_face.SetSize(nbe);
+   for (int i = 0; i < nbe; i++)
+   {
+      be_to_face[i] = id[num_own + i];
+      MFEM_VERIFY(be_to_face[i] >= 0,
+                  "boundary element " << i << " is not a face of an element");
+   }
+   return NumOfFaces;
+}
+
 STable3D *Mesh::GetElementToFaceTable(int ret_ftbl)
 {
-   int i, *v;
+   int i;
+   const int *v;
    STable3D *faces_tbl;
 
+   if (!ret_ftbl)
+   {
+      // number the faces in the order of their first occurrence by sorting
+      SortElementToFaceTable();
+      return NULL;
+   }
    if (el_to_face != NULL)
    {
       delete el_to_face;
@@ -5015,6 +5439,10 @@ int *Mesh::CartesianPartitioning(int nxyz[])
 
 int *Mesh::GeneratePartitioning(int nparts, int part_method)
 {
+   if (part_method == 6 || part_method == 7)
+   {
+      return GenerateGeometricPartitioning(nparts, part_method - 6);
+   }
 #ifdef MFEM_USE_METIS
    int i, *partitioning;
 
@@ -5279,14 +5707,236 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
 
 #else
 
-   mfem_error("Mesh::GeneratePartitioning(...): "
-              "MFEM was compiled without Metis.");
-
-   return NULL;
+   return GenerateGeometricPartitioning(nparts, (part_method == 7) ? 1 : 0);
 
 #endif
 }
 
+// Assign the elements elems[0..n-1], in this order, to the parts p0 ...
+// p0+np-1, in consecutive pieces of about equal weight, each with at least one
+// element (n >= np).
+static void SplitSequence(const int *elems, int n, const double *w,
+                          int p0, int np, int *partitioning)
+{
+   double total = 0.0;
+   for (int k = 0; k < n; k++) { total += w[elems[k]]; }
+   double acc = 0.0;
+   for (int k = 0, p = 0, cnt = 0; k < n; k++)
+   {
+      const int e = elems[k];
+      // move to the next part when the current one is full, or when the
+      // remaining elements are just enough for the remaining parts
+      if (p < np-1 && cnt > 0 &&
+          (acc + 0.5*w[e] > total*(p+1)/np || n - k == np-1 - p))
+      {
+         p++;
+         cnt = 0;
+      }
+      partitioning[e] = p0 + p;
+      acc += w[e];
+      cnt++;
+   }
+}
+
+// Recursive coordinate bisection of the elements elems[0..n-1] into the parts
+// p0 ... p0+np-1 (n >= np), using the element centroids cent.
+static void RecursiveBisection(int *elems, int n, const double *cent,
+                               int sdim, const double *w, int p0, int np,
+                               int *partitioning)
+{
+   if (np == 1)
+   {
+      for (int k = 0; k < n; k++) { partitioning[elems[k]] = p0; }
+      return;
+   }
+
+   // sort along the longest dimension of the box of the centroids
+   int dir = 0;
+   double max_ext = -1.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+      for (int k = 0; k < n; k++)
+      {
+         lo = std::min(lo, cent[sdim*elems[k]+d]);
+         hi = std::max(hi, cent[sdim*elems[k]+d]);
+      }
+      if (hi - lo > max_ext) { max_ext = hi - lo; dir = d; }
+   }
+   std::sort(elems, elems + n, [cent,sdim,dir](int a, int b)
+   {
+      return cent[sdim*a+dir] < cent[sdim*b+dir];
+   });
+
+   // split the weight in proportion to the number of parts on each side
+   const int np1 = np/2;
+   double total = 0.0;
+   for (int k = 0; k < n; k++) { total += w[elems[k]]; }
+   const double target = total*np1/np;
+   double acc = 0.0;
+   int split = 0;
+   while (split < n && acc + 0.5*w[elems[split]] <= target)
+   {
+      acc += w[elems[split++]];
+   }
+   split = std::min(std::max(split, np1), n - (np - np1));
+
+   RecursiveBisection(elems, split, cent, sdim, w, p0, np1, partitioning);
+   RecursiveBisection(elems + split, n - split, cent, sdim, w, p0 + np1,
+                      np - np1, partitioning);
+}
+
+// Greedy Kernighan-Lin/Fiduccia-Mattheyses refinement of a partitioning:
+// elements on the part boundaries are moved to the neighboring part with the
+// most connections to them when this reduces the number of cut faces, keeping
+// the weight of the parts below 'max_weight', or, without changing the cut,
+// when this improves the balance. Returns the number of moved elements.
+static int RefinePartitioning(const Table &el_to_el, const double *w,
+                              double max_weight, Array<double> &part_weight,
+                              Array<int> &part_size, int *partitioning)
+{
+   const int ne = el_to_el.Size();
+   Array<int> nbr_parts, nbr_conn;
+   int moved = 0;
+   for (int e = 0; e < ne; e++)
+   {
+      const int a = partitioning[e];
+      const int *nbr = el_to_el.GetRow(e);
+      const int num_nbr = el_to_el.RowSize(e);
+
+      // count the connections of e to each neighboring part
+      int conn_a = 0;
+      nbr_parts.SetSize(0);
+      nbr_conn.SetSize(0);
+      for (int j = 0; j < num_nbr; j++)
+      {
+         const int p = partitioning[nbr[j]];
+         if (p == a) { conn_a++; continue; }
+         const int k = nbr_parts.Find(p);
+         if (k >= 0) { nbr_conn[k]++; }
+         else { nbr_parts.Append(p); nbr_conn.Append(1); }
+      }
+      if (nbr_parts.Size() == 0 || part_size[a] == 1) { continue; }
+
+      int best = -1, best_gain = 0;
+      for (int k = 0; k < nbr_parts.Size(); k++)
+      {
+         const int b = nbr_parts[k], gain = nbr_conn[k] - conn_a;
+         const double new_weight = part_weight[b] + w[e];
+         const bool ok = (gain > 0) ? (new_weight <= max_weight) :
+                         (gain == 0 && new_weight < part_weight[a]);
+         if (ok && (best < 0 || gain > best_gain))
+         {
+            best = b;
+            best_gain = gain;
+         }
+      }
+      if (best < 0) { continue; }
+
+      part_weight[a] -= w[e];
+      part_weight[best] += w[e];
+      part_size[a]--;
+      part_size[best]++;
+      partitioning[e] = best;
+      moved++;
+   }
+   return moved;
+}
+
+int *Mesh::GenerateGeometricPartitioning(int nparts, int method,
+                                         const Array<double> *elem_weights,
+                                         int refine_passes)
+{
+   MFEM_VERIFY(nparts > 0, "invalid number of parts: " << nparts);
+   MFEM_VERIFY(method == 0 || method == 1, "invalid method: " << method);
+   MFEM_VERIFY(!elem_weights || elem_weights->Size() == NumOfElements,
+               "invalid element weights");
+
+   const int ne = NumOfElements, sdim = spaceDim;
+   int *partitioning = new int[ne];
+   if (nparts == 1 || ne <= nparts)
+   {
+      for (int i = 0; i < ne; i++)
+      {
+         partitioning[i] = (nparts == 1) ? 0 : i;
+      }
+      return partitioning;
+   }
+
+   Array<double> weights;
+   if (elem_weights)
+   {
+      elem_weights->Copy(weights);
+      MFEM_VERIFY(weights.Min() > 0.0, "the element weights must be positive");
+   }
+   else
+   {
+      weights.SetSize(ne);
+      weights = 1.0;
+   }
+
+   Array<int> elems(ne);
+   if (method == 0)
+   {
+      Vector cent(sdim*ne);
+      cent = 0.0;
+      for (int i = 0; i < ne; i++)
+      {
+         elems[i] = i;
+         const int nv = elements[i]->GetNVertices();
+         const int *v = elements[i]->GetVertices();
+         for (int j = 0; j < nv; j++)
+         {
+            for (int d = 0; d < sdim; d++)
+            {
+               cent(sdim*i + d) += vertices[v[j]](d)/nv;
+            }
+         }
+      }
+      RecursiveBisection(elems.GetData(), ne, cent.GetData(), sdim,
+                         weights.GetData(), 0, nparts, partitioning);
+   }
+   else
+   {
+      Array<int> ordering;
+      GetSFCElementOrdering(ordering);
+      for (int i = 0; i < ne; i++) { elems[ordering[i]] = i; }
+      SplitSequence(elems.GetData(), ne, weights.GetData(), 0, nparts,
+                    partitioning);
+   }
+
+   if (refine_passes > 0)
+   {
+      Array<double> part_weight(nparts);
+      Array<int> part_size(nparts);
+      part_weight = 0.0;
+      part_size = 0;
+      double total = 0.0;
+      for (int i = 0; i < ne; i++)
+      {
+         part_weight[partitioning[i]] += weights[i];
+         part_size[partitioning[i]]++;
+         total += weights[i];
+      }
+      // allow 3% imbalance, or the imbalance of the initial partitioning
+      const double max_weight = std::max(1.03*total/nparts, part_weight.Max());
+
+      const Table &e2e = ElementToElementTable();
+      for (int pass = 0; pass < refine_passes; pass++)
+      {
+         if (RefinePartitioning(e2e, weights.GetData(), max_weight,
+                                part_weight, part_size, partitioning) == 0)
+         {
+            break;
+         }
+      }
+      delete el_to_el;
+      el_to_el = NULL;
+   }
+
+   return partitioning;
+}
+
 /* required: 0 <= partitioning[i] < num_part */
 void FindPartitioningComponents(Table &elem_elem,
                                 const Array<int> &partitioning,
@@ -5756,6 +6406,7 @@ void Mesh::CheckDisplacements(const Vector &displacements, double &tmax)
 
 void Mesh::MoveVertices(const Vector &displacements)
 {
+   NodesUpdated();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5776,6 +6427,7 @@ void Mesh::GetVertices(Vector &vert_coord) const
 
 void Mesh::SetVertices(const Vector &vert_coord)
 {
+   NodesUpdated();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5804,6 +6456,7 @@ void Mesh::GetNode(int i, double *coord)
 
 void Mesh::SetNode(int i, const double *coord)
 {
+   NodesUpdated();
    if (Nodes)
    {
       FiniteElementSpace *fes = Nodes->FESpace();
@@ -5824,6 +6477,7 @@ void Mesh::SetNode(int i, const double *coord)
 
 void Mesh::MoveNodes(const Vector &displacements)
 {
+   NodesUpdated();
    if (Nodes)
    {
       (*Nodes) += displacements;
@@ -5848,6 +6502,7 @@ void Mesh::GetNodes(Vector &node_coord) const
 
 void Mesh::SetNodes(const Vector &node_coord)
 {
+   NodesUpdated();
    if (Nodes)
    {
       (*Nodes) = node_coord;
@@ -5860,6 +6515,7 @@ void Mesh::SetNodes(const Vector &node_coord)
 
 void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 {
+   NodesUpdated();
    if (own_nodes) { delete Nodes; }
    Nodes = &nodes;
    spaceDim = Nodes->FESpace()->GetVDim();
@@ -5874,6 +6530,8 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
+   NodesUpdated();
+   CopyMappedNodes();
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
    // TODO:
@@ -7104,6 +7762,10 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
 
    mfem::Swap(geom_factors, other.geom_factors);
 
+   // the element BVHs are rebuilt when needed
+   delete elem_bvh;        elem_bvh = NULL;
+   delete other.elem_bvh;  other.elem_bvh = NULL;
+
    if (non_geometry)
    {
       mfem::Swap(NURBSext, other.NURBSext);
@@ -7111,6 +7773,8 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
 
       mfem::Swap(Nodes, other.Nodes);
       mfem::Swap(own_nodes, other.own_nodes);
+      mfem::Swap(binary_map, other.binary_map);
+      mfem::Swap(binary_map_size, other.binary_map_size);
    }
 }
 
@@ -7180,6 +7844,8 @@ void Mesh::UniformRefinement(int ref_algo)
          default: MFEM_ABORT("internal error");
       }
    }
+
+   if (sfc_element_ordering) { ApplySFCElementOrdering(); }
 }
 
 void Mesh::GeneralRefinement(const Array<Refinement> &refinements,
@@ -9179,6 +9845,7 @@ void Mesh::ScaleElements(double sf)
 
 void Mesh::Transform(void (*f)(const Vector&, Vector&))
 {
+   NodesUpdated();
    // TODO: support for different new spaceDim.
    if (Nodes == NULL)
    {
@@ -9204,6 +9871,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
 
 void Mesh::Transform(VectorCoefficient &deformation)
 {
+   NodesUpdated();
    MFEM_VERIFY(spaceDim == deformation.GetVDim(),
                "incompatible vector dimensions");
    if (Nodes == NULL)
@@ -9446,6 +10114,50 @@ std::ostream &operator<<(std::ostream &out, const Mesh &mesh)
    return out;
 }
 
+// FNV-1a hash of the 64-bit words of the given doubles.
+static unsigned long long HashDoubles(const double *data, int size,
+                                      unsigned long long hash)
+{
+   for (int i = 0; i < size; i++)
+   {
+      unsigned long long bits;
+      std::memcpy(&bits, data + i, sizeof(bits));
+      hash = (hash ^ bits) * 1099511628211ULL;
+   }
+   return hash;
+}
+
+unsigned long long Mesh::GetNodesChecksum() const
+{
+   unsigned long long hash = 14695981039346656037ULL;
+   if (Nodes)
+   {
+      return HashDoubles(Nodes->HostRead(), Nodes->Size(), hash);
+   }
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      hash = HashDoubles(vertices[i](), spaceDim, hash);
+   }
+   return hash;
+}
+
+const ElementBVH &Mesh::GetElementBVH()
+{
+   // the nodes may have been modified directly, e.g. through GetNodes()
+   const unsigned long long checksum = GetNodesChecksum();
+   if (!elem_bvh)
+   {
+      elem_bvh = new ElementBVH(*this);
+   }
+   else if (elem_bvh_moved || checksum != elem_bvh_checksum)
+   {
+      elem_bvh->Update(*this);
+   }
+   elem_bvh_moved = false;
+   elem_bvh_checksum = checksum;
+   return *elem_bvh;
+}
+
 int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
                      Array<IntegrationPoint>& ips, bool warn,
                      InverseElementTransformation *inv_trans)
@@ -9458,100 +10170,43 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    elem_ids = -1;
    if (!GetNE()) { return 0; }
 
+   const ElementBVH &bvh = GetElementBVH();
    double *data = point_mat.GetData();
-   InverseElementTransformation *inv_tr = inv_trans;
-   inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
-
-   // For each point in 'point_mat', find the element whose center is closest.
-   Vector min_dist(npts);
-   Array<int> e_idx(npts);
-   min_dist = std::numeric_limits<double>::max();
-   e_idx = -1;
+   int pts_found = 0;
 
-   Vector pt(spaceDim);
-   for (int i = 0; i < GetNE(); i++)
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp parallel reduction(+:pts_found) if (inv_trans == NULL)
+#endif
    {
-      GetElementTransformation(i)->Transform(
-         Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
-      for (int k = 0; k < npts; k++)
-      {
-         double dist = pt.DistanceTo(data+k*spaceDim);
-         if (dist < min_dist(k))
-         {
-            min_dist(k) = dist;
-            e_idx[k] = i;
-         }
-      }
-   }
+      InverseElementTransformation default_inv_tr;
+      InverseElementTransformation *inv_tr =
+         inv_trans ? inv_trans : &default_inv_tr;
+      IsoparametricTransformation T;
+      Array<int> candidates;
+      Vector pt;
 
-   // Checks if the points lie in the closest element
-   int pts_found = 0;
-   pt.NewDataAndSize(NULL, spaceDim);
-   for (int k = 0; k < npts; k++)
-   {
-      pt.SetData(data+k*spaceDim);
-      inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
-      int res = inv_tr->Transform(pt, ips[k]);
-      if (res == InverseElementTransformation::Inside)
-      {
-         elem_ids[k] = e_idx[k];
-         pts_found++;
-      }
-   }
-   if (pts_found != npts)
-   {
-      Array<int> vertices;
-      Table *vtoel = GetVertexToElementTable();
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp for
+#endif
       for (int k = 0; k < npts; k++)
       {
-         if (elem_ids[k] != -1) { continue; }
-         // Try all vertex-neighbors of element e_idx[k]
-         pt.SetData(data+k*spaceDim);
-         GetElementVertices(e_idx[k], vertices);
-         for (int v = 0; v < vertices.Size(); v++)
+         // Try the elements whose bounding boxes contain the point
+         pt.SetDataAndSize(data+k*spaceDim, spaceDim);
+         bvh.FindCandidates(pt.GetData(), candidates);
+         for (int i = 0; i < candidates.Size(); i++)
          {
-            int vv = vertices[v];
-            int ne = vtoel->RowSize(vv);
-            const int* els = vtoel->GetRow(vv);
-            for (int e = 0; e < ne; e++)
+            GetElementTransformation(candidates[i], &T);
+            inv_tr->SetTransformation(T);
+            int res = inv_tr->Transform(pt, ips[k]);
+            if (res == InverseElementTransformation::Inside)
             {
-               if (els[e] == e_idx[k]) { continue; }
-               inv_tr->SetTransformation(*GetElementTransformation(els[e]));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = els[e];
-                  pts_found++;
-                  goto next_point;
-               }
-            }
-         }
-         // Try neighbours for non-conforming meshes
-         if (ncmesh)
-         {
-            Array<int> neigh;
-            int le = ncmesh->leaf_elements[e_idx[k]];
-            ncmesh->FindNeighbors(le,neigh);
-            for (int e = 0; e < neigh.Size(); e++)
-            {
-               int nn = neigh[e];
-               if (ncmesh->IsGhost(ncmesh->elements[nn])) { continue; }
-               int el = ncmesh->elements[nn].index;
-               inv_tr->SetTransformation(*GetElementTransformation(el));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = el;
-                  pts_found++;
-                  goto next_point;
-               }
+               elem_ids[k] = candidates[i];
+               pts_found++;
+               break;
             }
          }
-      next_point: ;
       }
-      delete vtoel;
    }
-   if (inv_trans == NULL) { delete inv_tr; }
 
    if (warn && pts_found != npts)
    {
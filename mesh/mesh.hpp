@@ -19,6 +19,8 @@
 #include "tetrahedron.hpp"
 #include "vertex.hpp"
 #include "ncmesh.hpp"
+#include "element_bvh.hpp"
+#include "compact_elements.hpp"
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
@@ -140,6 +142,14 @@ protected:
    mutable Table *face_edge;
    mutable Table *edge_vertex;
 
+   /// Optional spatial index of the elements, see GetElementBVH().
+   ElementBVH *elem_bvh;
+   /// True if the nodes have moved since the last update of #elem_bvh.
+   bool elem_bvh_moved;
+   /** Checksum of the vertices or nodes at the last update of #elem_bvh, which
+       detects direct modifications of the nodes, see GetNodesChecksum(). */
+   unsigned long long elem_bvh_checksum;
+
    IsoparametricTransformation Transformation, Transformation2;
    IsoparametricTransformation BdrTransformation;
    IsoparametricTransformation FaceTransformation, EdgeTransformation;
@@ -154,6 +164,12 @@ protected:
    GridFunction *Nodes;
    int own_nodes;
 
+   // The memory mapping of a binary mesh file, see MapBinaryMesh(). It is the
+   // storage of the nodes and, when the layout allows, of the vertices, and is
+   // released with them by DestroyPointers().
+   void *binary_map;
+   long binary_map_size;
+
    static const int vtk_quadratic_tet[10];
    static const int vtk_quadratic_wedge[18];
    static const int vtk_quadratic_hex[27];
@@ -187,6 +203,12 @@ public:
    // (true) is set in mesh_readers.cpp.
    static bool remove_unused_vertices;
 
+   // Global parameter that can be used to reorder the elements along a Hilbert
+   // curve (see GetSFCElementOrdering()) after loading a mesh with Load() and
+   // after UniformRefinement(). This applies only to conforming, non-NURBS,
+   // serial meshes. The default value (false) is set in mesh.cpp.
+   static bool sfc_element_ordering;
+
 protected:
    Operation last_operation;
 
@@ -222,6 +244,25 @@ protected:
    void ReadCubit(const char *filename, int &curved, int &read_gf);
 #endif
 
+   // Readers for the MFEM binary mesh format, see PrintBinary(). Their
+   // implementations are in mesh_binary.cpp.
+   void ReadBinaryMesh(std::istream &input);
+   /** Read the binary data that follows the first line of the format, from
+       @a data. If @a in_place is true, the nodes and, in 3D space, the
+       vertices use @a data as their storage, so it must stay valid and
+       writable while they do. */
+   void ReadBinaryMesh(char *data, long size, bool in_place);
+   /** Read a binary mesh file by mapping it to memory, privately, so that
+       changes of the mesh are not written to the file. The mapping is kept as
+       the storage of the nodes and vertices, see #binary_map. Return false if
+       the file is not in the binary format or can not be mapped. */
+   bool MapBinaryMesh(const char *filename);
+   /// Release the mapping of MapBinaryMesh(), if any.
+   void UnmapBinaryMesh();
+   /** Make the nodes own a copy of their data, if they use the mapping of
+       MapBinaryMesh(), before they are given away. */
+   void CopyMappedNodes();
+
    /// Determine the mesh generator bitmask #meshgen, see MeshGenerator().
    /** Also, initializes #mesh_geoms. */
    void SetMeshGen();
@@ -250,6 +291,10 @@ protected:
 
    STable3D *GetFacesTable();
    STable3D *GetElementToFaceTable(int ret_ftbl = 0);
+   /** Compute #el_to_face, #be_to_face and #NumOfFaces by a radix sort of the
+       faces of all elements, numbering the faces in the order of their first
+       occurrence, as STable3D does. Used by GetElementToFaceTable(). */
+   int SortElementToFaceTable();
 
    /** Red refinement. Element with index i is refined. The default
        red refinement for now is Uniform. */
@@ -275,6 +320,11 @@ protected:
    /** Uniform Refinement. Element with index i is refined uniformly. */
    void UniformRefinement(int i, const DSTable &, int *, int *, int *);
 
+   /** Reorder the elements along a Hilbert curve, if the mesh is conforming,
+       not a NURBS mesh and not a ParMesh; used when #sfc_element_ordering is
+       set. */
+   void ApplySFCElementOrdering();
+
    /** @brief Averages the vertices with given @a indexes and saves the result
        in #vertices[result]. */
    void AverageVertices(const int *indexes, int n, int result);
@@ -367,6 +417,11 @@ protected:
        T(i, 0) gives the index of edge in element i that connects vertex 0
        to vertex 1, etc. Returns the number of the edges. */
    int GetElementToEdgeTable(Table &, Array<int> &);
+   /** Sort-based version of GetElementToEdgeTable(), used when #edge_vertex
+       is not set: the edges of all elements are sorted by their vertices with
+       a (thread-parallel) radix sort and numbered in the order of their first
+       occurrence, as DSTable does. */
+   int SortElementToEdgeTable(Table &e_to_f, Array<int> &be_to_f);
 
    /// Used in GenerateFaces()
    void AddPointFaceElement(int lf, int gf, int el);
@@ -508,6 +563,13 @@ public:
    void AddBdrQuad(const int *vi, int attr = 1);
    void AddBdrQuadAsTriangles(const int *vi, int attr = 1);
 
+   /** @brief Append Element objects created from the compact connectivity
+       @a elems, e.g. filled by a mesh reader or generator without creating
+       Element objects. */
+   void AddElements(const CompactElements &elems);
+   /// Append boundary Element objects created from @a elems.
+   void AddBdrElements(const CompactElements &elems);
+
    void GenerateBoundaryElements();
    /// Finalize the construction of a triangular Mesh.
    void FinalizeTriMesh(int generate_edges = 0, int refine = 0,
@@ -575,6 +637,22 @@ public:
                                   int period = 1, int seed = 0);
 #endif
 
+   /// Space-filling curves used by GetSFCElementOrdering().
+   enum SFCType { HILBERT, MORTON };
+
+   /** @brief Compute an ordering of the elements along a space-filling curve
+       through their centroids, for use with ReorderElements(). */
+   /** Unlike GetGeckoElementReordering(), this does not require any external
+       library. The centroids of the elements (the averages of their vertices)
+       are quantized in the bounding box of the mesh and sorted by their index
+       on the Hilbert curve (the default) or the Morton (Z-order) curve. Both
+       curves map nearby elements to nearby positions in memory; the Hilbert
+       curve has no large jumps and usually gives slightly better locality.
+       @param[out] ordering Output element ordering: ordering[i] is the new
+                            number of element i.
+       @param[in] type Space-filling curve, HILBERT or MORTON. */
+   void GetSFCElementOrdering(Array<int> &ordering, int type = HILBERT) const;
+
    /** Rebuilds the mesh with a different order of elements.  The ordering
        vector maps the old element number to the new element number.  This also
        reorders the vertices and nodes edges and faces along with the elements. */
@@ -652,6 +730,7 @@ public:
    {
       Loader(input, generate_edges);
       Finalize(refine, fix_orientation);
+      if (sfc_element_ordering) { ApplySFCElementOrdering(); }
    }
 
    /// Clear the contents of the Mesh.
@@ -698,6 +777,28 @@ public:
    const GeometricFactors* GetGeometricFactors(const IntegrationRule& ir,
                                                const int flags);
 
+   /** @brief Notify the Mesh that its vertices or nodes have been modified,
+       so that the data depending on their positions is updated. */
+   /** This is called by the Mesh methods which move the vertices or nodes,
+       e.g. MoveNodes() and Transform(). Direct modifications of the vertices or
+       of the nodal GridFunction are detected by GetElementBVH(), but calling
+       this method avoids the comparison of the checksums. The GeometricFactors
+       are not updated, see DeleteGeometricFactors(). */
+   void NodesUpdated() { elem_bvh_moved = true; }
+
+   /** @brief Return the bounding volume hierarchy of the elements, used by
+       FindPoints(). */
+   /** The hierarchy is built on the first call, and refitted (see
+       ElementBVH::Update()) after the nodes are moved, which is detected by
+       NodesUpdated() or by a change of GetNodesChecksum(). It is deleted when
+       the mesh is refined or otherwise modified, and rebuilt on the next
+       call. */
+   const ElementBVH &GetElementBVH();
+
+   /** @brief Return a checksum of the coordinates of the nodes or, if the mesh
+       has no nodes, of the vertices. */
+   unsigned long long GetNodesChecksum() const;
+
    /// Destroy all GeometricFactors stored by the Mesh.
    /** This method can be used to force recomputation of the GeometricFactors,
        for example, after the mesh nodes are modified externally. */
@@ -741,6 +842,15 @@ public:
    const Element* const *GetElementsArray() const
    { return elements.GetData(); }
 
+   /// Set @a elems to the compact connectivity of the elements of the mesh.
+   void GetCompactElements(CompactElements &elems) const
+   { elems.SetElements(elements); }
+
+   /** @brief Set @a elems to the compact connectivity of the boundary
+       elements of the mesh. */
+   void GetCompactBdrElements(CompactElements &elems) const
+   { elems.SetElements(boundary); }
+
    const Element *GetElement(int i) const { return elements[i]; }
 
    Element *GetElement(int i) { return elements[i]; }
@@ -1000,7 +1110,42 @@ public:
    virtual void ReorientTetMesh();
 
    int *CartesianPartitioning(int nxyz[]);
+
+   /** @brief Partition the elements into @a nparts parts, returning an array
+       of the part numbers of the elements, allocated with new[]. */
+   /** With METIS, @a part_method 0-2 select METIS_PartGraphRecursive(),
+       METIS_PartGraphKway() and METIS_PartGraphKway() minimizing the
+       communication volume; 3-5 do the same without sorting the neighbor
+       lists. The values 6 and 7 select GenerateGeometricPartitioning() with
+       recursive coordinate bisection and with the Hilbert curve, respectively,
+       which are also used without METIS: method 7 gives the Hilbert curve and
+       all other methods give recursive coordinate bisection. */
    int *GeneratePartitioning(int nparts, int part_method = 1);
+
+   /** @brief Partition the elements into @a nparts parts of about equal
+       weight using the element centroids, without METIS. */
+   /** @param[in] nparts Number of parts.
+       @param[in] method 0: recursive coordinate bisection, where the elements
+                         are split recursively along the longest dimension of
+                         the box of their centroids; 1: the elements are
+                         ordered along a Hilbert curve (see
+                         GetSFCElementOrdering()) and split into consecutive
+                         pieces.
+       @param[in] elem_weights Optional positive element weights (default 1).
+       @param[in] refine_passes Maximal number of passes of a greedy
+                                Kernighan-Lin/Fiduccia-Mattheyses refinement
+                                (0 to disable), which moves elements on the
+                                part boundaries to neighboring parts to reduce
+                                the number of cut faces, while keeping the
+                                weight of each part within 3% of the average
+                                (or within the imbalance of the initial
+                                partitioning).
+       @returns An array of the part numbers of the elements, allocated with
+                new[]. If there are at least @a nparts elements, no part is
+                empty. */
+   int *GenerateGeometricPartitioning(int nparts, int method = 0,
+                                      const Array<double> *elem_weights = NULL,
+                                      int refine_passes = 4);
    void CheckPartitioning(int *partitioning);
 
    void CheckDisplacements(const Vector &displacements, double &tmax);
@@ -1071,7 +1216,11 @@ public:
        refined locally using methods like GeneralRefinement() unless it is
        re-finalized using Finalize() with the parameter @a refine set to true.
        Note that calling Finalize() in this way will generally invalidate any
-       FiniteElementSpace%s and GridFunction%s defined on the mesh. */
+       FiniteElementSpace%s and GridFunction%s defined on the mesh.
+
+       If #sfc_element_ordering is set, the refined elements are reordered
+       along a Hilbert curve, which also invalidates any FiniteElementSpace%s
+       and GridFunction%s defined on the mesh. */
    void UniformRefinement(int ref_algo = 0);
 
    /** Refine selected mesh elements. Refinement type can be specified for each
@@ -1155,6 +1304,18 @@ public:
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    virtual void Print(std::ostream &out = mfem::out) const { Printer(out); }
 
+   /** @brief Print the mesh to the given stream using the MFEM binary mesh
+       format, which is much faster to load than the text formats. */
+   /** The format starts with the line "MFEM binary mesh v1.0", so it is
+       recognized by Load() and the constructors. A header with the sizes and
+       offsets of the sections follows: the vertices, the element and boundary
+       connectivity (as in CompactElements) and, for curved meshes, the nodes.
+       The sections are aligned, so that a mesh file can be mapped to memory
+       and used without copying, which is what Mesh(const char*, ...) does.
+       The data is written in the byte order of the machine. Non-conforming
+       and NURBS meshes are not supported. */
+   void PrintBinary(std::ostream &out) const;
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    void PrintVTK(std::ostream &out);
@@ -1245,6 +1406,11 @@ public:
        The DenseMatrix @a point_mat describes the given points - one point for
        each column; it should have SpaceDimension() rows.
 
+       The candidate elements for each point are the elements whose bounding
+       boxes contain the point, found with GetElementBVH(). They are tried in
+       the order of the distance from the point to their box centers, until the
+       inversion of the element transformation succeeds.
+
        The InverseElementTransformation object, @a inv_trans, is used to attempt
        the element transformation inversion. If NULL pointer is given, the
        method will use a default constructed InverseElementTransformation. Note
@@ -1252,6 +1418,9 @@ public:
        completely overwritten by deriving custom classes that override the
        Transform() method.
 
+       When MFEM is built with MFEM_USE_LEGACY_OPENMP and @a inv_trans is NULL,
+       the points are processed in parallel.
+
        If no element is found for the i-th point, elem_ids[i] is set to -1.
 
        In the ParMesh implementation, the @a point_mat is expected to be the
@@ -1262,8 +1431,9 @@ public:
 
        @returns The total number of points that were found.
 
-       @note This method is not 100 percent reliable, i.e. it is not guaranteed
-       to find a point, even if it lies inside a mesh element. */
+       @note This method is not 100 percent reliable, e.g. the inversion of a
+       highly distorted element transformation may fail, even if the point lies
+       inside the element. */
    virtual int FindPoints(DenseMatrix& point_mat, Array<int>& elem_ids,
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
@@ -0,0 +1,381 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the MFEM binary mesh format, see Mesh::PrintBinary()
+
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace mfem
+{
+
+// The first line of the format. The binary data starts at offset
+// binary_mesh_start from the beginning of the line, the remaining bytes are 0.
+static const char binary_mesh_line[] = "MFEM binary mesh v1.0\n";
+static const int binary_mesh_start = 32;
+
+// The sections are aligned to cache lines, relative to the binary data.
+static const int binary_mesh_align = 64;
+
+enum BinaryMeshSection
+{
+   BM_VERTICES,       // spaceDim doubles per vertex
+   BM_ELEM_OFFSETS,   // NumOfElements+1 ints, see CompactElements
+   BM_ELEM_VERTICES,  // ints
+   BM_ELEM_GEOMS,     // NumOfElements chars
+   BM_ELEM_ATTRIBUTES,// NumOfElements ints
+   BM_BDR_OFFSETS,    // same as above, for the boundary elements
+   BM_BDR_VERTICES,
+   BM_BDR_GEOMS,
+   BM_BDR_ATTRIBUTES,
+   BM_NODES_SPACE,    // FiniteElementSpace::Save() text of the nodes
+   BM_NODES,          // doubles, the data of the nodes
+   BM_NUM_SECTIONS
+};
+
+// The header, at the beginning of the binary data.
+struct BinaryMeshHeader
+{
+   int32_t byte_order; // binary_mesh_byte_order, as written by the writer
+   int32_t dim, space_dim, reserved;
+   int64_t num_vertices, num_elements, num_bdr_elements;
+   int64_t offset[BM_NUM_SECTIONS]; // relative to the header
+   int64_t size[BM_NUM_SECTIONS];   // in bytes
+   int64_t total_size; // of the binary data, including the header
+};
+
+static const int32_t binary_mesh_byte_order = 0x01020304;
+
+static int64_t AlignBinarySection(int64_t offset)
+{
+   return (offset + binary_mesh_align - 1) / binary_mesh_align *
+          binary_mesh_align;
+}
+
+void Mesh::PrintBinary(std::ostream &out) const
+{
+   MFEM_VERIFY(!NURBSext && !ncmesh, "the binary mesh format does not support"
+               " NURBS and non-conforming meshes, use Print()");
+
+   CompactElements elems, bdr_elems;
+   GetCompactElements(elems);
+   GetCompactBdrElements(bdr_elems);
+
+   std::vector<double> coords(NumOfVertices*(long) spaceDim);
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      for (int j = 0; j < spaceDim; j++)
+      {
+         coords[i*(long) spaceDim + j] = vertices[i](j);
+      }
+   }
+
+   std::string nodes_space;
+   if (Nodes)
+   {
+      std::ostringstream nodes_out;
+      Nodes->FESpace()->Save(nodes_out);
+      nodes_space = nodes_out.str();
+   }
+
+   const void *data[BM_NUM_SECTIONS] =
+   {
+      coords.data(),
+      elems.GetOffsets(), elems.GetVertices(0), elems.GetGeometries(),
+      elems.GetAttributes(),
+      bdr_elems.GetOffsets(), bdr_elems.GetVertices(0),
+      bdr_elems.GetGeometries(), bdr_elems.GetAttributes(),
+      nodes_space.data(), Nodes ? Nodes->HostRead() : NULL
+   };
+
+   BinaryMeshHeader header;
+   memset(&header, 0, sizeof(header));
+   header.byte_order = binary_mesh_byte_order;
+   header.dim = Dim;
+   header.space_dim = spaceDim;
+   header.num_vertices = NumOfVertices;
+   header.num_elements = elems.Size();
+   header.num_bdr_elements = bdr_elems.Size();
+
+   int64_t *size = header.size;
+   size[BM_VERTICES] = coords.size()*sizeof(double);
+   size[BM_ELEM_OFFSETS] = (elems.Size()+1)*sizeof(int);
+   size[BM_ELEM_VERTICES] = elems.GetOffsets()[elems.Size()]*sizeof(int);
+   size[BM_ELEM_GEOMS] = elems.Size();
+   size[BM_ELEM_ATTRIBUTES] = elems.Size()*sizeof(int);
+   size[BM_BDR_OFFSETS] = (bdr_elems.Size()+1)*sizeof(int);
+   size[BM_BDR_VERTICES] =
+      bdr_elems.GetOffsets()[bdr_elems.Size()]*sizeof(int);
+   size[BM_BDR_GEOMS] = bdr_elems.Size();
+   size[BM_BDR_ATTRIBUTES] = bdr_elems.Size()*sizeof(int);
+   size[BM_NODES_SPACE] = nodes_space.size();
+   size[BM_NODES] = Nodes ? Nodes->Size()*sizeof(double) : 0;
+
+   int64_t offset = sizeof(header);
+   for (int i = 0; i < BM_NUM_SECTIONS; i++)
+   {
+      header.offset[i] = offset = AlignBinarySection(offset);
+      offset += size[i];
+   }
+   header.total_size = offset;
+
+   // the first line, padded with zeros, and the header
+   char line[binary_mesh_start] = { 0 };
+   memcpy(line, binary_mesh_line, sizeof(binary_mesh_line) - 1);
+   out.write(line, binary_mesh_start);
+   out.write((const char*) &header, sizeof(header));
+
+   const char zeros[binary_mesh_align] = { 0 };
+   offset = sizeof(header);
+   for (int i = 0; i < BM_NUM_SECTIONS; i++)
+   {
+      out.write(zeros, header.offset[i] - offset);
+      out.write((const char*) data[i], size[i]);
+      offset = header.offset[i] + size[i];
+   }
+   MFEM_VERIFY(out.good(), "error writing the binary mesh");
+}
+
+void Mesh::ReadBinaryMesh(std::istream &input)
+{
+   // the first line was read by Loader()
+   input.ignore(binary_mesh_start - (sizeof(binary_mesh_line) - 1));
+
+   BinaryMeshHeader header;
+   input.read((char*) &header, sizeof(header));
+   MFEM_VERIFY(input.good(), "invalid binary mesh");
+   MFEM_VERIFY(header.byte_order == binary_mesh_byte_order,
+               "the binary mesh was written with a different byte order");
+   MFEM_VERIFY(header.total_size >= (int64_t) sizeof(header) &&
+               header.total_size <= LONG_MAX, "invalid binary mesh");
+
+   char *data = new char[header.total_size];
+   memcpy(data, &header, sizeof(header));
+   input.read(data + sizeof(header), header.total_size - sizeof(header));
+   MFEM_VERIFY(input.good(), "the binary mesh is truncated");
+
+   ReadBinaryMesh(data, header.total_size, false);
+   delete [] data;
+}
+
+// Check that the element sections of a binary mesh describe @a ne elements
+// with valid vertex indices, before the elements are created.
+static void CheckBinaryElements(const char *data, const int64_t *offset,
+                                const int64_t *size, int64_t ne, int64_t nv)
+{
+   MFEM_VERIFY(size[0] == (ne+1)*(int64_t) sizeof(int) &&
+               size[2] == ne && size[3] == ne*(int64_t) sizeof(int),
+               "invalid binary mesh element arrays");
+   const int *offsets = (const int*)(data + offset[0]);
+   MFEM_VERIFY(offsets[0] == 0 &&
+               offsets[ne]*(int64_t) sizeof(int) == size[1],
+               "invalid binary mesh element offsets");
+   const int *vertices = (const int*)(data + offset[1]);
+   const char *geoms = data + offset[2];
+   for (int64_t i = 0; i < ne; i++)
+   {
+      MFEM_VERIFY(geoms[i] >= 0 && geoms[i] < Geometry::NumGeom &&
+                  offsets[i+1] - offsets[i] ==
+                  Geometry::NumVerts[(int) geoms[i]],
+                  "invalid binary mesh element " << i);
+   }
+   for (int64_t k = 0; k < offsets[ne]; k++)
+   {
+      MFEM_VERIFY(vertices[k] >= 0 && vertices[k] < nv,
+                  "invalid binary mesh vertex index");
+   }
+}
+
+void Mesh::ReadBinaryMesh(char *data, long size, bool in_place)
+{
+   // check all sizes against the size of the data before reading the arrays
+   MFEM_VERIFY(size >= (long) sizeof(BinaryMeshHeader), "invalid binary mesh");
+   const BinaryMeshHeader &header = *(const BinaryMeshHeader*) data;
+   MFEM_VERIFY(header.byte_order == binary_mesh_byte_order,
+               "the binary mesh was written with a different byte order");
+   MFEM_VERIFY(header.total_size <= size, "the binary mesh is truncated");
+   for (int i = 0; i < BM_NUM_SECTIONS; i++)
+   {
+      MFEM_VERIFY(header.offset[i] % binary_mesh_align == 0 &&
+                  header.offset[i] >= (int64_t) sizeof(BinaryMeshHeader) &&
+                  header.size[i] >= 0 &&
+                  header.offset[i] + header.size[i] <= header.total_size,
+                  "invalid binary mesh section " << i);
+   }
+   MFEM_VERIFY(header.dim >= 1 && header.dim <= 3 &&
+               header.space_dim >= header.dim && header.space_dim <= 3,
+               "invalid binary mesh dimensions");
+   MFEM_VERIFY(header.num_vertices >= 0 && header.num_elements >= 0 &&
+               header.num_bdr_elements >= 0, "invalid binary mesh");
+   MFEM_VERIFY(header.num_elements < INT_MAX &&
+               header.num_bdr_elements < INT_MAX &&
+               header.num_vertices <= INT_MAX &&
+               header.size[BM_ELEM_VERTICES]/(int64_t) sizeof(int) <= INT_MAX &&
+               header.size[BM_BDR_VERTICES]/(int64_t) sizeof(int) <= INT_MAX,
+               "the binary mesh is too large");
+   MFEM_VERIFY(header.size[BM_VERTICES] == header.num_vertices *
+               header.space_dim * (int64_t) sizeof(double),
+               "invalid binary mesh vertices");
+   CheckBinaryElements(data, header.offset + BM_ELEM_OFFSETS,
+                       header.size + BM_ELEM_OFFSETS,
+                       header.num_elements, header.num_vertices);
+   CheckBinaryElements(data, header.offset + BM_BDR_OFFSETS,
+                       header.size + BM_BDR_OFFSETS,
+                       header.num_bdr_elements, header.num_vertices);
+
+   Dim = header.dim;
+   spaceDim = header.space_dim;
+
+   NumOfVertices = header.num_vertices;
+   double *coords = (double*)(data + header.offset[BM_VERTICES]);
+   if (in_place && spaceDim == 3 && sizeof(Vertex) == 3*sizeof(double))
+   {
+      // the vertices have the layout of Vertex, use them without copying
+      vertices.MakeRef((Vertex*) coords, NumOfVertices);
+   }
+   else
+   {
+      vertices.SetSize(NumOfVertices);
+      for (int i = 0; i < NumOfVertices; i++)
+      {
+         for (int j = 0; j < spaceDim; j++)
+         {
+            vertices[i](j) = coords[i*(long) spaceDim + j];
+         }
+      }
+   }
+
+   // The connectivity is read in place to create the elements. The Element
+   // objects store their vertices, so it can not be used as their storage.
+   CompactElements elems;
+   elems.MakeRef(header.num_elements,
+                 (int*)(data + header.offset[BM_ELEM_OFFSETS]),
+                 (int*)(data + header.offset[BM_ELEM_VERTICES]),
+                 data + header.offset[BM_ELEM_GEOMS],
+                 (int*)(data + header.offset[BM_ELEM_ATTRIBUTES]));
+   AddElements(elems);
+
+   elems.MakeRef(header.num_bdr_elements,
+                 (int*)(data + header.offset[BM_BDR_OFFSETS]),
+                 (int*)(data + header.offset[BM_BDR_VERTICES]),
+                 data + header.offset[BM_BDR_GEOMS],
+                 (int*)(data + header.offset[BM_BDR_ATTRIBUTES]));
+   AddBdrElements(elems);
+
+   // the nodes need the edges and faces of the mesh
+   FinalizeTopology();
+
+   if (header.size[BM_NODES_SPACE])
+   {
+      std::istringstream nodes_in(std::string(data +
+                                              header.offset[BM_NODES_SPACE],
+                                              header.size[BM_NODES_SPACE]));
+      FiniteElementSpace *fes = new FiniteElementSpace;
+      FiniteElementCollection *fec = fes->Load(this, nodes_in);
+      MFEM_VERIFY(fes->GetVSize()*(int64_t) sizeof(double) ==
+                  header.size[BM_NODES],
+                  "invalid binary mesh nodes");
+      double *nodes_data = (double*)(data + header.offset[BM_NODES]);
+      if (in_place)
+      {
+         // the nodes use the data as their (external) storage
+         Nodes = new GridFunction(fes, nodes_data);
+      }
+      else
+      {
+         Nodes = new GridFunction(fes);
+         memcpy(Nodes->HostWrite(), nodes_data, header.size[BM_NODES]);
+      }
+      Nodes->MakeOwner(fec); // Nodes will destroy 'fec' and 'fes'
+      own_nodes = 1;
+      spaceDim = Nodes->VectorDim();
+   }
+}
+
+bool Mesh::MapBinaryMesh(const char *filename)
+{
+#ifndef _WIN32
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) { return false; }
+
+   struct stat st;
+   char line[sizeof(binary_mesh_line) - 1];
+   if (fstat(fd, &st) != 0 ||
+       st.st_size < binary_mesh_start + (off_t) sizeof(BinaryMeshHeader) ||
+       pread(fd, line, sizeof(line), 0) != (ssize_t) sizeof(line) ||
+       memcmp(line, binary_mesh_line, sizeof(line)) != 0)
+   {
+      close(fd);
+      return false;
+   }
+
+   // A private mapping: the pages are copied when the mesh modifies its nodes
+   // or vertices, and the file is never written.
+   void *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) { return false; }
+
+   UnmapBinaryMesh();
+   binary_map = map;
+   binary_map_size = st.st_size;
+   ReadBinaryMesh((char*) map + binary_mesh_start,
+                  st.st_size - binary_mesh_start, true);
+   // keep the mapping only if it is used as storage
+   if (!Nodes && vertices.OwnsData()) { UnmapBinaryMesh(); }
+   return true;
+#else
+   MFEM_CONTRACT_VAR(filename);
+   return false;
+#endif
+}
+
+void Mesh::UnmapBinaryMesh()
+{
+   if (!binary_map) { return; }
+#ifndef _WIN32
+   munmap(binary_map, binary_map_size);
+#endif
+   binary_map = NULL;
+   binary_map_size = 0;
+}
+
+void Mesh::CopyMappedNodes()
+{
+   if (!binary_map || !Nodes) { return; }
+   const char *map = (const char*) binary_map;
+   const double *nodes_data = Nodes->HostRead();
+   if ((const char*) nodes_data >= map &&
+       (const char*) nodes_data < map + binary_map_size)
+   {
+      const int size = Nodes->Size();
+      Memory<double> copy(size);
+      memcpy((double*) copy, nodes_data, size*sizeof(double));
+      Nodes->NewMemoryAndSize(copy, size, true);
+   }
+}
+
+} // namespace mfem
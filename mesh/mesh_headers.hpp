@@ -16,6 +16,8 @@
 
 #include "vertex.hpp"
 #include "element.hpp"
+#include "element_bvh.hpp"
+#include "compact_elements.hpp"
 #include "point.hpp"
 #include "segment.hpp"
 #include "triangle.hpp"
@@ -163,7 +163,9 @@ int Rebalancer::ApplyImpl(Mesh &mesh)
    ParMesh *pmesh = dynamic_cast<ParMesh*>(&mesh);
    if (pmesh && pmesh->Nonconforming())
    {
-      pmesh->Rebalance();
+      if (elem_weights) { pmesh->Rebalance(*elem_weights); }
+      else { pmesh->Rebalance(); }
+      pmesh->pncmesh->GetRebalanceImbalance(imbalance[0], imbalance[1]);
       return CONTINUE + REBALANCED;
    }
 #endif
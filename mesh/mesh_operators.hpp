@@ -311,16 +311,35 @@ public:
 /** @brief ParMesh rebalancing operator.
 
     If the mesh is a parallel mesh, perform rebalancing; otherwise, do nothing.
+    By default, each processor gets the same number of elements. If element
+    weights are set, each processor gets the same total weight instead.
 */
 class Rebalancer : public MeshOperator
 {
 protected:
+   const Vector *elem_weights;
+   double imbalance[2];
+
    /** @brief Rebalance a parallel mesh (only non-conforming parallel meshes are
        supported).
        @return CONTINUE + REBALANCE on success, NONE otherwise. */
    virtual int ApplyImpl(Mesh &mesh);
 
 public:
+   Rebalancer() : elem_weights(NULL) { imbalance[0] = imbalance[1] = 1.0; }
+
+   /** @brief Set the weights (costs) of the local elements, or NULL to balance
+       the number of elements. */
+   /** The Vector is not copied and its size must match the number of local
+       elements of the mesh when the operator is applied, i.e., the weights
+       must be updated after the mesh changes. */
+   void SetElementWeights(const Vector *weights) { elem_weights = weights; }
+
+   /** @brief Return the load imbalance (the ratio of the maximum and the mean
+       load per processor) before and after the last rebalancing. */
+   void GetImbalance(double &before, double &after) const
+   { before = imbalance[0]; after = imbalance[1]; }
+
    /// Empty.
    virtual void Reset() { }
 };
@@ -358,7 +358,7 @@ NCMesh::Node::~Node()
                << (int) edge_refc);
 }
 
-void NCMesh::RefElement(int elem)
+void NCMesh::RefElement(int elem, bool get_faces)
 {
    Element &el = elements[elem];
    int* node = el.node;
@@ -378,7 +378,7 @@ void NCMesh::RefElement(int elem)
    }
 
    // get all faces (possibly creating them)
-   for (int i = 0; i < gi.nf; i++)
+   for (int i = 0; get_faces && i < gi.nf; i++)
    {
       const int* fv = gi.faces[i];
       faces.GetId(node[fv[0]], node[fv[1]], node[fv[2]], node[fv[3]]);
@@ -389,7 +389,8 @@ void NCMesh::RefElement(int elem)
    }
 }
 
-void NCMesh::UnrefElement(int elem, Array<int> &elemFaces)
+void NCMesh::UnrefElement(int elem, Array<int> &elemFaces,
+                          const int *face_ids)
 {
    Element &el = elements[elem];
    int* node = el.node;
@@ -399,7 +400,8 @@ void NCMesh::UnrefElement(int elem, Array<int> &elemFaces)
    for (int i = 0; i < gi.nf; i++)
    {
       const int* fv = gi.faces[i];
-      int face = faces.FindId(node[fv[0]], node[fv[1]],
+      int face = face_ids ? face_ids[i] :
+                 faces.FindId(node[fv[0]], node[fv[1]],
                               node[fv[2]], node[fv[3]]);
       MFEM_ASSERT(face >= 0, "face not found.");
       faces[face].ForgetElement(elem);
@@ -432,14 +434,14 @@ void NCMesh::UnrefElement(int elem, Array<int> &elemFaces)
    }
 }
 
-void NCMesh::RegisterFaces(int elem, int* fattr)
+void NCMesh::RegisterFaces(int elem, int* fattr, const int *face_ids)
 {
    Element &el = elements[elem];
    GeomInfo &gi = GI[(int) el.geom];
 
    for (int i = 0; i < gi.nf; i++)
    {
-      Face* face = GetFace(el, i);
+      Face* face = face_ids ? &faces[face_ids[i]] : GetFace(el, i);
       MFEM_ASSERT(face, "face not found.");
       face->RegisterElement(elem);
       if (fattr) { face->attribute = fattr[i]; }
@@ -566,7 +568,8 @@ int NCMesh::NewHexahedron(int n0, int n1, int n2, int n3,
                           int n4, int n5, int n6, int n7,
                           int attr,
                           int fattr0, int fattr1, int fattr2,
-                          int fattr3, int fattr4, int fattr5)
+                          int fattr3, int fattr4, int fattr5,
+                          int *face_ids)
 {
    // create new unrefined element, initialize nodes
    int new_id = AddElement(Element(Geometry::CUBE, attr));
@@ -580,8 +583,9 @@ int NCMesh::NewHexahedron(int n0, int n1, int n2, int n3,
    for (int i = 0; i < gi_hex.nf; i++)
    {
       const int* fv = gi_hex.faces[i];
-      f[i] = faces.Get(el.node[fv[0]], el.node[fv[1]],
-                       el.node[fv[2]], el.node[fv[3]]);
+      face_ids[i] = faces.GetId(el.node[fv[0]], el.node[fv[1]],
+                                el.node[fv[2]], el.node[fv[3]]);
+      f[i] = &faces[face_ids[i]];
    }
 
    f[0]->attribute = fattr0,  f[1]->attribute = fattr1;
@@ -593,7 +597,8 @@ int NCMesh::NewHexahedron(int n0, int n1, int n2, int n3,
 
 int NCMesh::NewQuadrilateral(int n0, int n1, int n2, int n3,
                              int attr,
-                             int eattr0, int eattr1, int eattr2, int eattr3)
+                             int eattr0, int eattr1, int eattr2, int eattr3,
+                             int *face_ids)
 {
    // create new unrefined element, initialize nodes
    int new_id = AddElement(Element(Geometry::SQUARE, attr));
@@ -606,8 +611,9 @@ int NCMesh::NewQuadrilateral(int n0, int n1, int n2, int n3,
    for (int i = 0; i < gi_quad.nf; i++)
    {
       const int* fv = gi_quad.faces[i];
-      f[i] = faces.Get(el.node[fv[0]], el.node[fv[1]],
-                       el.node[fv[2]], el.node[fv[3]]);
+      face_ids[i] = faces.GetId(el.node[fv[0]], el.node[fv[1]],
+                                el.node[fv[2]], el.node[fv[3]]);
+      f[i] = &faces[face_ids[i]];
    }
 
    f[0]->attribute = eattr0,  f[1]->attribute = eattr1;
@@ -617,7 +623,8 @@ int NCMesh::NewQuadrilateral(int n0, int n1, int n2, int n3,
 }
 
 int NCMesh::NewTriangle(int n0, int n1, int n2,
-                        int attr, int eattr0, int eattr1, int eattr2)
+                        int attr, int eattr0, int eattr1, int eattr2,
+                        int *face_ids)
 {
    // create new unrefined element, initialize nodes
    int new_id = AddElement(Element(Geometry::TRIANGLE, attr));
@@ -629,8 +636,9 @@ int NCMesh::NewTriangle(int n0, int n1, int n2,
    for (int i = 0; i < gi_tri.nf; i++)
    {
       const int* fv = gi_tri.faces[i];
-      f[i] = faces.Get(el.node[fv[0]], el.node[fv[1]],
-                       el.node[fv[2]], el.node[fv[3]]);
+      face_ids[i] = faces.GetId(el.node[fv[0]], el.node[fv[1]],
+                                el.node[fv[2]], el.node[fv[3]]);
+      f[i] = &faces[face_ids[i]];
    }
 
    f[0]->attribute = eattr0;
@@ -642,6 +650,12 @@ int NCMesh::NewTriangle(int n0, int n1, int n2,
 
 int NCMesh::GetMidEdgeNode(int vn1, int vn2)
 {
+   if (Dim < 3 || Iso)
+   {
+      // no alternate parents are possible, find or create the node at once
+      return nodes.GetId(vn1, vn2);
+   }
+
    // in 3D we must be careful about getting the mid-edge node
    int mid = FindAltParents(vn1, vn2);
    if (mid < 0) { mid = nodes.GetId(vn1, vn2); } // create if not found
@@ -817,14 +831,18 @@ void NCMesh::RefineElement(int elem, char ref_type)
    int child[8];
    for (int i = 0; i < 8; i++) { child[i] = -1; }
 
-   // get parent's face attributes
-   int fa[6];
+   // ids of the faces of the children, returned by NewHexahedron() etc.
+   int child_faces[8][6];
+
+   // get parent's faces and their attributes
+   int fa[6], parent_face_ids[6];
    GeomInfo& gi = GI[(int) el.geom];
    for (int i = 0; i < gi.nf; i++)
    {
       const int* fv = gi.faces[i];
-      Face* face = faces.Find(no[fv[0]], no[fv[1]], no[fv[2]], no[fv[3]]);
-      fa[i] = face->attribute;
+      parent_face_ids[i] = faces.FindId(no[fv[0]], no[fv[1]],
+                                        no[fv[2]], no[fv[3]]);
+      fa[i] = faces[parent_face_ids[i]].attribute;
    }
 
    // create child elements
@@ -853,11 +871,13 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], mid01, mid23, no[3],
                                   no[4], mid45, mid67, no[7], attr,
-                                  fa[0], fa[1], -1, fa[3], fa[4], fa[5]);
+                                  fa[0], fa[1], -1, fa[3], fa[4], fa[5],
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid01, no[1], no[2], mid23,
                                   mid45, no[5], no[6], mid67, attr,
-                                  fa[0], fa[1], fa[2], fa[3], -1, fa[5]);
+                                  fa[0], fa[1], fa[2], fa[3], -1, fa[5],
+                                  child_faces[1]);
 
          CheckAnisoFace(no[0], no[1], no[5], no[4], mid01, mid45);
          CheckAnisoFace(no[2], no[3], no[7], no[6], mid23, mid67);
@@ -873,11 +893,13 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], no[1], mid12, mid30,
                                   no[4], no[5], mid56, mid74, attr,
-                                  fa[0], fa[1], fa[2], -1, fa[4], fa[5]);
+                                  fa[0], fa[1], fa[2], -1, fa[4], fa[5],
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid30, mid12, no[2], no[3],
                                   mid74, mid56, no[6], no[7], attr,
-                                  fa[0], -1, fa[2], fa[3], fa[4], fa[5]);
+                                  fa[0], -1, fa[2], fa[3], fa[4], fa[5],
+                                  child_faces[1]);
 
          CheckAnisoFace(no[1], no[2], no[6], no[5], mid12, mid56);
          CheckAnisoFace(no[3], no[0], no[4], no[7], mid30, mid74);
@@ -893,11 +915,13 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], no[1], no[2], no[3],
                                   mid04, mid15, mid26, mid37, attr,
-                                  fa[0], fa[1], fa[2], fa[3], fa[4], -1);
+                                  fa[0], fa[1], fa[2], fa[3], fa[4], -1,
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid04, mid15, mid26, mid37,
                                   no[4], no[5], no[6], no[7], attr,
-                                  -1, fa[1], fa[2], fa[3], fa[4], fa[5]);
+                                  -1, fa[1], fa[2], fa[3], fa[4], fa[5],
+                                  child_faces[1]);
 
          CheckAnisoFace(no[4], no[0], no[1], no[5], mid04, mid15);
          CheckAnisoFace(no[5], no[1], no[2], no[6], mid15, mid26);
@@ -921,19 +945,23 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], mid01, midf0, mid30,
                                   no[4], mid45, midf5, mid74, attr,
-                                  fa[0], fa[1], -1, -1, fa[4], fa[5]);
+                                  fa[0], fa[1], -1, -1, fa[4], fa[5],
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid01, no[1], mid12, midf0,
                                   mid45, no[5], mid56, midf5, attr,
-                                  fa[0], fa[1], fa[2], -1, -1, fa[5]);
+                                  fa[0], fa[1], fa[2], -1, -1, fa[5],
+                                  child_faces[1]);
 
          child[2] = NewHexahedron(midf0, mid12, no[2], mid23,
                                   midf5, mid56, no[6], mid67, attr,
-                                  fa[0], -1, fa[2], fa[3], -1, fa[5]);
+                                  fa[0], -1, fa[2], fa[3], -1, fa[5],
+                                  child_faces[2]);
 
          child[3] = NewHexahedron(mid30, midf0, mid23, no[3],
                                   mid74, midf5, mid67, no[7], attr,
-                                  fa[0], -1, -1, fa[3], fa[4], fa[5]);
+                                  fa[0], -1, -1, fa[3], fa[4], fa[5],
+                                  child_faces[3]);
 
          CheckAnisoFace(no[0], no[1], no[5], no[4], mid01, mid45);
          CheckAnisoFace(no[1], no[2], no[6], no[5], mid12, mid56);
@@ -960,19 +988,23 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], mid01, mid23, no[3],
                                   mid04, midf1, midf3, mid37, attr,
-                                  fa[0], fa[1], -1, fa[3], fa[4], -1);
+                                  fa[0], fa[1], -1, fa[3], fa[4], -1,
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid01, no[1], no[2], mid23,
                                   midf1, mid15, mid26, midf3, attr,
-                                  fa[0], fa[1], fa[2], fa[3], -1, -1);
+                                  fa[0], fa[1], fa[2], fa[3], -1, -1,
+                                  child_faces[1]);
 
          child[2] = NewHexahedron(midf1, mid15, mid26, midf3,
                                   mid45, no[5], no[6], mid67, attr,
-                                  -1, fa[1], fa[2], fa[3], -1, fa[5]);
+                                  -1, fa[1], fa[2], fa[3], -1, fa[5],
+                                  child_faces[2]);
 
          child[3] = NewHexahedron(mid04, midf1, midf3, mid37,
                                   no[4], mid45, mid67, no[7], attr,
-                                  -1, fa[1], -1, fa[3], fa[4], fa[5]);
+                                  -1, fa[1], -1, fa[3], fa[4], fa[5],
+                                  child_faces[3]);
 
          CheckAnisoFace(no[3], no[2], no[1], no[0], mid23, mid01);
          CheckAnisoFace(no[2], no[6], no[5], no[1], mid26, mid15);
@@ -999,19 +1031,23 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], no[1], mid12, mid30,
                                   mid04, mid15, midf2, midf4, attr,
-                                  fa[0], fa[1], fa[2], -1, fa[4], -1);
+                                  fa[0], fa[1], fa[2], -1, fa[4], -1,
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid30, mid12, no[2], no[3],
                                   midf4, midf2, mid26, mid37, attr,
-                                  fa[0], -1, fa[2], fa[3], fa[4], -1);
+                                  fa[0], -1, fa[2], fa[3], fa[4], -1,
+                                  child_faces[1]);
 
          child[2] = NewHexahedron(mid04, mid15, midf2, midf4,
                                   no[4], no[5], mid56, mid74, attr,
-                                  -1, fa[1], fa[2], -1, fa[4], fa[5]);
+                                  -1, fa[1], fa[2], -1, fa[4], fa[5],
+                                  child_faces[2]);
 
          child[3] = NewHexahedron(midf4, midf2, mid26, mid37,
                                   mid74, mid56, no[6], no[7], attr,
-                                  -1, -1, fa[2], fa[3], fa[4], fa[5]);
+                                  -1, -1, fa[2], fa[3], fa[4], fa[5],
+                                  child_faces[3]);
 
          CheckAnisoFace(no[4], no[0], no[1], no[5], mid04, mid15);
          CheckAnisoFace(no[0], no[3], no[2], no[1], mid30, mid12);
@@ -1049,35 +1085,43 @@ void NCMesh::RefineElement(int elem, char ref_type)
 
          child[0] = NewHexahedron(no[0], mid01, midf0, mid30,
                                   mid04, midf1, midel, midf4, attr,
-                                  fa[0], fa[1], -1, -1, fa[4], -1);
+                                  fa[0], fa[1], -1, -1, fa[4], -1,
+                                  child_faces[0]);
 
          child[1] = NewHexahedron(mid01, no[1], mid12, midf0,
                                   midf1, mid15, midf2, midel, attr,
-                                  fa[0], fa[1], fa[2], -1, -1, -1);
+                                  fa[0], fa[1], fa[2], -1, -1, -1,
+                                  child_faces[1]);
 
          child[2] = NewHexahedron(midf0, mid12, no[2], mid23,
                                   midel, midf2, mid26, midf3, attr,
-                                  fa[0], -1, fa[2], fa[3], -1, -1);
+                                  fa[0], -1, fa[2], fa[3], -1, -1,
+                                  child_faces[2]);
 
          child[3] = NewHexahedron(mid30, midf0, mid23, no[3],
                                   midf4, midel, midf3, mid37, attr,
-                                  fa[0], -1, -1, fa[3], fa[4], -1);
+                                  fa[0], -1, -1, fa[3], fa[4], -1,
+                                  child_faces[3]);
 
          child[4] = NewHexahedron(mid04, midf1, midel, midf4,
                                   no[4], mid45, midf5, mid74, attr,
-                                  -1, fa[1], -1, -1, fa[4], fa[5]);
+                                  -1, fa[1], -1, -1, fa[4], fa[5],
+                                  child_faces[4]);
 
          child[5] = NewHexahedron(midf1, mid15, midf2, midel,
                                   mid45, no[5], mid56, midf5, attr,
-                                  -1, fa[1], fa[2], -1, -1, fa[5]);
+                                  -1, fa[1], fa[2], -1, -1, fa[5],
+                                  child_faces[5]);
 
          child[6] = NewHexahedron(midel, midf2, mid26, midf3,
                                   midf5, mid56, no[6], mid67, attr,
-                                  -1, -1, fa[2], fa[3], -1, fa[5]);
+                                  -1, -1, fa[2], fa[3], -1, fa[5],
+                                  child_faces[6]);
 
          child[7] = NewHexahedron(midf4, midel, midf3, mid37,
                                   mid74, midf5, mid67, no[7], attr,
-                                  -1, -1, -1, fa[3], fa[4], fa[5]);
+                                  -1, -1, -1, fa[3], fa[4], fa[5],
+                                  child_faces[7]);
 
          CheckIsoFace(no[3], no[2], no[1], no[0], mid23, mid12, mid01, mid30, midf0);
          CheckIsoFace(no[0], no[1], no[5], no[4], mid01, mid15, mid45, mid04, midf1);
@@ -1103,10 +1147,12 @@ void NCMesh::RefineElement(int elem, char ref_type)
          int mid23 = nodes.GetId(no[2], no[3]);
 
          child[0] = NewQuadrilateral(no[0], mid01, mid23, no[3],
-                                     attr, fa[0], -1, fa[2], fa[3]);
+                                     attr, fa[0], -1, fa[2], fa[3],
+                                     child_faces[0]);
 
          child[1] = NewQuadrilateral(mid01, no[1], no[2], mid23,
-                                     attr, fa[0], fa[1], fa[2], -1);
+                                     attr, fa[0], fa[1], fa[2], -1,
+                                     child_faces[1]);
       }
       else if (ref_type == 2) // Y split
       {
@@ -1114,10 +1160,12 @@ void NCMesh::RefineElement(int elem, char ref_type)
          int mid30 = nodes.GetId(no[3], no[0]);
 
          child[0] = NewQuadrilateral(no[0], no[1], mid12, mid30,
-                                     attr, fa[0], fa[1], -1, fa[3]);
+                                     attr, fa[0], fa[1], -1, fa[3],
+                                     child_faces[0]);
 
          child[1] = NewQuadrilateral(mid30, mid12, no[2], no[3],
-                                     attr, -1, fa[1], fa[2], fa[3]);
+                                     attr, -1, fa[1], fa[2], fa[3],
+                                     child_faces[1]);
       }
       else if (ref_type == 3) // iso split
       {
@@ -1129,16 +1177,20 @@ void NCMesh::RefineElement(int elem, char ref_type)
          int midel = nodes.GetId(mid01, mid23);
 
          child[0] = NewQuadrilateral(no[0], mid01, midel, mid30,
-                                     attr, fa[0], -1, -1, fa[3]);
+                                     attr, fa[0], -1, -1, fa[3],
+                                     child_faces[0]);
 
          child[1] = NewQuadrilateral(mid01, no[1], mid12, midel,
-                                     attr, fa[0], fa[1], -1, -1);
+                                     attr, fa[0], fa[1], -1, -1,
+                                     child_faces[1]);
 
          child[2] = NewQuadrilateral(midel, mid12, no[2], mid23,
-                                     attr, -1, fa[1], fa[2], -1);
+                                     attr, -1, fa[1], fa[2], -1,
+                                     child_faces[2]);
 
          child[3] = NewQuadrilateral(mid30, midel, mid23, no[3],
-                                     attr, -1, -1, fa[2], fa[3]);
+                                     attr, -1, -1, fa[2], fa[3],
+                                     child_faces[3]);
       }
       else
       {
@@ -1156,20 +1208,25 @@ void NCMesh::RefineElement(int elem, char ref_type)
       int mid12 = nodes.GetId(no[1], no[2]);
       int mid20 = nodes.GetId(no[2], no[0]);
 
-      child[0] = NewTriangle(no[0], mid01, mid20, attr, fa[0], -1, fa[2]);
-      child[1] = NewTriangle(mid01, no[1], mid12, attr, fa[0], fa[1], -1);
-      child[2] = NewTriangle(mid20, mid12, no[2], attr, -1, fa[1], fa[2]);
-      child[3] = NewTriangle(mid01, mid12, mid20, attr, -1, -1, -1);
+      child[0] = NewTriangle(no[0], mid01, mid20, attr, fa[0], -1, fa[2],
+                             child_faces[0]);
+      child[1] = NewTriangle(mid01, no[1], mid12, attr, fa[0], fa[1], -1,
+                             child_faces[1]);
+      child[2] = NewTriangle(mid20, mid12, no[2], attr, -1, fa[1], fa[2],
+                             child_faces[2]);
+      child[3] = NewTriangle(mid01, mid12, mid20, attr, -1, -1, -1,
+                             child_faces[3]);
    }
    else
    {
       MFEM_ABORT("Unsupported element geometry.");
    }
 
-   // start using the nodes of the children, create edges & faces
+   // start using the nodes of the children, create edges (the faces were
+   // created by NewHexahedron() etc.)
    for (int i = 0; i < 8 && child[i] >= 0; i++)
    {
-      RefElement(child[i]);
+      RefElement(child[i], false);
    }
 
    int buf[6];
@@ -1177,12 +1234,12 @@ void NCMesh::RefineElement(int elem, char ref_type)
    parentFaces.SetSize(0);
 
    // sign off of all nodes of the parent, clean up unused nodes, but keep faces
-   UnrefElement(elem, parentFaces);
+   UnrefElement(elem, parentFaces, parent_face_ids);
 
    // register the children in their faces
    for (int i = 0; i < 8 && child[i] >= 0; i++)
    {
-      RegisterFaces(child[i]);
+      RegisterFaces(child[i], NULL, child_faces[i]);
    }
 
    // clean up parent faces, if unused
@@ -1212,6 +1269,9 @@ void NCMesh::Refine(const Array<Refinement>& refinements)
       ref_stack.Append(Refinement(leaf_elements[ref.index], ref.ref_type));
    }
 
+   // do the isotropic refinements in (thread-parallel) batches first
+   RefineBatch(ref_stack);
+
    // keep refining as long as the stack contains something
    int nforced = 0;
    while (ref_stack.Size())
@@ -1244,6 +1304,519 @@ void NCMesh::Refine(const Array<Refinement>& refinements)
 }
 
 
+// Isotropic refinement of a geometry in local node numbers, for RefineBatch():
+// the corners of the parent are followed by the new nodes, in the order in
+// which RefineElement() creates them. The rest is set up by Initialize(), see
+// GetIsoRefinement().
+struct IsoRefinement
+{
+   int nv, nn, nch; // number of corners, of all nodes and of children
+
+   // parents of the new nodes: (a, b, -1, -1) for the node between a and b,
+   // or the four mid-edge nodes of a face, as passed to GetMidFaceNode()
+   int mid[19][4];
+   int child[8][8]; // nodes of the children
+   int fattr[8][6]; // parent face whose attribute a child face gets, or -1
+
+   int node_refc[27];     // number of children using each node
+   int ne, edges[54][3];  // unique child edges: nodes and number of children
+   int nf, faces[36][4];  // unique child faces
+   int face_attr[36];     // parent face whose attribute a face gets, or -1
+   int child_faces[8][6]; // the faces of each child, indices in 'faces'
+   int parent_edges[12];  // the mid-edge node of each edge of the parent
+
+   /** Set up the derived tables from the edges and faces of the geometry. In
+       2D, 'gnf' is 0 and degenerate faces are made from the edges, as in
+       NCMesh::GeomInfo. */
+   void Initialize(int gne, const int (*gedges)[2],
+                   int gnf, const int (*gfaces)[4]);
+};
+
+static const IsoRefinement iso_hex =
+{
+   8, 27, 8,
+   {
+      {0, 1, -1, -1}, {1, 2, -1, -1}, {2, 3, -1, -1}, {3, 0, -1, -1},
+      {4, 5, -1, -1}, {5, 6, -1, -1}, {6, 7, -1, -1}, {7, 4, -1, -1},
+      {0, 4, -1, -1}, {1, 5, -1, -1}, {2, 6, -1, -1}, {3, 7, -1, -1},
+      {10, 9, 8, 11}, {8, 17, 12, 16}, {9, 18, 13, 17}, {10, 19, 14, 18},
+      {11, 16, 15, 19}, {12, 13, 14, 15}, {21, 23, -1, -1}
+   },
+   {
+      {0, 8, 20, 11, 16, 21, 26, 24}, {8, 1, 9, 20, 21, 17, 22, 26},
+      {20, 9, 2, 10, 26, 22, 18, 23}, {11, 20, 10, 3, 24, 26, 23, 19},
+      {16, 21, 26, 24, 4, 12, 25, 15}, {21, 17, 22, 26, 12, 5, 13, 25},
+      {26, 22, 18, 23, 25, 13, 6, 14}, {24, 26, 23, 19, 15, 25, 14, 7}
+   },
+   {
+      {0, 1, -1, -1, 4, -1}, {0, 1, 2, -1, -1, -1},
+      {0, -1, 2, 3, -1, -1}, {0, -1, -1, 3, 4, -1},
+      {-1, 1, -1, -1, 4, 5}, {-1, 1, 2, -1, -1, 5},
+      {-1, -1, 2, 3, -1, 5}, {-1, -1, -1, 3, 4, 5}
+   }
+};
+
+static const IsoRefinement iso_quad =
+{
+   4, 9, 4,
+   { {0, 1, -1, -1}, {1, 2, -1, -1}, {2, 3, -1, -1}, {3, 0, -1, -1},
+     {4, 6, -1, -1} },
+   { {0, 4, 8, 7}, {4, 1, 5, 8}, {8, 5, 2, 6}, {7, 8, 6, 3} },
+   { {0, -1, -1, 3}, {0, 1, -1, -1}, {-1, 1, 2, -1}, {-1, -1, 2, 3} }
+};
+
+static const IsoRefinement iso_tri =
+{
+   3, 6, 4,
+   { {0, 1, -1, -1}, {1, 2, -1, -1}, {2, 0, -1, -1} },
+   { {0, 3, 5}, {3, 1, 4}, {5, 4, 2}, {3, 4, 5} },
+   { {0, -1, 2}, {0, 1, -1}, {-1, 1, 2}, {-1, -1, -1} }
+};
+
+static IsoRefinement MakeIsoRefinement(const IsoRefinement &pattern,
+                                       int gne, const int (*gedges)[2],
+                                       int gnf, const int (*gfaces)[4])
+{
+   IsoRefinement ir = pattern;
+   ir.Initialize(gne, gedges, gnf, gfaces);
+   return ir;
+}
+
+// Return the complete refinement table of a geometry. Each table is set up on
+// first use; the initialization of function-local statics is thread-safe, so
+// concurrent calls, also from different meshes, are fine.
+static const IsoRefinement &GetIsoRefinement(int geom)
+{
+   typedef Geometry::Constants<Geometry::CUBE> hex_t;
+   typedef Geometry::Constants<Geometry::SQUARE> quad_t;
+   typedef Geometry::Constants<Geometry::TRIANGLE> tri_t;
+   switch (geom)
+   {
+      case Geometry::CUBE:
+      {
+         static const IsoRefinement hex =
+            MakeIsoRefinement(iso_hex, hex_t::NumEdges, hex_t::Edges,
+                              hex_t::NumFaces, hex_t::FaceVert);
+         return hex;
+      }
+      case Geometry::SQUARE:
+      {
+         static const IsoRefinement quad =
+            MakeIsoRefinement(iso_quad, quad_t::NumEdges, quad_t::Edges,
+                              0, NULL);
+         return quad;
+      }
+      default:
+      {
+         static const IsoRefinement tri =
+            MakeIsoRefinement(iso_tri, tri_t::NumEdges, tri_t::Edges, 0, NULL);
+         return tri;
+      }
+   }
+}
+
+// Is 'ref_type' an isotropic refinement of the geometry?
+static bool IsIsoRefinement(int geom, int ref_type)
+{
+   switch (geom)
+   {
+      case Geometry::CUBE: return ref_type == 7;
+      case Geometry::SQUARE: return (ref_type & 3) == 3;
+      case Geometry::TRIANGLE: return ref_type != 0;
+      default: return false;
+   }
+}
+
+void IsoRefinement::Initialize(int gne, const int (*gedges)[2],
+                               int gnf, const int (*gfaces)[4])
+{
+   int dfaces[4][4];
+   if (!gnf)
+   {
+      for (int i = 0; i < gne; i++)
+      {
+         dfaces[i][0] = dfaces[i][1] = gedges[i][0];
+         dfaces[i][2] = dfaces[i][3] = gedges[i][1];
+      }
+      gnf = gne;
+      gfaces = dfaces;
+   }
+
+   for (int k = 0; k < nn; k++) { node_refc[k] = 0; }
+   ne = nf = 0;
+
+   for (int c = 0; c < nch; c++)
+   {
+      const int *cn = child[c];
+      for (int i = 0; i < nv; i++) { node_refc[cn[i]]++; }
+
+      for (int i = 0; i < gne; i++)
+      {
+         int a = cn[gedges[i][0]], b = cn[gedges[i][1]];
+         if (a > b) { std::swap(a, b); }
+         int j = 0;
+         while (j < ne && (edges[j][0] != a || edges[j][1] != b)) { j++; }
+         if (j == ne)
+         {
+            edges[j][0] = a, edges[j][1] = b, edges[j][2] = 0;
+            ne++;
+         }
+         edges[j][2]++;
+      }
+
+      for (int i = 0; i < gnf; i++)
+      {
+         int f[4];
+         for (int k = 0; k < 4; k++) { f[k] = cn[gfaces[i][k]]; }
+         internal::sort4(f[0], f[1], f[2], f[3]);
+         int j = 0;
+         while (j < nf && (faces[j][0] != f[0] || faces[j][1] != f[1] ||
+                           faces[j][2] != f[2] || faces[j][3] != f[3])) { j++; }
+         if (j == nf)
+         {
+            for (int k = 0; k < 4; k++) { faces[j][k] = f[k]; }
+            nf++;
+         }
+         face_attr[j] = fattr[c][i];
+         child_faces[c][i] = j;
+      }
+   }
+
+   for (int i = 0; i < gne; i++)
+   {
+      int k = nv;
+      for (const int *m = mid[0]; ; m = mid[++k - nv])
+      {
+         if (m[2] < 0 && ((m[0] == gedges[i][0] && m[1] == gedges[i][1]) ||
+                          (m[0] == gedges[i][1] && m[1] == gedges[i][0])))
+         {
+            break;
+         }
+      }
+      parent_edges[i] = k;
+   }
+}
+
+// Find the item with the given parents, return -1 if it does not exist or if
+// some parent is -1 (a node that does not exist yet).
+template <typename T>
+static inline int FindExisting(const HashTable<T> &table, int p1, int p2)
+{
+   return (p1 >= 0 && p2 >= 0) ? table.FindId(p1, p2) : -1;
+}
+
+template <typename T>
+static inline int FindExisting(const HashTable<T> &table,
+                               int p1, int p2, int p3, int p4)
+{
+   return (p1 >= 0 && p2 >= 0 && p3 >= 0 && p4 >= 0)
+          ? table.FindId(p1, p2, p3, p4) : -1;
+}
+
+/// The refinement of one element by RefineBatch(), see StageRefinement().
+struct NCMesh::StagedRefinement
+{
+   int elem;                // the element being refined
+   const IsoRefinement *ir; // its refinement pattern
+   int node[27];            // ids of the nodes, -1 for the new ones
+   int edge[54];            // ids of the nodes of the child edges, or -1
+   int face[36];            // ids of the child faces, or -1
+   int parent_face[6];      // ids of the faces of the element
+   int child[8];            // the children, set by MergeRefinement()
+};
+
+void NCMesh::StageRefinement(StagedRefinement &sr) const
+{
+   // only look up the nodes and faces here, this runs in parallel
+   const Element &el = elements[sr.elem];
+   const GeomInfo &gi = GI[(int) el.geom];
+   const IsoRefinement &ir = GetIsoRefinement(el.geom);
+   int *node = sr.node;
+   sr.ir = &ir;
+
+   for (int i = 0; i < ir.nv; i++) { node[i] = el.node[i]; }
+   for (int k = ir.nv; k < ir.nn; k++)
+   {
+      const int *m = ir.mid[k - ir.nv];
+      if (m[2] < 0)
+      {
+         node[k] = FindExisting(nodes, node[m[0]], node[m[1]]);
+      }
+      else // see GetMidFaceNode()
+      {
+         node[k] = FindExisting(nodes, node[m[0]], node[m[2]]);
+         if (node[k] < 0)
+         {
+            node[k] = FindExisting(nodes, node[m[1]], node[m[3]]);
+         }
+      }
+   }
+
+   for (int j = 0; j < ir.ne; j++)
+   {
+      const int *e = ir.edges[j];
+      sr.edge[j] = FindExisting(nodes, node[e[0]], node[e[1]]);
+   }
+   for (int j = 0; j < ir.nf; j++)
+   {
+      const int *f = ir.faces[j];
+      sr.face[j] = FindExisting(faces, node[f[0]], node[f[1]],
+                                node[f[2]], node[f[3]]);
+   }
+
+   for (int i = 0; i < gi.nf; i++)
+   {
+      const int *fv = gi.faces[i];
+      sr.parent_face[i] = faces.FindId(node[fv[0]], node[fv[1]],
+                                       node[fv[2]], node[fv[3]]);
+      MFEM_ASSERT(sr.parent_face[i] >= 0, "face not found.");
+   }
+   for (int i = 0; i < 8; i++) { sr.child[i] = -1; }
+}
+
+void NCMesh::MergeRefinement(StagedRefinement &sr)
+{
+   // create the new nodes, faces and elements; no other element of the color
+   // creates the same ones
+   const IsoRefinement &ir = *sr.ir;
+   int *node = sr.node;
+
+   for (int k = ir.nv; k < ir.nn; k++)
+   {
+      if (node[k] >= 0) { continue; }
+      const int *m = ir.mid[k - ir.nv];
+      // a new mid-face node gets the second pair of parents, see
+      // GetMidFaceNode()
+      const int p1 = node[(m[2] < 0) ? m[0] : m[1]];
+      const int p2 = node[(m[2] < 0) ? m[1] : m[3]];
+      MFEM_ASSERT(nodes.FindId(p1, p2) < 0, "node created twice.");
+      node[k] = nodes.GetId(p1, p2);
+   }
+
+   Geometry::Type geom = Geometry::Type(elements[sr.elem].geom);
+   int attr = elements[sr.elem].attribute;
+   for (int c = 0; c < ir.nch; c++)
+   {
+      sr.child[c] = AddElement(Element(geom, attr));
+      Element &ch = elements[sr.child[c]];
+      for (int i = 0; i < ir.nv; i++) { ch.node[i] = node[ir.child[c][i]]; }
+   }
+
+   for (int j = 0; j < ir.ne; j++)
+   {
+      if (sr.edge[j] >= 0) { continue; }
+      const int *e = ir.edges[j];
+      MFEM_ASSERT(nodes.FindId(node[e[0]], node[e[1]]) < 0,
+                  "edge created twice.");
+      sr.edge[j] = nodes.GetId(node[e[0]], node[e[1]]);
+   }
+   for (int j = 0; j < ir.nf; j++)
+   {
+      if (sr.face[j] >= 0) { continue; }
+      const int *f = ir.faces[j];
+      MFEM_ASSERT(faces.FindId(node[f[0]], node[f[1]],
+                               node[f[2]], node[f[3]]) < 0,
+                  "face created twice.");
+      sr.face[j] = faces.GetId(node[f[0]], node[f[1]], node[f[2]], node[f[3]]);
+   }
+}
+
+void NCMesh::FinishRefinement(const StagedRefinement &sr)
+{
+   // update the nodes, faces and elements of one element, this runs in
+   // parallel: the elements of a color use disjoint nodes and faces
+   const IsoRefinement &ir = *sr.ir;
+   Element &el = elements[sr.elem];
+   const GeomInfo &gi = GI[(int) el.geom];
+   const int *node = sr.node;
+
+   // the children reference their vertices and edges, the parent releases
+   // its own, which the children keep using (see RefElement, UnrefElement)
+   for (int k = 0; k < ir.nn; k++)
+   {
+      nodes[node[k]].vert_refc += ir.node_refc[k] - (k < ir.nv ? 1 : 0);
+   }
+   for (int j = 0; j < ir.ne; j++)
+   {
+      nodes[sr.edge[j]].edge_refc += ir.edges[j][2];
+   }
+   for (int i = 0; i < gi.ne; i++)
+   {
+      nodes[node[ir.parent_edges[i]]].edge_refc--;
+   }
+
+   // replace the parent by the children in the faces (see NewHexahedron,
+   // RegisterFaces)
+   for (int i = 0; i < gi.nf; i++)
+   {
+      faces[sr.parent_face[i]].ForgetElement(sr.elem);
+   }
+   for (int j = 0; j < ir.nf; j++)
+   {
+      const int fa = ir.face_attr[j];
+      faces[sr.face[j]].attribute =
+         (fa >= 0) ? faces[sr.parent_face[fa]].attribute : -1;
+   }
+   for (int c = 0; c < ir.nch; c++)
+   {
+      for (int i = 0; i < gi.nf; i++)
+      {
+         faces[sr.face[ir.child_faces[c][i]]].RegisterElement(sr.child[c]);
+      }
+
+      Element &ch = elements[sr.child[c]];
+      ch.rank = el.rank;
+      ch.parent = sr.elem;
+   }
+
+   el.ref_type = (el.geom == Geometry::CUBE) ? 7 : 3;
+   el.flag = 0;
+   memcpy(el.child, sr.child, sizeof(el.child));
+}
+
+void NCMesh::RefineBatch(Array<Refinement> &refs)
+{
+   // the coloring uses one int per node id, so only large batches are done;
+   // elements that would need more colors are refined serially
+   const int min_batch = 1024, max_colors = 30, chunk = 4096;
+
+   if (Dim >= 3 && !Iso) { return; }
+
+   // the isotropic refinements of unrefined elements, each element once
+   Array<int> batch;
+   for (int i = 0; i < refs.Size(); i++)
+   {
+      Element &el = elements[refs[i].index];
+      if (!el.ref_type && !el.flag &&
+          IsIsoRefinement(el.geom, refs[i].ref_type))
+      {
+         el.flag = 1;
+         batch.Append(refs[i].index);
+      }
+   }
+   if (batch.Size() < min_batch || nodes.NumIds() > 64*batch.Size())
+   {
+      for (int i = 0; i < batch.Size(); i++) { elements[batch[i]].flag = 0; }
+      return;
+   }
+
+   int n = 0;
+   for (int i = 0; i < refs.Size(); i++)
+   {
+      const Element &el = elements[refs[i].index];
+      if (!el.flag || !IsIsoRefinement(el.geom, refs[i].ref_type))
+      {
+         refs[n++] = refs[i];
+      }
+   }
+   refs.SetSize(n);
+
+   // Color the elements greedily: an element gets the smallest color not used
+   // by the elements sharing an existing node with it. This is enough: two
+   // elements that touch share a node that exists and that both use (a corner
+   // of the smaller one), and they create the same new node or face only if
+   // they share its existing parents.
+   Array<StagedRefinement> staged(std::min(chunk, batch.Size()));
+   Array<int> node_colors(nodes.NumIds()), color(batch.Size()), used_nodes;
+   node_colors = 0;
+   int num_colors = 0;
+   for (int begin = 0; begin < batch.Size(); begin += chunk)
+   {
+      const int size = std::min(chunk, batch.Size() - begin);
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < size; i++)
+      {
+         staged[i].elem = batch[begin + i];
+         StageRefinement(staged[i]);
+      }
+
+      for (int i = 0; i < size; i++)
+      {
+         const StagedRefinement &sr = staged[i];
+         used_nodes.SetSize(0);
+         for (int k = 0; k < sr.ir->nn; k++)
+         {
+            if (sr.node[k] >= 0) { used_nodes.Append(sr.node[k]); }
+         }
+         for (int j = 0; j < sr.ir->ne; j++)
+         {
+            if (sr.edge[j] >= 0) { used_nodes.Append(sr.edge[j]); }
+         }
+
+         int used_colors = 0;
+         for (int j = 0; j < used_nodes.Size(); j++)
+         {
+            used_colors |= node_colors[used_nodes[j]];
+         }
+         int c = 0;
+         while (c < max_colors && (used_colors & (1 << c))) { c++; }
+         color[begin + i] = c;
+         if (c == max_colors) { continue; }
+
+         num_colors = std::max(num_colors, c+1);
+         for (int j = 0; j < used_nodes.Size(); j++)
+         {
+            node_colors[used_nodes[j]] |= (1 << c);
+         }
+      }
+   }
+
+   // order the elements by color, keeping their order within a color
+   Array<int> color_I(max_colors+2), order(batch.Size());
+   color_I = 0;
+   for (int i = 0; i < batch.Size(); i++) { color_I[color[i]+1]++; }
+   color_I.PartialSum();
+   for (int i = 0; i < batch.Size(); i++)
+   {
+      order[color_I[color[i]]++] = batch[i];
+   }
+   for (int c = max_colors+1; c > 0; c--) { color_I[c] = color_I[c-1]; }
+   color_I[0] = 0;
+
+   // refine the colors one after the other, in chunks: look up the existing
+   // nodes and faces in parallel, add the new ones to the hash tables in a
+   // fixed order, then update the elements, faces and nodes in parallel
+   for (int c = 0; c < num_colors; c++)
+   {
+      for (int begin = color_I[c]; begin < color_I[c+1]; begin += chunk)
+      {
+         const int size = std::min(chunk, color_I[c+1] - begin);
+#ifdef MFEM_USE_LEGACY_OPENMP
+         #pragma omp parallel for
+#endif
+         for (int i = 0; i < size; i++)
+         {
+            staged[i].elem = order[begin + i];
+            StageRefinement(staged[i]);
+         }
+
+         for (int i = 0; i < size; i++) { MergeRefinement(staged[i]); }
+
+#ifdef MFEM_USE_LEGACY_OPENMP
+         #pragma omp parallel for
+#endif
+         for (int i = 0; i < size; i++) { FinishRefinement(staged[i]); }
+
+         // clean up the parent faces, if unused
+         for (int i = 0; i < size; i++)
+         {
+            const int nf = GI[(int) elements[staged[i].elem].geom].nf;
+            Array<int> parent_faces(staged[i].parent_face, nf);
+            DeleteUnusedFaces(parent_faces);
+         }
+      }
+   }
+
+   for (int i = color_I[max_colors]; i < color_I[max_colors+1]; i++)
+   {
+      elements[order[i]].flag = 0;
+      RefineElement(order[i], 7);
+   }
+}
+
+
 //// Derefinement //////////////////////////////////////////////////////////////
 
 static int quad_deref_table[3][4 + 4] =
@@ -2325,6 +2898,22 @@ void NCMesh::NCList::Clear(bool hard)
    inv_index.DeleteAll();
 }
 
+void NCMesh::NCList::RenumberElements(const Array<int> &elem_map)
+{
+   for (unsigned i = 0; i < conforming.size(); i++)
+   {
+      conforming[i].element = elem_map[conforming[i].element];
+   }
+   for (unsigned i = 0; i < masters.size(); i++)
+   {
+      masters[i].element = elem_map[masters[i].element];
+   }
+   for (unsigned i = 0; i < slaves.size(); i++)
+   {
+      slaves[i].element = elem_map[slaves[i].element];
+   }
+}
+
 long NCMesh::NCList::TotalSize() const
 {
    return conforming.size() + masters.size() + slaves.size();
@@ -4029,6 +4618,100 @@ void NCMesh::LoadCoarseElements(std::istream &input)
    Update();
 }
 
+void NCMesh::Compact()
+{
+   // new ids: the live ids are numbered in their current order
+   Array<int> node_map, face_map, elem_map(elements.Size());
+   nodes.GetCompactIds(node_map);
+   faces.GetCompactIds(face_map);
+   for (int i = 0, new_id = 0; i < elem_map.Size(); i++)
+   {
+      elem_map[i] = (elements[i].parent != -2) ? new_id++ : -1;
+   }
+
+   // nodes are parented by nodes, faces by their vertex nodes
+   nodes.Compact(node_map);
+   faces.Compact(node_map);
+
+   for (face_iterator face = faces.begin(); face != faces.end(); ++face)
+   {
+      for (int i = 0; i < 2; i++)
+      {
+         if (face->elem[i] >= 0) { face->elem[i] = elem_map[face->elem[i]]; }
+      }
+   }
+
+   // copy the live elements to new storage, the roots stay at the beginning
+   BlockArray<Element> tmp_elements;
+   elements.Swap(tmp_elements);
+   free_element_ids.DeleteAll();
+
+   for (elem_iterator it = tmp_elements.begin(); it != tmp_elements.end(); ++it)
+   {
+      if (it->parent == -2) { continue; }
+
+      Element &el = elements[elements.Append(*it)];
+      if (el.parent >= 0) { el.parent = elem_map[el.parent]; }
+      if (el.ref_type)
+      {
+         for (int i = 0; i < 8 && el.child[i] >= 0; i++)
+         {
+            el.child[i] = elem_map[el.child[i]];
+         }
+      }
+      else
+      {
+         for (int i = 0; i < GI[(int) el.geom].nv; i++)
+         {
+            el.node[i] = node_map[el.node[i]];
+         }
+      }
+   }
+
+   RenumberIds(node_map, face_map, elem_map);
+}
+
+void NCMesh::RenumberIds(const Array<int> &node_map,
+                         const Array<int> &face_map,
+                         const Array<int> &elem_map)
+{
+   for (int i = 0; i < leaf_elements.Size(); i++)
+   {
+      leaf_elements[i] = elem_map[leaf_elements[i]];
+   }
+   for (int i = 0; i < coarse_elements.Size(); i++)
+   {
+      coarse_elements[i] = elem_map[coarse_elements[i]];
+   }
+   for (int i = 0; i < vertex_nodeId.Size(); i++)
+   {
+      vertex_nodeId[i] = node_map[vertex_nodeId[i]];
+   }
+   for (int i = 0; i < boundary_faces.Size(); i++)
+   {
+      boundary_faces[i] = face_map[boundary_faces[i]];
+   }
+
+   // positions of the top-level vertices are indexed by their node ids
+   int num_top_level = 0;
+   const int num_pos = std::min(top_vertex_pos.Size()/3, node_map.Size());
+   for (int i = 0; i < num_pos; i++)
+   {
+      const int id = node_map[i];
+      if (id < 0) { continue; }
+      for (int j = 0; j < 3; j++)
+      {
+         top_vertex_pos[3*id + j] = top_vertex_pos[3*i + j];
+      }
+      num_top_level = id + 1;
+   }
+   top_vertex_pos.SetSize(3*num_top_level);
+
+   face_list.RenumberElements(elem_map);
+   edge_list.RenumberElements(elem_map);
+   vertex_list.RenumberElements(elem_map);
+}
+
 void NCMesh::Trim()
 {
    vertex_list.Clear(true);
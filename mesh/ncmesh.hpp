@@ -119,7 +119,12 @@ public:
    /** Perform the given batch of refinements. Please note that in the presence
        of anisotropic splits additional refinements may be necessary to keep
        the mesh consistent. However, the function always performs at least the
-       requested refinements. */
+       requested refinements. Large batches of isotropic refinements are done
+       by color, in parallel when MFEM is built with MFEM_USE_LEGACY_OPENMP,
+       see RefineBatch(). The resulting mesh is the same as when the elements
+       are refined one at a time, but the new vertices, edges and faces are
+       numbered differently. The numbering is the same in all builds and for
+       any number of threads. */
    virtual void Refine(const Array<Refinement> &refinements);
 
    /** Check the mesh and potentially refine some elements so that the maximum
@@ -197,6 +202,9 @@ public:
       long MemoryUsage() const;
 
       const MeshId& LookUp(int index, int *type = NULL) const;
+
+      /// Replace the element ids in the list by @a elem_map[id].
+      void RenumberElements(const Array<int> &elem_map);
    private:
       mutable Array<int> inv_index;
    };
@@ -332,6 +340,17 @@ public:
    /// Save memory by releasing all non-essential and cached data.
    virtual void Trim();
 
+   /** @brief Renumber the nodes, faces and elements so that their ids are
+       contiguous and release the storage of the unused ids. */
+   /** Derefinement leaves unused ids in the containers of nodes, faces and
+       elements, to be reused by later refinements. Calling this function
+       (e.g., after Derefine() in each adaptive cycle) keeps the memory of the
+       NCMesh proportional to the current size of the refinement hierarchy.
+       The relative order of the ids is kept, so the numbering of the Mesh
+       vertices, edges, faces and elements does not change. See PrintStats()
+       and PrintMemoryDetail() for the memory used by the containers. */
+   void Compact();
+
    /// Return total number of bytes allocated.
    long MemoryUsage() const;
 
@@ -498,9 +517,32 @@ protected: // implementation
 
    Table derefinements; ///< possible derefinements, see GetDerefinementTable
 
+   /** Renumber the ids of nodes, faces and elements stored in the secondary
+       data, as given by the maps, after they were compacted by Compact(). */
+   virtual void RenumberIds(const Array<int> &node_map,
+                            const Array<int> &face_map,
+                            const Array<int> &elem_map);
+
    void RefineElement(int elem, char ref_type);
    void DerefineElement(int elem);
 
+   /** Perform the isotropic refinements in @a refs of elements that are not
+       refined yet, and remove them from @a refs. The elements are colored so
+       that no two elements of a color use the same node or face, and each
+       color is refined in batches: the lookups of the nodes and faces and the
+       reference counting are done in parallel with MFEM_USE_LEGACY_OPENMP,
+       the new nodes, faces and elements are merged into the tables serially,
+       in the order of the colors. Without OpenMP, the same steps run on one
+       thread, so the result depends neither on the build nor on the number
+       of threads. Nothing is done for small batches or if the mesh has 3D
+       anisotropic refinements. */
+   void RefineBatch(Array<Refinement> &refs);
+
+   struct StagedRefinement; // defined in ncmesh.cpp
+   void StageRefinement(StagedRefinement &sr) const;
+   void MergeRefinement(StagedRefinement &sr);
+   void FinishRefinement(const StagedRefinement &sr);
+
    int AddElement(const Element &el)
    {
       if (free_element_ids.Size())
@@ -518,18 +560,23 @@ protected: // implementation
       elements[id].parent = -2; // mark the element as free
    }
 
+   /** Create a new leaf element and its faces. The ids of the faces are
+       returned in @a face_ids, for RegisterFaces(). */
    int NewHexahedron(int n0, int n1, int n2, int n3,
                      int n4, int n5, int n6, int n7,
                      int attr,
                      int fattr0, int fattr1, int fattr2,
-                     int fattr3, int fattr4, int fattr5);
+                     int fattr3, int fattr4, int fattr5,
+                     int *face_ids);
 
    int NewQuadrilateral(int n0, int n1, int n2, int n3,
                         int attr,
-                        int eattr0, int eattr1, int eattr2, int eattr3);
+                        int eattr0, int eattr1, int eattr2, int eattr3,
+                        int *face_ids);
 
    int NewTriangle(int n0, int n1, int n2,
-                   int attr, int eattr0, int eattr1, int eattr2);
+                   int attr, int eattr0, int eattr1, int eattr2,
+                   int *face_ids);
 
    mfem::Element* NewMeshElement(int geom) const;
 
@@ -547,11 +594,18 @@ protected: // implementation
    void CheckIsoFace(int vn1, int vn2, int vn3, int vn4,
                      int en1, int en2, int en3, int en4, int midf);
 
-   void RefElement(int elem);
-   void UnrefElement(int elem, Array<int> &elemFaces);
+   /// Sign in to the nodes, edges and (if @a get_faces) faces of an element.
+   void RefElement(int elem, bool get_faces = true);
+   /** Sign off of the nodes, edges and faces of an element. The faces are
+       looked up unless their ids are given in @a face_ids. */
+   void UnrefElement(int elem, Array<int> &elemFaces,
+                     const int *face_ids = NULL);
 
    Face* GetFace(Element &elem, int face_no);
-   void RegisterFaces(int elem, int *fattr = NULL);
+   /** Register the element in its faces, which are looked up unless their
+       ids are given in @a face_ids. */
+   void RegisterFaces(int elem, int *fattr = NULL,
+                      const int *face_ids = NULL);
    void DeleteUnusedFaces(const Array<int> &elemFaces);
 
    int FindAltParents(int node1, int node2);
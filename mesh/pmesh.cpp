@@ -3083,6 +3083,16 @@ bool ParMesh::NonconformingDerefinement(Array<double> &elem_error,
 }
 
 void ParMesh::Rebalance()
+{
+   RebalanceImpl(NULL);
+}
+
+void ParMesh::Rebalance(const Vector &elem_weights)
+{
+   RebalanceImpl(&elem_weights);
+}
+
+void ParMesh::RebalanceImpl(const Vector *elem_weights)
 {
    if (Conforming())
    {
@@ -3109,7 +3119,16 @@ void ParMesh::Rebalance()
 
    DeleteFaceNbrData();
 
-   pncmesh->Rebalance();
+   if (elem_weights)
+   {
+      MFEM_VERIFY(elem_weights->Size() == GetNE(), "expected one weight per"
+                  " local element");
+      pncmesh->Rebalance(*elem_weights);
+   }
+   else
+   {
+      pncmesh->Rebalance();
+   }
 
    ParMesh* pmesh2 = new ParMesh(*pncmesh);
    pncmesh->OnMeshUpdated(pmesh2);
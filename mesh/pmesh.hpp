@@ -141,6 +141,10 @@ protected:
    virtual bool NonconformingDerefinement(Array<double> &elem_error,
                                           double threshold, int nc_limit = 0,
                                           int op = 1);
+
+   /// Implementation of Rebalance(), with unit weights if the pointer is NULL.
+   void RebalanceImpl(const Vector *elem_weights);
+
    void DeleteFaceNbrData();
 
    bool WantSkipSharedMaster(const NCMesh::Master &master) const;
@@ -289,6 +293,11 @@ public:
    /// Load balance the mesh. NC meshes only.
    void Rebalance();
 
+   /** Load balance the mesh, equalizing the total weight of the elements of
+       each processor, see ParNCMesh::Rebalance(const Vector&). The weights are
+       given for the local elements. NC meshes only. */
+   void Rebalance(const Vector &elem_weights);
+
    /** Print the part of the mesh in the calling processor adding the interface
        as boundary (for visualization purposes) using the mfem v1.0 format. */
    virtual void Print(std::ostream &out = mfem::out) const;
@@ -32,6 +32,8 @@ ParNCMesh::ParNCMesh(MPI_Comm comm, const NCMesh &ncmesh, int *part)
    MPI_Comm_size(MyComm, &NRanks);
    MPI_Comm_rank(MyComm, &MyRank);
 
+   rebalance_imbalance[0] = rebalance_imbalance[1] = 1.0;
+
    // assign leaf elements to the processors by simply splitting the
    // sequence of leaf elements into 'NRanks' parts
    for (int i = 0; i < leaf_elements.Size(); i++)
@@ -53,6 +55,7 @@ ParNCMesh::ParNCMesh(const ParNCMesh &other)
    , NRanks(other.NRanks)
    , MyRank(other.MyRank)
 {
+   rebalance_imbalance[0] = rebalance_imbalance[1] = 1.0;
    Update(); // mark all secondary stuff for recalculation
 }
 
@@ -137,6 +140,26 @@ void ParNCMesh::AssignLeafIndices()
    NCMesh::AssignLeafIndices();
 }
 
+void ParNCMesh::RenumberIds(const Array<int> &node_map,
+                            const Array<int> &face_map,
+                            const Array<int> &elem_map)
+{
+   NCMesh::RenumberIds(node_map, face_map, elem_map);
+
+   for (int i = 0; i < ghost_layer.Size(); i++)
+   {
+      ghost_layer[i] = elem_map[ghost_layer[i]];
+   }
+   for (int i = 0; i < boundary_layer.Size(); i++)
+   {
+      boundary_layer[i] = elem_map[boundary_layer[i]];
+   }
+
+   shared_vertices.RenumberElements(elem_map);
+   shared_edges.RenumberElements(elem_map);
+   shared_faces.RenumberElements(elem_map);
+}
+
 void ParNCMesh::UpdateVertices()
 {
    // This is an override of NCMesh::UpdateVertices. This version first
@@ -1350,10 +1373,16 @@ void ParNCMesh::Refine(const Array<Refinement> &refinements)
    NeighborRefinementMessage::IsendAll(send_ref, MyComm);
 
    // do local refinements
+   Array<Refinement> local(refinements.Size());
    for (int i = 0; i < refinements.Size(); i++)
    {
       const Refinement &ref = refinements[i];
-      NCMesh::RefineElement(leaf_elements[ref.index], ref.ref_type);
+      local[i] = Refinement(leaf_elements[ref.index], ref.ref_type);
+   }
+   RefineBatch(local); // the isotropic ones in (thread-parallel) batches
+   for (int i = 0; i < local.Size(); i++)
+   {
+      NCMesh::RefineElement(local[i].index, local[i].ref_type);
    }
 
    // receive (ghost layer) refinements from all neighbors
@@ -1708,7 +1737,7 @@ void ParNCMesh::CheckDerefinementNCLevel(const Table &deref_table,
 
 //// Rebalance /////////////////////////////////////////////////////////////////
 
-void ParNCMesh::Rebalance()
+void ParNCMesh::RebalanceImpl(const Vector *elem_weights)
 {
    send_rebalance_dofs.clear();
    recv_rebalance_dofs.clear();
@@ -1716,27 +1745,55 @@ void ParNCMesh::Rebalance()
    Array<int> old_elements;
    leaf_elements.GetSubArray(0, NElements, old_elements);
 
-   // figure out new assignments for Element::rank
-   long local_elems = NElements, total_elems = 0;
-   MPI_Allreduce(&local_elems, &total_elems, 1, MPI_LONG, MPI_SUM, MyComm);
-
-   long first_elem_global = 0;
-   MPI_Scan(&local_elems, &first_elem_global, 1, MPI_LONG, MPI_SUM, MyComm);
-   first_elem_global -= local_elems;
-
    Array<int> new_ranks(leaf_elements.Size());
    new_ranks = -1;
 
-   for (int i = 0, j = 0; i < leaf_elements.Size(); i++)
+   // figure out new assignments for Element::rank
+   int target_elements;
+   double local_load[2], total_load;
+   if (elem_weights)
+   {
+      double target_weight;
+      target_elements = PartitionByWeight(*elem_weights, new_ranks,
+                                          target_weight);
+      local_load[0] = elem_weights->Sum();
+      local_load[1] = target_weight;
+      MPI_Allreduce(&local_load[0], &total_load, 1, MPI_DOUBLE, MPI_SUM,
+                    MyComm);
+   }
+   else
    {
-      if (elements[leaf_elements[i]].rank == MyRank)
+      long local_elems = NElements, total_elems = 0;
+      MPI_Allreduce(&local_elems, &total_elems, 1, MPI_LONG, MPI_SUM, MyComm);
+
+      long first_elem_global = 0;
+      MPI_Scan(&local_elems, &first_elem_global, 1, MPI_LONG, MPI_SUM, MyComm);
+      first_elem_global -= local_elems;
+
+      for (int i = 0, j = 0; i < leaf_elements.Size(); i++)
       {
-         new_ranks[i] = Partition(first_elem_global + (j++), total_elems);
+         if (elements[leaf_elements[i]].rank == MyRank)
+         {
+            new_ranks[i] = Partition(first_elem_global + (j++), total_elems);
+         }
       }
+
+      target_elements = PartitionFirstIndex(MyRank+1, total_elems)
+                        - PartitionFirstIndex(MyRank, total_elems);
+
+      local_load[0] = NElements;
+      local_load[1] = target_elements;
+      total_load = total_elems;
    }
 
-   int target_elements = PartitionFirstIndex(MyRank+1, total_elems)
-                         - PartitionFirstIndex(MyRank, total_elems);
+   // the imbalance is the maximum load relative to the mean load
+   double max_load[2];
+   MPI_Allreduce(local_load, max_load, 2, MPI_DOUBLE, MPI_MAX, MyComm);
+   for (int i = 0; i < 2; i++)
+   {
+      rebalance_imbalance[i] =
+         (total_load > 0.0) ? max_load[i] * NRanks / total_load : 1.0;
+   }
 
    // assign the new ranks and send elements (plus ghosts) to new owners
    RedistributeElements(new_ranks, target_elements, true);
@@ -1754,6 +1811,57 @@ void ParNCMesh::Rebalance()
    Prune();
 }
 
+int ParNCMesh::PartitionByWeight(const Vector &elem_weights,
+                                 Array<int> &new_ranks,
+                                 double &target_weight) const
+{
+   MFEM_VERIFY(elem_weights.Size() == NElements,
+               "expected " << NElements << " element weights, got "
+               << elem_weights.Size());
+
+   double local_weight = 0.0;
+   for (int i = 0; i < NElements; i++)
+   {
+      MFEM_VERIFY(elem_weights(i) >= 0.0, "negative element weight");
+      local_weight += elem_weights(i);
+   }
+
+   double total_weight = 0.0, first_weight = 0.0;
+   MPI_Allreduce(&local_weight, &total_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+   MPI_Scan(&local_weight, &first_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+   first_weight -= local_weight;
+   MFEM_VERIFY(total_weight > 0.0, "the total element weight is zero");
+
+   // the number of elements and their weight for each new rank, from this
+   // rank; the ranks are assigned in the leaf order (the elements we own are
+   // the first NElements leaves), so only a range of ranks gets elements
+   Array<double> send_load(2*NRanks);
+   send_load = 0.0;
+
+   // each element goes to the part containing the midpoint of its weight
+   double weight = first_weight;
+   for (int i = 0; i < NElements; i++)
+   {
+      const double w = elem_weights(i);
+      const double mid = (weight + 0.5*w) / total_weight;
+      const int rank = std::min(int(mid * NRanks), NRanks-1);
+      new_ranks[i] = rank;
+      send_load[2*rank] += 1.0;
+      send_load[2*rank + 1] += w;
+      weight += w;
+   }
+
+   // sum the contributions of all ranks, each rank gets its own entries
+   Array<int> recv_counts(NRanks);
+   recv_counts = 2;
+   double target_load[2];
+   MPI_Reduce_scatter(send_load.GetData(), target_load, recv_counts.GetData(),
+                      MPI_DOUBLE, MPI_SUM, MyComm);
+
+   target_weight = target_load[1];
+   return int(target_load[0] + 0.5);
+}
+
 struct CompareRanks // TODO: use lambda when C++11 available
 {
    typedef BlockArray<NCMesh::Element> ElemArray;
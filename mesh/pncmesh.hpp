@@ -88,7 +88,21 @@ public:
 
    /** Migrate leaf elements of the global refinement hierarchy (including ghost
        elements) so that each processor owns the same number of leaves (+-1). */
-   void Rebalance();
+   void Rebalance() { RebalanceImpl(NULL); }
+
+   /** Migrate leaf elements so that each processor owns approximately the same
+       total weight. The leaves keep their (space-filling curve) order and are
+       split into contiguous parts by their cumulative weight. The nonnegative
+       weights are given for the elements owned by this processor, in the order
+       of the Mesh elements. A processor may receive no elements if a few
+       elements carry most of the weight. */
+   void Rebalance(const Vector &elem_weights) { RebalanceImpl(&elem_weights); }
+
+   /** Return the load imbalance, i.e., the ratio of the maximum and the mean
+       weight (or number of elements) per processor, before and after the last
+       Rebalance(). */
+   void GetRebalanceImbalance(double &before, double &after) const
+   { before = rebalance_imbalance[0]; after = rebalance_imbalance[1]; }
 
 
    // interface for ParFiniteElementSpace
@@ -284,6 +298,10 @@ protected: // implementation
 
    virtual void Update();
 
+   virtual void RenumberIds(const Array<int> &node_map,
+                            const Array<int> &face_map,
+                            const Array<int> &elem_map);
+
    virtual bool IsGhost(const Element& el) const
    { return el.rank != MyRank; }
 
@@ -302,6 +320,16 @@ protected: // implementation
    long PartitionFirstIndex(int rank, long total_elements) const
    { return (rank * total_elements + NRanks-1) / NRanks; }
 
+   /** Implementation of Rebalance(), with unit weights if @a elem_weights is
+       NULL. */
+   void RebalanceImpl(const Vector *elem_weights);
+
+   /** Assign new ranks to the elements owned by this processor, splitting the
+       leaves by their cumulative weight. Return the number of elements the
+       processor will own, and in @a target_weight their total weight. */
+   int PartitionByWeight(const Vector &elem_weights, Array<int> &new_ranks,
+                         double &target_weight) const;
+
    virtual void UpdateVertices();
    virtual void AssignLeafIndices();
    virtual void OnMeshUpdated(Mesh *mesh);
@@ -520,6 +548,9 @@ protected: // implementation
        the ranks of the old (potentially non-existent) fine elements. */
    Array<int> old_index_or_rank;
 
+   /// Load imbalance before and after the last Rebalance.
+   double rebalance_imbalance[2];
+
    /// Stores modified point matrices created by GetFaceNeighbors
    Array<DenseMatrix*> aux_pm_store;
    void ClearAuxPM();
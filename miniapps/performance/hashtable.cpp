@@ -0,0 +1,214 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+//
+//      -------------------------------------------------------------
+//      HashTable Miniapp: performance of the NCMesh hash tables
+//      -------------------------------------------------------------
+//
+// This miniapp measures the performance of HashTable, the container used by
+// NCMesh for its nodes and faces. It times insertion, successful and failed
+// lookups, deletion and reinsertion of items keyed by two (edges) and four
+// (faces) ids, with std::unordered_map as a fixed point of reference, and then
+// the local refinement of a 3D non-conforming mesh, which is dominated by
+// hash table lookups.
+//
+// Compile with: make hashtable
+//
+// Sample runs:  hashtable
+//               hashtable -n 4000000
+//               hashtable -n 100000 -l 4
+
+#include "mfem.hpp"
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+using namespace mfem;
+
+// Report the time per operation, in nanoseconds.
+static void Report(const char *name, double seconds, int num_ops)
+{
+   cout << setw(24) << name << setw(14) << 1e9*seconds/num_ops << endl;
+}
+
+// Access the items keyed by two or four ids, the first ones in 'k'.
+static int GetId(HashTable<Hashed2> &t, const int *k)
+{ return t.GetId(k[0], k[1]); }
+
+static int GetId(HashTable<Hashed4> &t, const int *k)
+{ return t.GetId(k[0], k[1], k[2], k[3]); }
+
+static int FindId(const HashTable<Hashed2> &t, const int *k)
+{ return t.FindId(k[0], k[1]); }
+
+static int FindId(const HashTable<Hashed4> &t, const int *k)
+{ return t.FindId(k[0], k[1], k[2], k[3]); }
+
+// Time the operations of HashTable<T> on the given keys, whose last two
+// entries (p3, p4) are ignored if T is a Hashed2.
+template <typename T>
+void BenchmarkHashTable(const vector<int> &keys, const char *title)
+{
+   const int n = int(keys.size()/4);
+   const int *k = keys.data();
+   StopWatch sw;
+   long found = 0;
+   cout << title << endl;
+
+   HashTable<T> table;
+   sw.Clear(); sw.Start();
+   for (int i = 0; i < n; i++, k += 4)
+   {
+      GetId(table, k);
+   }
+   sw.Stop();
+   Report("insert", sw.RealTime(), n);
+
+   // look up in a different order, as the refinement algorithms do
+   sw.Clear(); sw.Start();
+   for (int i = n-1; i >= 0; i--)
+   {
+      // the order of the ids does not matter
+      k = keys.data() + 4*((i*7919LL) % n);
+      const int p[4] = { k[1], k[0], k[3], k[2] };
+      found += (FindId(table, p) >= 0);
+   }
+   sw.Stop();
+   Report("find (hit)", sw.RealTime(), n);
+
+   sw.Clear(); sw.Start();
+   for (int i = 0; i < n; i++)
+   {
+      k = keys.data() + 4*i;
+      const int p[4] = { k[0]+1, k[1], k[2], k[3] };
+      found += (FindId(table, p) >= 0);
+   }
+   sw.Stop();
+   Report("find (miss)", sw.RealTime(), n);
+
+   sw.Clear(); sw.Start();
+   const int num_ids = table.NumIds();
+   for (int i = 0; i < num_ids; i += 2) { table.Delete(i); }
+   for (int i = 0; i < num_ids; i += 2)
+   {
+      GetId(table, keys.data() + 4*i);
+   }
+   sw.Stop();
+   Report("delete + reinsert", sw.RealTime(), num_ids);
+
+   cout << setw(24) << "memory [bytes/item]" << setw(14)
+        << double(table.MemoryUsage())/table.Size() << endl;
+   cout << setw(24) << "items found" << setw(14) << found << endl;
+}
+
+// Time std::unordered_map on the same operations, for reference.
+template <bool four>
+void BenchmarkStdMap(const vector<int> &keys)
+{
+   const int n = int(keys.size()/4);
+   StopWatch sw;
+   long found = 0;
+   cout << "std::unordered_map" << endl;
+
+   struct KeyHash
+   {
+      size_t operator()(const std::pair<long long, int> &p) const
+      { return std::hash<long long>()(p.first) ^ (size_t(p.second) << 1); }
+   };
+   unordered_map<std::pair<long long, int>, int, KeyHash> map;
+   vector<std::pair<long long, int> > sorted(n);
+   for (int i = 0; i < n; i++)
+   {
+      int v[4] = { keys[4*i], keys[4*i+1], keys[4*i+2], keys[4*i+3] };
+      if (four) { std::sort(v, v + 4); }
+      else if (v[0] > v[1]) { std::swap(v[0], v[1]); }
+      sorted[i] = std::make_pair((long long)(v[0])*(1LL << 32) + v[1],
+                                 four ? v[2] : 0);
+   }
+
+   sw.Clear(); sw.Start();
+   for (int i = 0; i < n; i++) { map.insert(std::make_pair(sorted[i], i)); }
+   sw.Stop();
+   Report("insert", sw.RealTime(), n);
+
+   sw.Clear(); sw.Start();
+   for (int i = n-1; i >= 0; i--)
+   {
+      found += map.count(sorted[(i*7919LL) % n]);
+   }
+   sw.Stop();
+   Report("find (hit)", sw.RealTime(), n);
+   cout << setw(24) << "items found" << setw(14) << found << endl;
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   int num_items = 1000000;
+   int ref_levels = 3;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&num_items, "-n", "--num-items",
+                  "Number of items inserted in the hash tables.");
+   args.AddOption(&ref_levels, "-l", "--levels",
+                  "Number of levels of local NC refinement of the mesh.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Generate random keys: ids of nodes close to each other, like the end
+   //    points of edges or the corners of faces.
+   vector<int> keys(4*num_items);
+   srand(1);
+   for (int i = 0; i < num_items; i++)
+   {
+      const int base = rand() % (4*num_items);
+      for (int j = 0; j < 4; j++) { keys[4*i+j] = base + j*(1 + rand() % 64); }
+   }
+
+   // 3. Benchmark the hash tables.
+   cout << setw(24) << "operation" << setw(14) << "time [ns/op]" << endl;
+   BenchmarkHashTable<Hashed2>(keys, "HashTable<Hashed2>");
+   BenchmarkStdMap<false>(keys);
+   BenchmarkHashTable<Hashed4>(keys, "HashTable<Hashed4>");
+   BenchmarkStdMap<true>(keys);
+
+   // 4. Refine a 3D non-conforming mesh towards a corner.
+   Mesh mesh(8, 8, 8, Element::HEXAHEDRON);
+   mesh.EnsureNCMesh();
+   StopWatch sw;
+   sw.Start();
+   for (int l = 0; l < ref_levels; l++)
+   {
+      Array<int> refs;
+      Vector center;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         mesh.GetElementTransformation(i)->Transform(
+            Geometries.GetCenter(mesh.GetElementBaseGeometry(i)), center);
+         if (center.Norml2() < 0.6) { refs.Append(i); }
+      }
+      mesh.GeneralRefinement(refs);
+   }
+   sw.Stop();
+   cout << "NC refinement: " << mesh.GetNE() << " elements, "
+        << sw.RealTime() << " s" << endl;
+
+   return 0;
+}
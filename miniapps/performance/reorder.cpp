@@ -0,0 +1,153 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+//
+//      -----------------------------------------------------------------
+//      Reorder Miniapp: effect of the element ordering on the performance
+//      -----------------------------------------------------------------
+//
+// This miniapp measures the effect of the order of the mesh elements on the
+// assembly of a diffusion matrix and on the sparse matrix-vector product (or,
+// with -pa, the partially assembled operator). The elements are first shuffled
+// randomly, which is similar to the order produced by many mesh generators,
+// and then reordered along the Hilbert and Morton space-filling curves with
+// Mesh::GetSFCElementOrdering(). The vertices are renumbered together with the
+// elements, so the degrees of freedom follow the new order as well.
+//
+// Compile with: make reorder
+//
+// Sample runs:  reorder
+//               reorder -m ../../data/fichera.mesh -r 3 -o 2
+//               reorder -m ../../data/fichera.mesh -r 3 -o 3 -pa
+//               reorder -m ../../data/star.mesh -r 5 -no-shuffle
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace std;
+using namespace mfem;
+
+// Time the assembly and the operator application for the given mesh.
+void Benchmark(Mesh &mesh, int order, bool pa, int num_mult, const char *name)
+{
+   H1_FECollection fec(order, mesh.Dimension());
+   FiniteElementSpace fespace(&mesh, &fec);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fespace);
+   if (pa) { a.SetAssemblyLevel(AssemblyLevel::PARTIAL); }
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+
+   OperatorPtr A;
+   Array<int> ess_tdof_list;
+   tic_toc.Clear();
+   tic_toc.Start();
+   a.Assemble();
+   a.FormSystemMatrix(ess_tdof_list, A);
+   tic_toc.Stop();
+   const double t_assembly = tic_toc.RealTime();
+
+   Vector x(A->Width()), y(A->Height());
+   x.Randomize(1);
+   tic_toc.Clear();
+   tic_toc.Start();
+   for (int i = 0; i < num_mult; i++)
+   {
+      A->Mult(x, y);
+   }
+   tic_toc.Stop();
+   const double t_mult = tic_toc.RealTime()/num_mult;
+
+   cout << setw(10) << name
+        << setw(16) << t_assembly
+        << setw(16) << t_mult << endl;
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/fichera.mesh";
+   int ref_levels = 2;
+   int order = 2;
+   bool shuffle = true;
+   bool pa = false;
+   int num_mult = 20;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of uniform refinements of the mesh.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&shuffle, "-s", "--shuffle", "-no-shuffle", "--no-shuffle",
+                  "Shuffle the elements randomly before the benchmark.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
+   args.AddOption(&num_mult, "-n", "--num-mult",
+                  "Number of operator applications to time.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+   Device device("cpu");
+
+   // 2. Read and refine the mesh, then shuffle its elements.
+   Mesh mesh(mesh_file, 1, 1);
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh.UniformRefinement();
+   }
+   if (mesh.NURBSext || mesh.ncmesh)
+   {
+      cout << "NURBS and non-conforming meshes can not be reordered." << endl;
+      return 2;
+   }
+   if (shuffle)
+   {
+      Array<int> perm(mesh.GetNE());
+      for (int i = 0; i < perm.Size(); i++) { perm[i] = i; }
+      srand(1);
+      for (int i = perm.Size()-1; i > 0; i--)
+      {
+         Swap(perm[i], perm[rand() % (i+1)]);
+      }
+      mesh.ReorderElements(perm);
+   }
+   cout << "Number of elements: " << mesh.GetNE() << endl;
+
+   // 3. Run the benchmark with the initial and the space-filling curve
+   //    orderings of the elements.
+   cout << setw(10) << "ordering"
+        << setw(16) << "assembly [s]"
+        << setw(16) << (pa ? "PA mult [s]" : "SpMV [s]") << endl;
+   {
+      Mesh initial(mesh);
+      Benchmark(initial, order, pa, num_mult, shuffle ? "shuffled" : "initial");
+   }
+   const char *names[] = { "Hilbert", "Morton" };
+   const int types[] = { Mesh::HILBERT, Mesh::MORTON };
+   for (int k = 0; k < 2; k++)
+   {
+      Mesh reordered(mesh);
+      Array<int> ordering;
+      reordered.GetSFCElementOrdering(ordering, types[k]);
+      reordered.ReorderElements(ordering);
+      Benchmark(reordered, order, pa, num_mult, names[k]);
+   }
+
+   return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <limits>
+
+using namespace mfem;
+
+#ifdef MFEM_USE_MPI
+
+namespace ppointlocator
+{
+
+double f2(const Vector &x) { return 1.0 + 2.0*x(0) - 3.0*x(1); }
+
+TEST_CASE("ParPointLocator", "[ParPointLocator][Parallel]")
+{
+   int myrank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true, 2.0, 1.0);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   H1_FECollection fec(1, 2);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   ParGridFunction gf(&fes);
+   FunctionCoefficient coeff(f2);
+   gf.ProjectCoefficient(coeff);
+
+   ParPointLocator locator(pmesh, 4);
+
+   // each rank gives its own points: inside the mesh, on its boundary and
+   // outside of it, including coordinates which do not fit in an int
+   const double nan = std::numeric_limits<double>::quiet_NaN();
+   const double pts[][2] =
+   {
+      { 0.3 + 0.1*myrank, 0.7 }, { 1.9, 0.05 }, { 0.0, 0.0 }, { 2.0, 1.0 },
+      { 2.5, 0.5 }, { -0.1, 0.5 }, { 1e300, 0.5 }, { 0.5, -1e300 },
+      { nan, 0.5 }
+   };
+   const int num_inside = 4, npts = sizeof(pts)/sizeof(pts[0]);
+   DenseMatrix point_mat(2, npts);
+   for (int k = 0; k < npts; k++)
+   {
+      point_mat(0, k) = pts[k][0];
+      point_mat(1, k) = pts[k][1];
+   }
+
+   REQUIRE(locator.FindPoints(point_mat) == num_inside);
+   const Array<int> &ranks = locator.GetPointRanks();
+   for (int k = 0; k < npts; k++)
+   {
+      REQUIRE((ranks[k] >= 0) == (k < num_inside));
+   }
+
+   Vector vals;
+   locator.Interpolate(gf, vals);
+   REQUIRE(vals.Size() == npts);
+   for (int k = 0; k < npts; k++)
+   {
+      Vector x(point_mat.GetColumn(k), 2);
+      const double exact = (k < num_inside) ? f2(x) : 0.0;
+      REQUIRE(fabs(vals(k) - exact) < 1e-12);
+   }
+
+   // no points on this rank
+   DenseMatrix no_points;
+   REQUIRE(locator.FindPoints(no_points) == 0);
+   locator.Interpolate(gf, vals);
+   REQUIRE(vals.Size() == 0);
+}
+
+} // namespace ppointlocator
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,188 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+using namespace mfem;
+
+#include "catch.hpp"
+
+TEST_CASE("HashTable", "[General]")
+{
+   SECTION("Pairs of ids")
+   {
+      // a small initial size forces several rehashes
+      HashTable<Hashed2> table(16, 4);
+      for (int i = 0; i < 1000; i++)
+      {
+         REQUIRE(table.GetId(i, i+1) == i);
+      }
+      REQUIRE(table.Size() == 1000);
+      for (int i = 0; i < 1000; i++)
+      {
+         REQUIRE(table.FindId(i+1, i) == i);
+         REQUIRE(table.Find(i, i+1) == &table[i]);
+         REQUIRE(table.FindId(i, i+2) == -1);
+      }
+
+      // deleted ids are reused, the other ids do not change
+      for (int i = 0; i < 1000; i += 3) { table.Delete(i); }
+      for (int i = 0; i < 1000; i++)
+      {
+         REQUIRE(table.IdExists(i) == (i % 3 != 0));
+         REQUIRE(table.FindId(i, i+1) == ((i % 3) ? i : -1));
+      }
+      int count = 0;
+      for (HashTable<Hashed2>::iterator it = table.begin(); it != table.end();
+           ++it)
+      {
+         REQUIRE(it->p2 == it->p1 + 1);
+         count++;
+      }
+      REQUIRE(count == table.Size());
+      const int id = table.GetId(5000, 5001);
+      REQUIRE(id % 3 == 0);
+      REQUIRE(id < 1000);
+
+      table.Reparent(1, 7000, 7001);
+      REQUIRE(table.FindId(1, 2) == -1);
+      REQUIRE(table.FindId(7001, 7000) == 1);
+
+      HashTable<Hashed2> copy(table);
+      REQUIRE(copy.Size() == table.Size());
+      REQUIRE(copy.FindId(7000, 7001) == 1);
+      REQUIRE(copy.FindId(5000, 5001) == id);
+   }
+
+   SECTION("Quadruples of ids")
+   {
+      HashTable<Hashed4> table(16, 4);
+      for (int i = 0; i < 1000; i++)
+      {
+         REQUIRE(table.GetId(i, i+3, i+1, i+2) == i);
+      }
+      for (int i = 0; i < 1000; i++)
+      {
+         REQUIRE(table.FindId(i+2, i+1, i+3, i) == i);
+         // the fourth (largest) id is not part of the key
+         REQUIRE(table.FindId(i, i+1, i+2, i+4) == i);
+         REQUIRE(table.FindId(i, i+1, i+3, i+4) == -1);
+      }
+      table.Delete(10);
+      REQUIRE(table.FindId(10, 11, 12, 13) == -1);
+      table.Reparent(20, 5000, 5001, 5002, 5003);
+      REQUIRE(table.FindId(5003, 5002, 5001, 5000) == 20);
+      REQUIRE(table.FindId(20, 21, 22, 23) == -1);
+   }
+
+   SECTION("Compaction")
+   {
+      // items parented by other items, like the nodes of NCMesh
+      HashTable<Hashed2> table(16, 4);
+      std::vector<std::pair<int, int> > parents;
+      for (int i = 0; i < 100; i++)
+      {
+         REQUIRE(table.GetId(i, i) == i);
+         parents.push_back(std::make_pair(i, i));
+      }
+      srand(3);
+      while (table.Size() < 1000)
+      {
+         const int a = rand() % table.Size(), b = rand() % table.Size();
+         if (a == b || table.FindId(a, b) >= 0) { continue; }
+         REQUIRE(table.GetId(a, b) == int(parents.size()));
+         parents.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+      }
+
+      // delete some of the items which are not parents
+      std::vector<int> children(1000, 0);
+      for (int i = 100; i < 1000; i++)
+      {
+         children[parents[i].first]++;
+         children[parents[i].second]++;
+      }
+      for (int i = 999; i >= 100; i--)
+      {
+         if (children[i] || rand() % 2) { continue; }
+         table.Delete(i);
+         children[parents[i].first]--;
+         children[parents[i].second]--;
+      }
+      const int size = table.Size();
+      const long memory = table.MemoryUsage();
+      REQUIRE(size < 900);
+
+      Array<int> new_ids;
+      table.GetCompactIds(new_ids);
+      REQUIRE(new_ids.Size() == 1000);
+      table.Compact(new_ids);
+      REQUIRE(table.Size() == size);
+      REQUIRE(table.NumIds() == size);
+      REQUIRE(table.NumFreeIds() == 0);
+      REQUIRE(table.MemoryUsage() < memory);
+
+      // the items keep their order and their (renumbered) parents
+      int last_id = -1;
+      for (int i = 0; i < 1000; i++)
+      {
+         const int id = new_ids[i];
+         if (id < 0) { continue; }
+         REQUIRE(id == last_id + 1);
+         last_id = id;
+         const int p1 = new_ids[parents[i].first];
+         const int p2 = new_ids[parents[i].second];
+         REQUIRE(table[id].p1 == p1);
+         REQUIRE(table[id].p2 == p2);
+         REQUIRE(table.FindId(p2, p1) == id);
+      }
+
+      // new items get new ids at the end
+      REQUIRE(table.GetId(5000, 5001) == size);
+   }
+
+   SECTION("Random insertions and deletions")
+   {
+      HashTable<Hashed2> table(16, 4);
+      std::map<std::pair<int, int>, int> ref;
+      srand(1);
+      for (int k = 0; k < 20000; k++)
+      {
+         int p1 = rand() % 200, p2 = rand() % 200;
+         if (p1 > p2) { std::swap(p1, p2); }
+         const std::pair<int, int> key(p1, p2);
+         if (rand() % 3 == 0 && ref.count(key))
+         {
+            table.Delete(ref[key]);
+            ref.erase(key);
+         }
+         else
+         {
+            const int id = table.GetId(p2, p1);
+            if (ref.count(key)) { REQUIRE(ref[key] == id); }
+            ref[key] = id;
+         }
+      }
+      REQUIRE(table.Size() == int(ref.size()));
+      for (int p1 = 0; p1 < 200; p1++)
+      {
+         for (int p2 = p1; p2 < 200; p2++)
+         {
+            const std::pair<int, int> key(p1, p2);
+            const int id = table.FindId(p1, p2);
+            REQUIRE(id == (ref.count(key) ? ref[key] : -1));
+         }
+      }
+   }
+}
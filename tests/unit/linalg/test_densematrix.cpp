@@ -155,3 +155,226 @@ TEST_CASE("DenseMatrix A*B^T methods",
    }
 }
 
+
+TEST_CASE("BatchLUFactor and BatchLUSolve", "[DenseMatrix]")
+{
+   const int NE = 7;
+
+   // fixed-size, blocked fixed-size and blocked general kernels, with full and
+   // partial panels
+   const int sizes[] = { 1, 4, 7, 10, 16, 27, 30, 64, 66 };
+   for (int k = 0; k < 9; k++)
+   {
+      const int n = sizes[k];
+      DenseTensor A(n, n, NE);
+      Vector b(n*NE), x;
+      b.Randomize(n);
+      for (int e = 0; e < NE; e++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            for (int i = 0; i < n; i++)
+            {
+               A(i,j,e) = std::sin(1.0 + i + 2*j + 3*e) + ((i == j) ? 0.1 : 0.0);
+            }
+         }
+      }
+      DenseTensor Alu(A);
+      Array<int> P;
+      BatchLUFactor(Alu, P);
+      x = b;
+      BatchLUSolve(Alu, P, x);
+
+      for (int e = 0; e < NE; e++)
+      {
+         Vector x_e(x.GetData() + e*n, n), b_e(b.GetData() + e*n, n), r(n);
+         A(e).Mult(x_e, r);
+         r -= b_e;
+         REQUIRE(r.Normlinf() < 1e-10);
+
+#ifndef MFEM_USE_LAPACK
+         // Same factors as LUFactors, which uses the same kernel; LAPACK may
+         // choose different pivots.
+         const double tol = 1e-12;
+         DenseMatrix Ae(A(e));
+         Array<int> ipiv(n);
+         LUFactors lu(Ae.Data(), ipiv.GetData());
+         lu.Factor(n);
+         for (int i = 0; i < n*n; i++)
+         {
+            REQUIRE(std::abs(Ae.Data()[i] - Alu.GetData(e)[i]) < tol);
+         }
+#endif
+      }
+   }
+}
+
+TEST_CASE("BatchLUFactor of matrices of different sizes", "[DenseMatrix]")
+{
+   // Matrices of sizes 0 to 9, several of each size, stored one after the
+   // other in a single array, in a mixed order of sizes.
+   const int num = 30;
+   Array<int> sizes(num), offsets(num), ipiv_offsets(num);
+   int size = 0, ipiv_size = 0;
+   for (int k = 0; k < num; k++)
+   {
+      sizes[k] = (7*k) % 10;
+      offsets[k] = size;
+      ipiv_offsets[k] = ipiv_size;
+      size += sizes[k]*sizes[k];
+      ipiv_size += sizes[k];
+   }
+   Vector data(size);
+   for (int k = 0; k < num; k++)
+   {
+      const int n = sizes[k];
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < n; i++)
+         {
+            data(offsets[k] + i + j*n) = std::cos(1.0 + 3*i + j + 5*k) +
+                                         ((i == j) ? 0.2 : 0.0);
+         }
+      }
+   }
+   Vector factors(data);
+   Array<int> ipiv(ipiv_size);
+   BatchLUFactor(sizes, offsets, factors.GetData(), ipiv_offsets,
+                 ipiv.GetData());
+
+   // The factors and pivots can be used with LUFactors, with or without
+   // LAPACK.
+   for (int k = 0; k < num; k++)
+   {
+      const int n = sizes[k];
+      DenseMatrix A(data.GetData() + offsets[k], n, n);
+      Vector b(n), x(n), r(n);
+      b.Randomize(k);
+      x = b;
+      LUFactors lu(factors.GetData() + offsets[k],
+                   ipiv.GetData() + ipiv_offsets[k]);
+      lu.Solve(n, 1, x.GetData());
+      A.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-10);
+   }
+}
+
+TEST_CASE("BatchCholeskyFactor and BatchCholeskySolve", "[DenseMatrix]")
+{
+   const int NE = 5;
+
+   for (int n = 1; n <= 13; n += 4)
+   {
+      // A_e = B_e B_e^T + I is symmetric positive definite.
+      DenseTensor A(n, n, NE);
+      for (int e = 0; e < NE; e++)
+      {
+         DenseMatrix B(n);
+         for (int j = 0; j < n; j++)
+         {
+            for (int i = 0; i < n; i++)
+            {
+               B(i,j) = std::sin(2.0 + i + 3*j + 5*e);
+            }
+         }
+         MultAAt(B, A(e));
+         for (int i = 0; i < n; i++) { A(i,i,e) += 1.0; }
+      }
+      DenseTensor L(A);
+      BatchCholeskyFactor(L);
+
+      Vector b(n*NE), x;
+      b.Randomize(n);
+      x = b;
+      BatchCholeskySolve(L, x);
+
+      for (int e = 0; e < NE; e++)
+      {
+         // L_e L_e^T = A_e
+         for (int j = 0; j < n; j++)
+         {
+            for (int i = j; i < n; i++)
+            {
+               double a_ij = 0.0;
+               for (int k = 0; k <= j; k++) { a_ij += L(i,k,e)*L(j,k,e); }
+               REQUIRE(std::abs(a_ij - A(i,j,e)) < 1e-10);
+            }
+         }
+         Vector x_e(x.GetData() + e*n, n), b_e(b.GetData() + e*n, n), r(n);
+         A(e).Mult(x_e, r);
+         r -= b_e;
+         REQUIRE(r.Normlinf() < 1e-10);
+      }
+   }
+}
+
+TEST_CASE("DenseMatrix products", "[DenseMatrix]")
+{
+   // Sizes below and above the threshold of the blocked algorithm used
+   // without LAPACK.
+   const int sizes[][3] = { {3, 4, 5}, {17, 9, 2}, {60, 50, 70},
+      {130, 67, 301}
+   };
+
+   for (int s = 0; s < 4; s++)
+   {
+      const int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+      DenseMatrix A(m, k), B(k, n), Bt(n, k), At(k, m), C(m, n), Cex(m, n);
+      Vector(A.Data(), m*k).Randomize(1);
+      Vector(B.Data(), k*n).Randomize(2);
+      Bt.Transpose(B);
+      At.Transpose(A);
+
+      for (int i = 0; i < m; i++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            double d = 0.0;
+            for (int p = 0; p < k; p++) { d += A(i,p)*B(p,j); }
+            Cex(i,j) = d;
+         }
+      }
+      const double tol = 1e-12*k;
+
+      Mult(A, B, C);
+      C -= Cex;
+      REQUIRE(C.MaxMaxNorm() < tol);
+
+      DenseMatrix Ones(m, n);
+      Ones = 1.0;
+      C = Ones;
+      AddMult(A, B, C);
+      C -= Ones;
+      C -= Cex;
+      REQUIRE(C.MaxMaxNorm() < tol);
+
+      MultABt(A, Bt, C);
+      C -= Cex;
+      REQUIRE(C.MaxMaxNorm() < tol);
+
+      C = 0.0;
+      AddMult_a_ABt(2.0, A, Bt, C);
+      C.Add(-2.0, Cex);
+      REQUIRE(C.MaxMaxNorm() < 2*tol);
+
+      MultAtB(At, B, C);
+      C -= Cex;
+      REQUIRE(C.MaxMaxNorm() < tol);
+
+      DenseMatrix AAt(m), AAt_ex(m);
+      AAt = 0.0;
+      AddMult_a_AAt(0.5, A, AAt);
+      MultABt(A, A, AAt_ex);
+      AAt_ex *= 0.5;
+      for (int i = 0; i < m; i++)
+      {
+         for (int j = 0; j < m; j++)
+         {
+            REQUIRE(AAt(i,j) == AAt(j,i));
+         }
+      }
+      AAt -= AAt_ex;
+      REQUIRE(AAt.MaxMaxNorm() < tol);
+   }
+}
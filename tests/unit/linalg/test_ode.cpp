@@ -0,0 +1,200 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <cmath>
+
+using namespace mfem;
+
+namespace ode_test
+{
+
+// dx/dt = -lambda (x - cos(t)), with a fast initial transient for large lambda.
+class Relaxation : public TimeDependentOperator
+{
+   double lambda;
+
+public:
+   Relaxation(int n, double lambda_) : TimeDependentOperator(n, 0.0),
+      lambda(lambda_) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      for (int i = 0; i < x.Size(); i++)
+      {
+         y(i) = -lambda*(x(i) - std::cos(GetTime()));
+      }
+   }
+
+   // Exact solution with x(0) = 0.
+   double Exact(double t) const
+   {
+      const double l2 = lambda*lambda;
+      return lambda/(l2 + 1.0)*(lambda*std::cos(t) + std::sin(t))
+             - l2/(l2 + 1.0)*std::exp(-lambda*t);
+   }
+};
+
+// dx/dt = -lambda (x - cos(t)) + (x - cos(t)) - sin(t), with the exact
+// solution x = cos(t) for x(0) = 1. The stiff relaxation term is treated
+// implicitly and the remaining terms explicitly.
+class SplitRelaxation : public SplitTimeDependentOperator
+{
+   double lambda;
+
+public:
+   SplitRelaxation(int n, double lambda_)
+      : SplitTimeDependentOperator(n, 0.0), lambda(lambda_) { }
+
+   virtual void ExplicitPartMult(const Vector &x, Vector &y) const
+   {
+      const double t = GetTime();
+      for (int i = 0; i < x.Size(); i++)
+      {
+         y(i) = x(i) - std::cos(t) - std::sin(t);
+      }
+   }
+
+   virtual void ImplicitPartMult(const Vector &x, Vector &y) const
+   {
+      for (int i = 0; i < x.Size(); i++)
+      {
+         y(i) = -lambda*(x(i) - std::cos(GetTime()));
+      }
+   }
+
+   virtual void ImplicitPartSolve(const double dt, const Vector &x, Vector &k)
+   {
+      // k = -lambda (x + dt k - cos(t))
+      for (int i = 0; i < x.Size(); i++)
+      {
+         k(i) = -lambda*(x(i) - std::cos(GetTime()))/(1.0 + lambda*dt);
+      }
+   }
+};
+
+}
+
+using namespace ode_test;
+
+TEST_CASE("Embedded Runge-Kutta solvers", "[ODESolver]")
+{
+   const double tf = 2.0;
+   Relaxation oper(3, 50.0);
+
+   BogackiShampine32Solver bs32;
+   DormandPrince54Solver dp54;
+   EmbeddedRKSolver *solvers[2] = { &bs32, &dp54 };
+
+   for (int k = 0; k < 2; k++)
+   {
+      EmbeddedRKSolver &ode = *solvers[k];
+      ode.SetTolerances(1e-8, 1e-10);
+      ode.Init(oper);
+
+      Vector x(3);
+      x = 0.0;
+      double t = 0.0, dt = 0.1;
+      ode.Run(x, t, dt, tf);
+
+      REQUIRE(std::abs(t - tf) < 1e-12);
+      REQUIRE(std::abs(x(0) - oper.Exact(tf)) < 1e-6);
+      REQUIRE(ode.GetNumRejectedSteps() > 0);
+      REQUIRE(ode.GetNumAcceptedSteps() > 0);
+   }
+
+   // The higher order pair needs fewer steps for the same tolerance.
+   REQUIRE(dp54.GetNumAcceptedSteps() < bs32.GetNumAcceptedSteps());
+
+   SECTION("Step updates dt")
+   {
+      dp54.SetTolerances(1e-6, 1e-8);
+      dp54.Init(oper);
+      Vector x(3);
+      x = 0.0;
+      double t = 0.0, dt = 1.0;
+      dp54.Step(x, t, dt);
+      REQUIRE(t == dp54.GetLastStepSize());
+      REQUIRE(t < 1.0);
+      REQUIRE(dp54.GetNumRejectedSteps() > 0);
+      REQUIRE(dt > 0.0);
+   }
+}
+
+TEST_CASE("Low-storage Runge-Kutta solvers", "[ODESolver]")
+{
+   const double tf = 1.0;
+   Relaxation oper(2, 2.0);
+
+   LSRK3Solver lsrk3;
+   LSRK4Solver lsrk4;
+   LowStorageSSPRKSolver ssp52(5, 2), ssp43(4, 3), ssp93(9, 3);
+   ODESolver *solvers[5] = { &lsrk3, &lsrk4, &ssp52, &ssp43, &ssp93 };
+   const int orders[5] = { 3, 4, 2, 3, 3 };
+
+   for (int k = 0; k < 5; k++)
+   {
+      double err[2];
+      for (int l = 0; l < 2; l++)
+      {
+         const int nsteps = 20 << l;
+         solvers[k]->Init(oper);
+         Vector x(2);
+         x = 0.0;
+         double t = 0.0, dt = tf/nsteps;
+         for (int i = 0; i < nsteps; i++) { solvers[k]->Step(x, t, dt); }
+         err[l] = std::abs(x(0) - oper.Exact(tf));
+      }
+      const double rate = std::log(err[0]/err[1])/std::log(2.0);
+      REQUIRE(rate > orders[k] - 0.25);
+   }
+}
+
+TEST_CASE("IMEX Runge-Kutta solvers", "[ODESolver]")
+{
+   const double tf = 1.0;
+
+   IMEXARK2Solver ark2;
+   IMEXARK3Solver ark3;
+   IMEXARK4Solver ark4;
+   IMEXRKSolver *solvers[3] = { &ark2, &ark3, &ark4 };
+   const int orders[3] = { 2, 3, 4 };
+
+   for (int k = 0; k < 3; k++)
+   {
+      // Convergence rate for a nonstiff problem.
+      SplitRelaxation oper(1, 2.0);
+      double err[2];
+      for (int l = 0; l < 2; l++)
+      {
+         const int nsteps = 10 << l;
+         solvers[k]->Init(oper);
+         Vector x(1);
+         x = 1.0;
+         double t = 0.0, dt = tf/nsteps;
+         for (int i = 0; i < nsteps; i++) { solvers[k]->Step(x, t, dt); }
+         err[l] = std::abs(x(0) - std::cos(tf));
+      }
+      const double rate = std::log(err[0]/err[1])/std::log(2.0);
+      REQUIRE(rate > orders[k] - 0.25);
+
+      // Stability for a stiff problem with dt far above the explicit limit.
+      SplitRelaxation stiff(1, 1e6);
+      solvers[k]->Init(stiff);
+      Vector x(1);
+      x = 1.0;
+      double t = 0.0, dt = 0.1;
+      for (int i = 0; i < 10; i++) { solvers[k]->Step(x, t, dt); }
+      REQUIRE(std::abs(x(0) - std::cos(t)) < 1e-2);
+   }
+}
@@ -0,0 +1,575 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace solvers_test
+{
+
+// Shifted 1D Laplacian: tridiag(-1, 2+shift, -1) of size n.
+static SparseMatrix *Laplacian1D(int n, double shift = 0.0)
+{
+   SparseMatrix *A = new SparseMatrix(n);
+   for (int i = 0; i < n; i++)
+   {
+      A->Add(i, i, 2.0 + shift);
+      if (i > 0) { A->Add(i, i-1, -1.0); }
+      if (i < n-1) { A->Add(i, i+1, -1.0); }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Shifted 2D Laplacian: 5-point stencil on an n x n grid.
+static SparseMatrix *Laplacian2D(int n, double shift = 0.0)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         const int k = i + j*n;
+         A->Add(k, k, 4.0 + shift);
+         if (i > 0) { A->Add(k, k-1, -1.0); }
+         if (i < n-1) { A->Add(k, k+1, -1.0); }
+         if (j > 0) { A->Add(k, k-n, -1.0); }
+         if (j < n-1) { A->Add(k, k+n, -1.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// 2D convection-diffusion: Laplacian2D() plus first order upwind convection
+// with velocity (c, c/2).
+static SparseMatrix *ConvectionDiffusion2D(int n, double c)
+{
+   SparseMatrix *A = Laplacian2D(n);
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         const int k = i + j*n;
+         A->Add(k, k, 1.5*c);
+         if (i > 0) { A->Add(k, k-1, -c); }
+         if (j > 0) { A->Add(k, k-n, -0.5*c); }
+      }
+   }
+   return A;
+}
+
+static double ResidualNorm(const Operator &A, const Vector &b, const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return r.Norml2();
+}
+
+}
+
+using namespace solvers_test;
+
+TEST_CASE("PipelinedCGSolver", "[PipelinedCGSolver]")
+{
+   const int n = 200;
+   SparseMatrix *A = Laplacian1D(n, 0.01);
+   Vector b(n), x(n), x_cg(n);
+   b.Randomize(1);
+   x = 0.0;
+   x_cg = 0.0;
+
+   SECTION("Unpreconditioned")
+   {
+      CGSolver cg;
+      cg.SetRelTol(1e-12);
+      cg.SetMaxIter(1000);
+      cg.SetOperator(*A);
+      cg.Mult(b, x_cg);
+
+      PipelinedCGSolver pcg;
+      pcg.SetRelTol(1e-12);
+      pcg.SetMaxIter(1000);
+      pcg.SetOperator(*A);
+      pcg.Mult(b, x);
+
+      REQUIRE(pcg.GetConverged());
+      REQUIRE(std::abs(pcg.GetNumIterations() - cg.GetNumIterations()) <= 2);
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+   }
+
+   SECTION("Preconditioned")
+   {
+      DSmoother jacobi(*A);
+      PipelinedCGSolver pcg;
+      pcg.SetRelTol(1e-12);
+      pcg.SetMaxIter(1000);
+      pcg.SetPreconditioner(jacobi);
+      pcg.SetOperator(*A);
+      pcg.Mult(b, x);
+
+      REQUIRE(pcg.GetConverged());
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+   }
+
+   delete A;
+}
+
+TEST_CASE("Multiple right-hand sides", "[CGSolver][GMRESSolver]")
+{
+   const int n = 150, nrhs = 11;
+   SparseMatrix *A = Laplacian1D(n, 0.05);
+   DenseMatrix B(n, nrhs), X(n, nrhs);
+   for (int k = 0; k < nrhs; k++)
+   {
+      Vector col;
+      B.GetColumnReference(k, col);
+      col.Randomize(k+1);
+   }
+
+   SECTION("SparseMatrix::ArrayMult")
+   {
+      Array<const Vector *> in(nrhs);
+      Array<Vector *> out(nrhs);
+      Vector *cols = new Vector[2*nrhs];
+      for (int k = 0; k < nrhs; k++)
+      {
+         B.GetColumnReference(k, cols[k]);
+         X.GetColumnReference(k, cols[nrhs+k]);
+         in[k] = &cols[k];
+         out[k] = &cols[nrhs+k];
+      }
+      A->ArrayMult(in, out);
+      Vector y(n);
+      for (int k = 0; k < nrhs; k++)
+      {
+         A->Mult(cols[k], y);
+         y -= cols[nrhs+k];
+         REQUIRE(y.Normlinf() < 1e-12);
+      }
+      delete [] cols;
+   }
+
+   SECTION("CGSolver")
+   {
+      DSmoother jacobi(*A);
+      CGSolver cg;
+      cg.SetRelTol(1e-12);
+      cg.SetMaxIter(500);
+      cg.SetPreconditioner(jacobi);
+      cg.SetOperator(*A);
+      cg.iterative_mode = false;
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      for (int k = 0; k < nrhs; k++)
+      {
+         Vector b, x;
+         B.GetColumnReference(k, b);
+         X.GetColumnReference(k, x);
+         REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+      }
+   }
+
+   SECTION("GMRESSolver")
+   {
+      GMRESSolver gmres;
+      gmres.SetRelTol(1e-12);
+      gmres.SetMaxIter(1000);
+      gmres.SetKDim(20);
+      gmres.SetOperator(*A);
+      X = 0.0;
+      gmres.Mult(B, X);
+      REQUIRE(gmres.GetConverged());
+      for (int k = 0; k < nrhs; k++)
+      {
+         Vector b, x;
+         B.GetColumnReference(k, b);
+         X.GetColumnReference(k, x);
+         REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+      }
+   }
+
+   delete A;
+}
+
+TEST_CASE("Krylov solvers", "[CGSolver][BiCGSTABSolver][MINRESSolver]")
+{
+   const int n = 120;
+   SparseMatrix *A = Laplacian1D(n, 0.02);
+   DSmoother jacobi(*A);
+   Vector b(n), x(n);
+   b.Randomize(3);
+
+   CGSolver cg;
+   BiCGSTABSolver bicgstab;
+   MINRESSolver minres;
+   IterativeSolver *solvers[3] = { &cg, &bicgstab, &minres };
+
+   for (int prec = 0; prec <= 1; prec++)
+   {
+      for (int i = 0; i < 3; i++)
+      {
+         IterativeSolver &solver = *solvers[i];
+         solver.SetRelTol(1e-12);
+         solver.SetMaxIter(1000);
+         if (prec) { solver.SetPreconditioner(jacobi); }
+         solver.SetOperator(*A);
+         x = 0.0;
+         solver.Mult(b, x);
+         REQUIRE(solver.GetConverged());
+         REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+      }
+   }
+
+   delete A;
+}
+
+TEST_CASE("SparseCholeskySolver", "[SparseCholeskySolver]")
+{
+   const int n = 24, N = n*n;
+   SparseMatrix *A = Laplacian2D(n, 0.01);
+   Vector b(N), x(N);
+   b.Randomize(5);
+
+   SECTION("Orderings")
+   {
+      SparseCholeskySolver::Ordering ord[3] =
+      {
+         SparseCholeskySolver::NATURAL,
+         SparseCholeskySolver::MINIMUM_DEGREE,
+         SparseCholeskySolver::NESTED_DISSECTION
+      };
+      long nnz[3];
+      for (int i = 0; i < 3; i++)
+      {
+         SparseCholeskySolver chol;
+         chol.SetOrdering(ord[i]);
+         chol.SetOperator(*A);
+         chol.Mult(b, x);
+         nnz[i] = chol.GetFactorNNZ();
+         REQUIRE(ResidualNorm(*A, b, x) < 1e-10 * b.Norml2());
+      }
+      // the natural ordering fills the envelope of the matrix
+      REQUIRE(nnz[0] == 1 + 2*(n-1) + (N-n)*(n+1));
+      REQUIRE(nnz[1] < nnz[0]/2);
+      REQUIRE(nnz[2] < nnz[0]/2);
+   }
+
+   SECTION("LDLT")
+   {
+      // negative definite and symmetric indefinite (shifted) matrices
+      SparseMatrix *mA = Laplacian2D(n, 0.01);
+      *mA *= -1.0;
+      SparseMatrix *sA = Laplacian2D(n, -0.1);
+      SparseCholeskySolver ldlt(SparseCholeskySolver::LDLT);
+      ldlt.SetOperator(*mA);
+      ldlt.Mult(b, x);
+      REQUIRE(ResidualNorm(*mA, b, x) < 1e-10 * b.Norml2());
+      ldlt.SetOperator(*sA);
+      ldlt.Mult(b, x);
+      REQUIRE(ResidualNorm(*sA, b, x) < 1e-10 * b.Norml2());
+      delete sA;
+      delete mA;
+   }
+
+   SECTION("Reuse and multiple right-hand sides")
+   {
+      const int nrhs = 5;
+      SparseCholeskySolver chol(*A);
+      const int nsn = chol.GetNumSupernodes();
+      REQUIRE(nsn < N);
+
+      *A *= 2.0;
+      chol.UpdateValues(*A);
+      REQUIRE(chol.GetNumSupernodes() == nsn);
+      chol.SetOperator(*A);
+      REQUIRE(chol.GetNumSupernodes() == nsn);
+
+      DenseMatrix B(N, nrhs), X(N, nrhs);
+      for (int k = 0; k < nrhs; k++)
+      {
+         Vector col;
+         B.GetColumnReference(k, col);
+         col.Randomize(k+1);
+      }
+      chol.Mult(B, X);
+      for (int k = 0; k < nrhs; k++)
+      {
+         Vector bk, xk;
+         B.GetColumnReference(k, bk);
+         X.GetColumnReference(k, xk);
+         REQUIRE(ResidualNorm(*A, bk, xk) < 1e-10 * bk.Norml2());
+      }
+   }
+
+   SECTION("Changing the precision")
+   {
+      // the precision changes in the next factorization, the current factor
+      // is used until then
+      SparseCholeskySolver chol(*A);
+      chol.SetSinglePrecision();
+      chol.Mult(b, x);
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-10 * b.Norml2());
+
+      chol.UpdateValues(*A);
+      chol.SetSinglePrecision(false);
+      chol.Mult(b, x);
+      const double res = ResidualNorm(*A, b, x);
+      REQUIRE(res > 1e-12 * b.Norml2());
+      REQUIRE(res < 1e-4 * b.Norml2());
+
+      chol.SetOperator(*A);
+      chol.Mult(b, x);
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-10 * b.Norml2());
+   }
+
+   delete A;
+}
+
+TEST_CASE("Krylov subspace recycling", "[DeflatedCGSolver][GCRODRSolver]")
+{
+   const int n = 20, N = n*n, nsteps = 4;
+   Vector b(N), x(N);
+
+   SECTION("DeflatedCGSolver")
+   {
+      for (int prec = 0; prec <= 1; prec++)
+      {
+         CGSolver cg;
+         DeflatedCGSolver dcg;
+         dcg.SetRecycleDim(8, 16);
+         IterativeSolver *solvers[2] = { &cg, &dcg };
+         int iters[2][nsteps];
+         for (int step = 0; step < nsteps; step++)
+         {
+            SparseMatrix *A = Laplacian2D(n, 0.01*(1.0 + 0.1*step));
+            DSmoother jacobi(*A);
+            b.Randomize(step+1);
+            for (int i = 0; i < 2; i++)
+            {
+               IterativeSolver &solver = *solvers[i];
+               solver.SetRelTol(1e-10);
+               solver.SetMaxIter(1000);
+               if (prec) { solver.SetPreconditioner(jacobi); }
+               solver.SetOperator(*A);
+               x = 0.0;
+               solver.Mult(b, x);
+               REQUIRE(solver.GetConverged());
+               REQUIRE(ResidualNorm(*A, b, x) < 1e-8 * b.Norml2());
+               iters[i][step] = solver.GetNumIterations();
+            }
+            delete A;
+         }
+         REQUIRE(dcg.GetRecycleDim() == 8);
+         for (int step = 1; step < nsteps; step++)
+         {
+            REQUIRE(iters[1][step] < 0.9*iters[0][step]);
+         }
+         dcg.ResetRecycleSpace();
+         REQUIRE(dcg.GetRecycleDim() == 0);
+      }
+   }
+
+   SECTION("GCRODRSolver")
+   {
+      for (int prec = 0; prec <= 1; prec++)
+      {
+         GMRESSolver gmres;
+         GCRODRSolver gcrodr;
+         gmres.SetKDim(30);
+         gcrodr.SetKDim(30);
+         gcrodr.SetRecycleDim(10);
+         IterativeSolver *solvers[2] = { &gmres, &gcrodr };
+         int iters[2][nsteps];
+         for (int step = 0; step < nsteps; step++)
+         {
+            SparseMatrix *A = ConvectionDiffusion2D(n, 1.0 + 0.05*step);
+            DSmoother jacobi(*A);
+            b.Randomize(step+1);
+            for (int i = 0; i < 2; i++)
+            {
+               IterativeSolver &solver = *solvers[i];
+               solver.SetRelTol(1e-10);
+               solver.SetMaxIter(2000);
+               if (prec) { solver.SetPreconditioner(jacobi); }
+               solver.SetOperator(*A);
+               x = 0.0;
+               solver.Mult(b, x);
+               REQUIRE(solver.GetConverged());
+               REQUIRE(ResidualNorm(*A, b, x) < 1e-7 * b.Norml2());
+               iters[i][step] = solver.GetNumIterations();
+            }
+            delete A;
+         }
+         REQUIRE(gcrodr.GetRecycleDim() == 10);
+         for (int step = 1; step < nsteps; step++)
+         {
+            REQUIRE(iters[1][step] < 0.8*iters[0][step]);
+         }
+         gcrodr.ResetRecycleSpace();
+         REQUIRE(gcrodr.GetRecycleDim() == 0);
+      }
+   }
+}
+
+TEST_CASE("MixedPrecisionSolver", "[MixedPrecisionSolver]")
+{
+   const int n = 24, N = n*n;
+   SparseMatrix *A = Laplacian2D(n, 0.01);
+   Vector b(N), x(N), y(N);
+   b.Randomize(3);
+
+   SECTION("FloatSparseMatrix")
+   {
+      FloatSparseMatrix fA(*A);
+      A->Mult(b, x);
+      fA.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-6 * x.Normlinf());
+   }
+
+   SECTION("Iterative refinement")
+   {
+      // the single precision factorization alone is accurate to ~1e-7
+      SparseCholeskySolver chol;
+      chol.SetSinglePrecision();
+      chol.SetOperator(*A);
+      chol.Mult(b, x);
+      const double res = ResidualNorm(*A, b, x);
+      REQUIRE(res > 1e-12 * b.Norml2());
+      REQUIRE(res < 1e-4 * b.Norml2());
+
+      MixedPrecisionSolver ir;
+      ir.SetPreconditioner(chol);
+      ir.SetOperator(*A);
+      ir.SetRelTol(1e-14);
+      ir.SetMaxIter(10);
+      ir.iterative_mode = false;
+      ir.Mult(b, x);
+      REQUIRE(ir.GetConverged());
+      REQUIRE(ir.GetNumIterations() <= 4);
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-13 * b.Norml2());
+   }
+
+   SECTION("FGMRES")
+   {
+      FloatGSSmoother fgs;
+      MixedPrecisionSolver mp(MixedPrecisionSolver::FGMRES);
+      mp.SetPreconditioner(fgs);
+      mp.SetOperator(*A);
+      mp.SetRelTol(1e-12);
+      mp.SetMaxIter(500);
+      mp.iterative_mode = false;
+      mp.Mult(b, x);
+      REQUIRE(mp.GetConverged());
+      REQUIRE(ResidualNorm(*A, b, x) < 1e-11 * b.Norml2());
+
+      // the outer solver is reused
+      const int iter = mp.GetNumIterations();
+      mp.Mult(b, x);
+      REQUIRE(mp.GetNumIterations() == iter);
+
+      // same iterations as with the double precision smoother
+      GSSmoother gs(*A);
+      FGMRESSolver fgmres;
+      fgmres.SetOperator(*A);
+      fgmres.SetPreconditioner(gs);
+      fgmres.SetRelTol(1e-12);
+      fgmres.SetMaxIter(500);
+      fgmres.iterative_mode = false;
+      fgmres.Mult(b, y);
+      REQUIRE(std::abs(mp.GetNumIterations() - fgmres.GetNumIterations()) <= 2);
+   }
+
+   delete A;
+}
+
+TEST_CASE("MulticolorGSSmoother", "[MulticolorGSSmoother]")
+{
+   const int n = 24, N = n*n;
+   SparseMatrix *A = Laplacian2D(n, 0.01);
+   Vector b(N), x(N), y(N);
+   b.Randomize(7);
+
+   SECTION("Coloring")
+   {
+      // red-black coloring of the 5-point stencil
+      MulticolorGSSmoother mgs(*A);
+      REQUIRE(mgs.GetNumColors() == 2);
+
+      SparseMatrix *C = ConvectionDiffusion2D(n, 0.5);
+      C->Finalize();
+      mgs.SetOperator(*C);
+      Array<int> colors;
+      mgs.GetColoring(colors);
+      int conflicts = 0;
+      for (int i = 0; i < N; i++)
+      {
+         for (int k = C->GetI()[i]; k < C->GetI()[i+1]; k++)
+         {
+            const int j = C->GetJ()[k];
+            if (j != i && colors[j] == colors[i]) { conflicts++; }
+         }
+      }
+      REQUIRE(conflicts == 0);
+      delete C;
+   }
+
+   SECTION("Symmetric SSOR")
+   {
+      MulticolorGSSmoother ssor(*A, 0, 1.5);
+      ssor.iterative_mode = false;
+      x.Randomize(1);
+      y.Randomize(2);
+      Vector Bx(N), By(N);
+      ssor.Mult(x, Bx);
+      ssor.Mult(y, By);
+      REQUIRE(std::abs((Bx*y) - (x*By)) < 1e-12 * std::abs(Bx*y));
+   }
+
+   SECTION("Convergence")
+   {
+      GSSmoother gs(*A);
+      MulticolorGSSmoother mgs(*A);
+      Solver *precs[2] = { &gs, &mgs };
+      int iters[2];
+      for (int i = 0; i < 2; i++)
+      {
+         CGSolver cg;
+         cg.SetRelTol(1e-12);
+         cg.SetMaxIter(500);
+         cg.SetPreconditioner(*precs[i]);
+         cg.SetOperator(*A);
+         x = 0.0;
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         REQUIRE(ResidualNorm(*A, b, x) < 1e-10 * b.Norml2());
+         iters[i] = cg.GetNumIterations();
+      }
+      REQUIRE(iters[1] <= 1.25*iters[0]);
+
+      // forward SOR as a stationary iteration
+      MulticolorGSSmoother sor(*A, 1, 1.7);
+      SLISolver sli;
+      sli.SetRelTol(1e-8);
+      sli.SetMaxIter(1000);
+      sli.SetPreconditioner(sor);
+      sli.SetOperator(*A);
+      x = 0.0;
+      sli.Mult(b, x);
+      REQUIRE(sli.GetConverged());
+   }
+
+   delete A;
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <cmath>
+
+using namespace mfem;
+
+TEST_CASE("Vector reductions", "[Vector]")
+{
+   const int n = 1001;
+   Vector x(n), y(n);
+   x.Randomize(1);
+   y.Randomize(2);
+   x -= 0.5;
+
+   double dot = 0.0, sum = 0.0, l1 = 0.0, l2 = 0.0, linf = 0.0;
+   double xmin = x(0), xmax = x(0);
+   for (int i = 0; i < n; i++)
+   {
+      dot += x(i)*y(i);
+      sum += x(i);
+      l1 += std::abs(x(i));
+      l2 += x(i)*x(i);
+      linf = std::max(linf, std::abs(x(i)));
+      xmin = std::min(xmin, x(i));
+      xmax = std::max(xmax, x(i));
+   }
+   l2 = std::sqrt(l2);
+
+   REQUIRE(std::abs(x*y - dot) < 1e-12);
+   REQUIRE(std::abs(x.Sum() - sum) < 1e-12);
+   REQUIRE(std::abs(x.Norml1() - l1) < 1e-12);
+   REQUIRE(std::abs(x.Norml2() - l2) < 1e-12);
+   REQUIRE(x.Normlinf() == linf);
+   REQUIRE(x.Min() == xmin);
+   REQUIRE(x.Max() == xmax);
+
+   SECTION("Empty vector")
+   {
+      Vector e;
+      REQUIRE(e.Norml2() == 0.0);
+      REQUIRE(e.Normlinf() == 0.0);
+      REQUIRE(e.Sum() == 0.0);
+   }
+
+   SECTION("Norml2 without overflow")
+   {
+      Vector big(n);
+      big = 1e200;
+      REQUIRE(std::abs(big.Norml2() / (1e200*std::sqrt(double(n))) - 1.0)
+              < 1e-12);
+   }
+
+   SECTION("Fused kernels")
+   {
+      Vector z(n), r(x), w(y);
+      const double zw = AddAndDot(x, 0.5, y, z, w);
+      Vector z0(x);
+      z0.Add(0.5, y);
+      REQUIRE(std::abs(zw - z0*w) < 1e-12);
+      z0 -= z;
+      REQUIRE(z0.Normlinf() == 0.0);
+
+      double dots[2];
+      Dot2(x, y, z, dots);
+      REQUIRE(std::abs(dots[0] - x*y) < 1e-12);
+      REQUIRE(std::abs(dots[1] - x*z) < 1e-12);
+   }
+}
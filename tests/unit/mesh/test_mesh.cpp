@@ -10,6 +10,11 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "mfem.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <vector>
 using namespace mfem;
 
 #include "catch.hpp"
@@ -95,3 +100,630 @@ TEST_CASE("Gecko integration in MFEM", "[Mesh]")
 }
 
 #endif
+
+namespace mesh_test
+{
+
+// Check that each point was found and that the transformation of the found
+// element maps the returned reference point to the point.
+static void CheckPoints(Mesh &mesh, DenseMatrix &point_mat)
+{
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   const int npts = point_mat.Width();
+   REQUIRE(mesh.FindPoints(point_mat, elem_ids, ips, false) == npts);
+   Vector x, y;
+   for (int k = 0; k < npts; k++)
+   {
+      REQUIRE(elem_ids[k] >= 0);
+      point_mat.GetColumnReference(k, x);
+      mesh.GetElementTransformation(elem_ids[k])->Transform(ips[k], y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-10);
+   }
+}
+
+// Images of random reference points in random elements, including points on
+// element edges.
+static void MakePoints(Mesh &mesh, int npts, DenseMatrix &point_mat)
+{
+   const int dim = mesh.Dimension();
+   Vector r(dim*npts+npts), x;
+   r.Randomize(17);
+   point_mat.SetSize(mesh.SpaceDimension(), npts);
+   for (int k = 0; k < npts; k++)
+   {
+      const int e = std::min(int(r(k)*mesh.GetNE()), mesh.GetNE()-1);
+      IntegrationPoint ip;
+      double xi[3] = { 0.0, 0.0, 0.0 };
+      for (int d = 0; d < dim; d++) { xi[d] = r(npts + dim*k + d); }
+      if (mesh.GetElementBaseGeometry(e) == Geometry::TRIANGLE)
+      {
+         if (xi[0] + xi[1] > 1.0) { xi[0] = 1.0 - xi[0]; xi[1] = 1.0 - xi[1]; }
+         if (k % 4 == 0) { xi[0] = 1.0 - xi[1]; }
+      }
+      else if (k % 4 == 0) { xi[0] = 1.0; }
+      ip.Set(xi, dim);
+      point_mat.GetColumnReference(k, x);
+      mesh.GetElementTransformation(e)->Transform(ip, x);
+   }
+}
+
+static void Bend(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(M_PI*x(1));
+   y(1) += 0.1*sin(M_PI*x(0));
+}
+
+// Number of interior faces between elements in different parts.
+static int CountCutFaces(Mesh &mesh, const int *partitioning)
+{
+   int cut = 0;
+   for (int f = 0; f < mesh.GetNumFaces(); f++)
+   {
+      int e1, e2;
+      mesh.GetFaceElements(f, &e1, &e2);
+      if (e2 >= 0 && partitioning[e1] != partitioning[e2]) { cut++; }
+   }
+   return cut;
+}
+
+}
+
+using namespace mesh_test;
+
+TEST_CASE("FindPoints", "[Mesh][ElementBVH]")
+{
+   DenseMatrix point_mat;
+
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(12, 12, Element::QUADRILATERAL, true);
+      const ElementBVH &bvh = mesh.GetElementBVH();
+      REQUIRE(bvh.GetNE() == mesh.GetNE());
+      REQUIRE(bvh.GetNumTreeNodes() < mesh.GetNE());
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+
+      // the hierarchy is refitted after the nodes are moved
+      Vector disp(2*mesh.GetNV());
+      disp = 0.25;
+      mesh.MoveNodes(disp);
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+
+      // also when the vertices are modified directly
+      for (int i = 0; i < mesh.GetNV(); i++) { mesh.GetVertex(i)[1] += 0.5; }
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+
+      // and rebuilt after refinement
+      mesh.UniformRefinement();
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+      REQUIRE(mesh.GetElementBVH().GetNE() == mesh.GetNE());
+   }
+
+   SECTION("Curved triangles")
+   {
+      Mesh mesh(8, 8, Element::TRIANGLE, true);
+      mesh.SetCurvature(3);
+      mesh.Transform(Bend);
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+
+      // the nodes are modified directly, without NodesUpdated()
+      Vector &nodes = *mesh.GetNodes();
+      nodes -= 0.5;
+      MakePoints(mesh, 200, point_mat);
+      CheckPoints(mesh, point_mat);
+   }
+
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(4, 4, 4, Element::HEXAHEDRON, true);
+      MakePoints(mesh, 100, point_mat);
+      CheckPoints(mesh, point_mat);
+
+      // points outside of the mesh are not found
+      point_mat.SetSize(3, 1);
+      point_mat = 2.0;
+      Array<int> elem_ids;
+      Array<IntegrationPoint> ips;
+      REQUIRE(mesh.FindPoints(point_mat, elem_ids, ips, false) == 0);
+      REQUIRE(elem_ids[0] == -1);
+   }
+}
+
+TEST_CASE("SFC element ordering", "[Mesh]")
+{
+   Array<int> perm;
+
+   SECTION("Permutation is valid and preserves the vertex locations")
+   {
+      for (int type = Mesh::HILBERT; type <= Mesh::MORTON; type++)
+      {
+         Mesh mesh(5, 4, 3, Element::TETRAHEDRON);
+         Mesh mesh_reordered(5, 4, 3, Element::TETRAHEDRON);
+         mesh_reordered.GetSFCElementOrdering(perm, type);
+         REQUIRE(perm.Size() == mesh.GetNE());
+
+         Array<bool> elem_covered(perm.Size());
+         elem_covered = false;
+         for (int i = 0; i < perm.Size(); i++)
+         {
+            REQUIRE((perm[i] >= 0 && perm[i] < perm.Size()));
+            REQUIRE(!elem_covered[perm[i]]);
+            elem_covered[perm[i]] = true;
+         }
+
+         mesh_reordered.ReorderElements(perm);
+         for (int old_elid = 0; old_elid < perm.Size(); old_elid++)
+         {
+            Array<int> old_dofs, new_dofs;
+            mesh.GetElementVertices(old_elid, old_dofs);
+            mesh_reordered.GetElementVertices(perm[old_elid], new_dofs);
+            for (int dofi = 0; dofi < old_dofs.Size(); dofi++)
+            {
+               for (int d = 0; d < 3; d++)
+               {
+                  REQUIRE(mesh.GetVertex(old_dofs[dofi])[d] ==
+                          mesh_reordered.GetVertex(new_dofs[dofi])[d]);
+               }
+            }
+         }
+      }
+   }
+
+   SECTION("Consecutive elements are close")
+   {
+      const int n = 16;
+      Mesh mesh(n, n, Element::QUADRILATERAL, true);
+
+      // shuffle the elements, then sort them along the Hilbert curve
+      perm.SetSize(mesh.GetNE());
+      for (int i = 0; i < perm.Size(); i++) { perm[i] = (37*i) % perm.Size(); }
+      mesh.ReorderElements(perm);
+      mesh.GetSFCElementOrdering(perm);
+      mesh.ReorderElements(perm);
+
+      Vector c0(2), c1(2);
+      Array<int> v;
+      double dist = 0.0;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         c0 = c1;
+         c1 = 0.0;
+         mesh.GetElementVertices(i, v);
+         for (int j = 0; j < v.Size(); j++)
+         {
+            c1(0) += mesh.GetVertex(v[j])[0]/v.Size();
+            c1(1) += mesh.GetVertex(v[j])[1]/v.Size();
+         }
+         if (i > 0) { dist += c0.DistanceTo(c1.GetData()); }
+      }
+      REQUIRE(dist/(mesh.GetNE()-1) < 1.5/n);
+   }
+
+   SECTION("Automatic ordering after loading and refinement")
+   {
+      Mesh::sfc_element_ordering = true;
+      std::stringstream mesh_str;
+      {
+         Mesh mesh(6, 5, Element::TRIANGLE, false);
+         mesh.Print(mesh_str);
+      }
+      Mesh mesh(mesh_str);
+      mesh.GetSFCElementOrdering(perm);
+      for (int i = 0; i < perm.Size(); i++) { REQUIRE(perm[i] == i); }
+
+      mesh.UniformRefinement();
+      mesh.GetSFCElementOrdering(perm);
+      for (int i = 0; i < perm.Size(); i++) { REQUIRE(perm[i] == i); }
+      Mesh::sfc_element_ordering = false;
+   }
+}
+
+TEST_CASE("Geometric partitioning", "[Mesh]")
+{
+   // an L-shaped domain, where Cartesian partitioning is unbalanced
+   const double vert[8][2] = { {0,0}, {1,0}, {2,0}, {0,1}, {1,1}, {2,1},
+      {0,2}, {1,2}
+   };
+   const int quad[3][4] = { {0,1,4,3}, {1,2,5,4}, {3,4,7,6} };
+   Mesh *lmesh = new Mesh(2, 8, 3);
+   for (int i = 0; i < 8; i++) { lmesh->AddVertex(vert[i]); }
+   for (int i = 0; i < 3; i++) { lmesh->AddQuad(quad[i]); }
+   lmesh->FinalizeQuadMesh(1, 1, true);
+   for (int l = 0; l < 4; l++) { lmesh->UniformRefinement(); }
+   const int ne = lmesh->GetNE();
+
+   Array<double> weights(ne);
+   for (int i = 0; i < ne; i++) { weights[i] = 1.0 + (i % 3); }
+
+   const int nparts = 7;
+   for (int method = 0; method <= 1; method++)
+   {
+      for (int weighted = 0; weighted <= 1; weighted++)
+      {
+         const Array<double> *w = weighted ? &weights : NULL;
+         int *part0 = lmesh->GenerateGeometricPartitioning(nparts, method, w, 0);
+         int *part = lmesh->GenerateGeometricPartitioning(nparts, method, w);
+
+         Array<double> part_weight(nparts);
+         part_weight = 0.0;
+         double total = 0.0, max_w = 0.0;
+         for (int i = 0; i < ne; i++)
+         {
+            REQUIRE((part[i] >= 0 && part[i] < nparts));
+            const double wi = weighted ? weights[i] : 1.0;
+            part_weight[part[i]] += wi;
+            total += wi;
+            max_w = std::max(max_w, wi);
+         }
+         REQUIRE(part_weight.Min() > 0.0);
+         REQUIRE(part_weight.Max() <= 1.03*total/nparts + max_w);
+
+         // the refinement does not increase the number of cut faces
+         REQUIRE(CountCutFaces(*lmesh, part) <= CountCutFaces(*lmesh, part0));
+
+         delete [] part;
+         delete [] part0;
+      }
+   }
+
+   // without METIS, GeneratePartitioning() uses the geometric partitioner
+   int *part = lmesh->GeneratePartitioning(nparts, 6);
+   Array<bool> used(nparts);
+   used = false;
+   for (int i = 0; i < ne; i++) { used[part[i]] = true; }
+   for (int p = 0; p < nparts; p++) { REQUIRE(used[p]); }
+   delete [] part;
+   delete lmesh;
+}
+
+TEST_CASE("Compact elements", "[Mesh]")
+{
+   for (int type = 0; type < 3; type++)
+   {
+      const Element::Type el_type[3] = { Element::HEXAHEDRON,
+                                         Element::TETRAHEDRON,
+                                         Element::WEDGE
+                                       };
+      Mesh mesh(3, 2, 2, el_type[type]);
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         mesh.GetElement(i)->SetAttribute(1 + i % 2);
+      }
+
+      CompactElements elems, bdr_elems;
+      mesh.GetCompactElements(elems);
+      mesh.GetCompactBdrElements(bdr_elems);
+      REQUIRE(elems.Size() == mesh.GetNE());
+      REQUIRE(bdr_elems.Size() == mesh.GetNBE());
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         const Element *el = mesh.GetElement(i);
+         REQUIRE(elems.GetGeometry(i) == el->GetGeometryType());
+         REQUIRE(elems.GetAttribute(i) == el->GetAttribute());
+         REQUIRE(elems.GetNVertices(i) == el->GetNVertices());
+         for (int j = 0; j < el->GetNVertices(); j++)
+         {
+            REQUIRE(elems.GetVertices(i)[j] == el->GetVertices()[j]);
+         }
+      }
+
+      // a mesh created from the compact elements has the same topology
+      Mesh copy(3, mesh.GetNV(), 0, 0, 3);
+      for (int i = 0; i < mesh.GetNV(); i++) { copy.AddVertex(mesh.GetVertex(i)); }
+      copy.AddElements(elems);
+      copy.AddBdrElements(bdr_elems);
+      copy.FinalizeTopology();
+      REQUIRE(copy.GetNE() == mesh.GetNE());
+      REQUIRE(copy.GetNBE() == mesh.GetNBE());
+      REQUIRE(copy.GetNEdges() == mesh.GetNEdges());
+      REQUIRE(copy.GetNFaces() == mesh.GetNFaces());
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         REQUIRE(copy.GetAttribute(i) == mesh.GetAttribute(i));
+      }
+   }
+}
+
+TEST_CASE("Sorted topology construction", "[Mesh]")
+{
+   Array<Element::Type> types;
+   types.Append(Element::TRIANGLE);
+   types.Append(Element::QUADRILATERAL);
+   types.Append(Element::TETRAHEDRON);
+   types.Append(Element::HEXAHEDRON);
+   types.Append(Element::WEDGE);
+   for (int t = 0; t < types.Size(); t++)
+   {
+      const bool is_3d = (t >= 2);
+      Mesh *mesh_ptr = is_3d ? new Mesh(3, 2, 2, types[t], true) :
+                       new Mesh(4, 3, types[t], true);
+      Mesh &mesh = *mesh_ptr;
+      // shuffle the elements so the numbering is not that of the generator
+      Array<int> perm(mesh.GetNE());
+      for (int i = 0; i < perm.Size(); i++) { perm[i] = (7*i + 3) % perm.Size(); }
+      mesh.ReorderElements(perm);
+
+      // the edges and the faces are numbered in the order of their first
+      // occurrence in the elements, as with DSTable and STable3D
+      std::map<std::vector<int>, int> edge_num, face_num;
+      Array<int> edges, faces, cor, v;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         const Element *el = mesh.GetElement(i);
+         mesh.GetElementEdges(i, edges, cor);
+         REQUIRE(edges.Size() == el->GetNEdges());
+         for (int j = 0; j < el->GetNEdges(); j++)
+         {
+            const int *ev = el->GetEdgeVertices(j);
+            std::vector<int> key;
+            key.push_back(el->GetVertices()[ev[0]]);
+            key.push_back(el->GetVertices()[ev[1]]);
+            std::sort(key.begin(), key.end());
+            const int num = int(edge_num.size());
+            edge_num.insert(std::make_pair(key, num));
+            REQUIRE(edges[j] == edge_num[key]);
+         }
+         if (!is_3d) { continue; }
+         mesh.GetElementFaces(i, faces, cor);
+         for (int j = 0; j < faces.Size(); j++)
+         {
+            mesh.GetFaceVertices(faces[j], v);
+            std::vector<int> key(v.GetData(), v.GetData() + v.Size());
+            std::sort(key.begin(), key.end());
+            key.resize(3);
+            const int num = int(face_num.size());
+            face_num.insert(std::make_pair(key, num));
+            REQUIRE(faces[j] == face_num[key]);
+         }
+      }
+      REQUIRE(mesh.GetNEdges() == int(edge_num.size()));
+
+      for (int i = 0; i < mesh.GetNBE(); i++)
+      {
+         mesh.GetBdrElementVertices(i, v);
+         std::vector<int> key(v.GetData(), v.GetData() + v.Size());
+         std::sort(key.begin(), key.end());
+         if (!is_3d)
+         {
+            REQUIRE(mesh.GetBdrElementEdgeIndex(i) == edge_num[key]);
+            continue;
+         }
+         int f, o;
+         mesh.GetBdrElementFace(i, &f, &o);
+         key.resize(3);
+         REQUIRE(f == face_num[key]);
+         mesh.GetBdrElementEdges(i, edges, cor);
+         const Element *bel = mesh.GetBdrElement(i);
+         for (int j = 0; j < bel->GetNEdges(); j++)
+         {
+            const int *ev = bel->GetEdgeVertices(j);
+            std::vector<int> ekey;
+            ekey.push_back(bel->GetVertices()[ev[0]]);
+            ekey.push_back(bel->GetVertices()[ev[1]]);
+            std::sort(ekey.begin(), ekey.end());
+            REQUIRE(edges[j] == edge_num[ekey]);
+         }
+      }
+      delete mesh_ptr;
+   }
+
+   // the radix sort is stable and agrees with std::stable_sort
+   std::vector<Pair<unsigned long long, int> > pairs, sorted;
+   for (int i = 0; i < 20000; i++)
+   {
+      const unsigned long long key = (i*2654435761ULL) % 1000003ULL;
+      pairs.push_back(Pair<unsigned long long, int>(key, i));
+   }
+   sorted = pairs;
+   std::stable_sort(sorted.begin(), sorted.end());
+   RadixSortPairs(pairs.data(), int(pairs.size()), 20);
+   for (unsigned i = 0; i < pairs.size(); i++)
+   {
+      REQUIRE(pairs[i].one == sorted[i].one);
+      REQUIRE(pairs[i].two == sorted[i].two);
+   }
+}
+
+TEST_CASE("NCMesh compaction", "[Mesh][NCMesh]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      // two copies of a mesh go through the same adaptive cycles, one of them
+      // is compacted after each cycle
+      Mesh *mesh_ptr = (dim == 3) ? new Mesh(3, 3, 3, Element::HEXAHEDRON)
+                       : new Mesh(6, 6, Element::QUADRILATERAL);
+      mesh_ptr->EnsureNCMesh();
+      Mesh &mesh = *mesh_ptr;
+      Mesh compact(mesh);
+
+      srand(2);
+      for (int cycle = 0; cycle < 6; cycle++)
+      {
+         Array<Refinement> refs;
+         for (int i = 0; i < mesh.GetNE(); i++)
+         {
+            if (rand() % 4) { continue; }
+            // (3D anisotropic meshes can not be derefined)
+            refs.Append(Refinement(i, (dim == 3) ? 7 : 1 + rand() % 3));
+         }
+         mesh.GeneralRefinement(refs);
+         compact.GeneralRefinement(refs);
+
+         Vector error(mesh.GetNE());
+         for (int i = 0; i < error.Size(); i++) { error(i) = (rand() % 4 == 0); }
+         mesh.DerefineByError(error, 2.0);
+         compact.DerefineByError(error, 2.0);
+
+         // compaction does not change the mesh or the refinement hierarchy
+         std::stringstream before, after;
+         compact.Print(before);
+         const long memory = compact.ncmesh->MemoryUsage();
+         compact.ncmesh->Compact();
+         REQUIRE(compact.ncmesh->MemoryUsage() <= memory);
+         compact.Print(after);
+         REQUIRE(before.str() == after.str());
+
+         // the refinements reuse ids differently, the meshes are the same up
+         // to the numbering
+         REQUIRE(compact.GetNE() == mesh.GetNE());
+         REQUIRE(compact.GetNV() == mesh.GetNV());
+      }
+
+      // after the cycles, the compacted mesh uses less memory
+      REQUIRE(compact.ncmesh->MemoryUsage() < mesh.ncmesh->MemoryUsage());
+      delete mesh_ptr;
+   }
+}
+
+TEST_CASE("NCMesh batched refinement", "[Mesh][NCMesh]")
+{
+   // Large batches of isotropic refinements are done by color (in parallel
+   // with MFEM_USE_LEGACY_OPENMP), small batches one element at a time. Both
+   // give the same mesh, up to the numbering of the vertices, edges and faces.
+   for (int type = 0; type < 3; type++)
+   {
+      Mesh *mesh_ptr =
+         (type == 0) ? new Mesh(12, 12, 16, Element::HEXAHEDRON) :
+         (type == 1) ? new Mesh(48, 48, Element::QUADRILATERAL) :
+         new Mesh(34, 34, Element::TRIANGLE);
+      mesh_ptr->EnsureNCMesh(true);
+      Mesh &batched = *mesh_ptr;
+      Mesh single(batched);
+      const int dim = batched.Dimension();
+
+      // one cycle is enough in 3D to get a batch of more than 1024 elements
+      const int cycles = (dim == 3) ? 1 : 2;
+      srand(3);
+      for (int cycle = 0; cycle < cycles; cycle++)
+      {
+         Array<Refinement> refs;
+         for (int i = 0; i < batched.GetNE(); i++)
+         {
+            if (rand() % 2) { refs.Append(Refinement(i)); }
+         }
+         batched.GeneralRefinement(refs);
+
+         // the same refinements in small batches, starting from the last
+         // element so that the indices of the remaining ones do not change
+         for (int end = refs.Size(); end > 0; end -= 1000)
+         {
+            Array<Refinement> part;
+            for (int i = std::max(end - 1000, 0); i < end; i++)
+            {
+               part.Append(refs[i]);
+            }
+            single.GeneralRefinement(part);
+         }
+
+         REQUIRE(single.GetNE() == batched.GetNE());
+         REQUIRE(single.GetNV() == batched.GetNV());
+         REQUIRE(single.GetNEdges() == batched.GetNEdges());
+         REQUIRE(single.GetNFaces() == batched.GetNFaces());
+         REQUIRE(single.GetNBE() == batched.GetNBE());
+
+         // the same elements in the same order, with the same vertices
+         double diff = 0.0;
+         Array<int> sv, bv;
+         for (int i = 0; i < batched.GetNE(); i++)
+         {
+            single.GetElementVertices(i, sv);
+            batched.GetElementVertices(i, bv);
+            for (int j = 0; j < bv.Size(); j++)
+            {
+               const double *sx = single.GetVertex(sv[j]);
+               const double *bx = batched.GetVertex(bv[j]);
+               for (int d = 0; d < dim; d++)
+               {
+                  diff = std::max(diff, std::abs(sx[d] - bx[d]));
+               }
+            }
+         }
+         REQUIRE(diff == 0.0);
+
+         // the same boundary and the same hanging vertices and edges
+         int sattr = 0, battr = 0;
+         for (int i = 0; i < batched.GetNBE(); i++)
+         {
+            sattr += single.GetBdrAttribute(i);
+            battr += batched.GetBdrAttribute(i);
+         }
+         REQUIRE(sattr == battr);
+
+         H1_FECollection fec(1, dim);
+         FiniteElementSpace sfes(&single, &fec), bfes(&batched, &fec);
+         REQUIRE(sfes.GetTrueVSize() == bfes.GetTrueVSize());
+      }
+      delete mesh_ptr;
+   }
+}
+
+TEST_CASE("Binary mesh format", "[Mesh]")
+{
+   for (int k = 0; k < 3; k++)
+   {
+      Mesh *mesh_ptr =
+         (k == 0) ? new Mesh(3, 2, 2, Element::HEXAHEDRON) :
+         (k == 1) ? new Mesh(2, 3, 2, Element::TETRAHEDRON) :
+         new Mesh(4, 3, Element::QUADRILATERAL);
+      Mesh &mesh = *mesh_ptr;
+      if (k == 2)
+      {
+         // a curved mesh, the nodes are saved as a GridFunction
+         mesh.SetCurvature(3);
+         GridFunction &nodes = *mesh.GetNodes();
+         for (int i = 0; i < nodes.Size(); i++)
+         {
+            nodes(i) += 0.01*sin(7.0*i);
+         }
+      }
+      std::stringstream text;
+      mesh.Print(text);
+
+      // read from a stream
+      std::stringstream binary;
+      mesh.PrintBinary(binary);
+      Mesh from_stream(binary);
+      std::stringstream stream_text;
+      from_stream.Print(stream_text);
+      REQUIRE(stream_text.str() == text.str());
+
+      // read from a file, which is mapped to memory
+      const char *filename = "binary_mesh_test.mesh";
+      {
+         std::ofstream file(filename, std::ios::binary);
+         mesh.PrintBinary(file);
+      }
+      Mesh from_file(filename);
+      std::remove(filename);
+      std::stringstream file_text;
+      from_file.Print(file_text);
+      REQUIRE(file_text.str() == text.str());
+
+      if (k == 2)
+      {
+         // the nodes use the mapped file as their storage, which is writable
+         // and outlives the file
+         GridFunction &file_nodes = *from_file.GetNodes();
+         REQUIRE(!file_nodes.OwnsData());
+         file_nodes *= 2.0;
+         REQUIRE(file_nodes(1) == 2.0*(*mesh.GetNodes())(1));
+
+         // nodes given away by the mesh do not use the mapping
+         GridFunction *nodes = NULL;
+         int own_nodes = 0;
+         from_file.SwapNodes(nodes, own_nodes);
+         REQUIRE(nodes->OwnsData());
+         REQUIRE((*nodes)(1) == 2.0*(*mesh.GetNodes())(1));
+         from_file.SwapNodes(nodes, own_nodes);
+      }
+
+      delete mesh_ptr;
+   }
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+#ifdef MFEM_USE_MPI
+
+namespace pncmesh
+{
+
+// The weight of the element with the given index along the space-filling
+// curve: the first 4 of the 16 elements are 7 times as expensive.
+double Weight(int sfc_index) { return (sfc_index < 4) ? 7.0 : 1.0; }
+
+TEST_CASE("ParNCMesh weighted rebalance", "[ParNCMesh][Parallel]")
+{
+   int nranks, myrank;
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+
+   // the elements of the Cartesian mesh follow the space-filling curve; the
+   // attribute of each element is its index along the curve plus one
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   for (int i = 0; i < mesh.GetNE(); i++) { mesh.SetAttribute(i, i+1); }
+   mesh.SetAttributes();
+   mesh.EnsureNCMesh();
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+
+   Vector weights(pmesh.GetNE());
+   for (int i = 0; i < pmesh.GetNE(); i++)
+   {
+      weights(i) = Weight(pmesh.GetAttribute(i) - 1);
+   }
+   pmesh.Rebalance(weights);
+
+   // the elements of each rank are a contiguous part of the curve, in the
+   // order of the ranks
+   int my_range[2] = { 0, -1 };
+   if (pmesh.GetNE() > 0)
+   {
+      Array<int> attr(pmesh.GetNE());
+      for (int i = 0; i < attr.Size(); i++) { attr[i] = pmesh.GetAttribute(i); }
+      attr.Sort();
+      for (int i = 1; i < attr.Size(); i++) { REQUIRE(attr[i] == attr[i-1]+1); }
+      my_range[0] = attr[0];
+      my_range[1] = attr.Last();
+   }
+   Array<int> ranges(2*nranks);
+   MPI_Allgather(my_range, 2, MPI_INT, ranges.GetData(), 2, MPI_INT,
+                 MPI_COMM_WORLD);
+   int next = 1;
+   for (int r = 0; r < nranks; r++)
+   {
+      if (ranges[2*r+1] < ranges[2*r]) { continue; }
+      REQUIRE(ranges[2*r] == next);
+      next = ranges[2*r+1] + 1;
+   }
+   REQUIRE(next == 17);
+
+   // hand-computed partitions of the total weight 40 and the imbalances
+   // (maximum/mean weight per rank) before and after
+   double before, after;
+   pmesh.pncmesh->GetRebalanceImbalance(before, after);
+   if (nranks == 1)
+   {
+      REQUIRE((my_range[0] == 1 && my_range[1] == 16));
+      REQUIRE(before == Approx(1.0));
+      REQUIRE(after == Approx(1.0));
+   }
+   else if (nranks == 2)
+   {
+      // before: 7*4 + 4 | 8; after: 7*3 | 7 + 12
+      const int first[2] = { 1, 4 }, last[2] = { 3, 16 };
+      REQUIRE((my_range[0] == first[myrank] && my_range[1] == last[myrank]));
+      REQUIRE(before == Approx(32.0/20.0));
+      REQUIRE(after == Approx(21.0/20.0));
+   }
+   else if (nranks == 4)
+   {
+      // before: 7*4 | 4 | 4 | 4; after: 7 | 7*2 | 7 + 2 | 10
+      const int first[4] = { 1, 2, 4, 7 }, last[4] = { 1, 3, 6, 16 };
+      REQUIRE((my_range[0] == first[myrank] && my_range[1] == last[myrank]));
+      REQUIRE(before == Approx(28.0/10.0));
+      REQUIRE(after == Approx(14.0/10.0));
+   }
+
+   // rebalancing the balanced mesh with the same weights changes nothing
+   weights.SetSize(pmesh.GetNE());
+   for (int i = 0; i < pmesh.GetNE(); i++)
+   {
+      weights(i) = Weight(pmesh.GetAttribute(i) - 1);
+   }
+   const double balanced = after;
+   pmesh.Rebalance(weights);
+   pmesh.pncmesh->GetRebalanceImbalance(before, after);
+   REQUIRE(before == Approx(balanced));
+   REQUIRE(after == Approx(balanced));
+}
+
+} // namespace pncmesh
+
+#endif // MFEM_USE_MPI